@@ -0,0 +1,75 @@
+"""
+Semantic analyzer benchmark
+Times SemanticAnalyzer.analyze on a synthetic corpus whose functions return
+deep arithmetic expressions from nested branches, where return checking
+matters most, and on the example and parity programs. Parsing is done once
+outside the timed region.
+"""
+
+from pathlib import Path
+
+from bench_common import best_of
+
+from lexer import Lexer
+from parser import Parser
+from semantic_analyzer import SemanticAnalyzer
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+CORPORA = ["examples", "parity_tests"]
+FUNCTIONS = 60
+RETURNS_PER_FUNCTION = 8
+DEPTH = 6
+ROUNDS = 20
+
+
+def return_expression(seed: int) -> str:
+    """A nested arithmetic expression over the parameters a, b and c"""
+    expression = "a"
+    for level in range(DEPTH):
+        operand = "bc"[(seed + level) % 2]
+        operator = "+-*"[(seed * 7 + level) % 3]
+        expression = f"({expression} {operator} {operand} * {level + 1})"
+    return expression
+
+
+def synthetic_program() -> str:
+    functions = []
+    for number in range(FUNCTIONS):
+        branches = "\n".join(f"    if (a == {branch}) {{\n        if (b > c) {{\n"
+                             f"            return {return_expression(number + branch)};\n        }}\n    }}"
+                             for branch in range(RETURNS_PER_FUNCTION - 1))
+        functions.append(f"long step{number}(long a, long b, int c) {{\n{branches}\n"
+                         f"    return {return_expression(number)};\n}}\n")
+    calls = "\n".join(f"    total = total + step{number}(total % 8, {number}, 3);" for number in range(FUNCTIONS))
+    return ("#include <iostream>\nusing namespace std;\n\n" + "\n".join(functions)
+            + f"\nint main() {{\n    long total = 0;\n{calls}\n    cout << total << endl;\n    return 0;\n}}\n")
+
+
+def analysis_time(source_code: str) -> float:
+    """Best time of ROUNDS analyses of one program, in seconds"""
+    ast = Parser(Lexer(source_code).tokenize()).parse()
+    analyzer = SemanticAnalyzer()
+    if not analyzer.analyze(ast):
+        raise RuntimeError("Semantic errors:\n" + "\n".join(analyzer.errors))
+
+    def analyze():
+        SemanticAnalyzer().analyze(ast)
+    return best_of(analyze, ROUNDS)
+
+
+def main():
+    synthetic = synthetic_program()
+    print(f"{'program':<34}{'lines':>7}{'analyze ms':>12}")
+    print(f"{'synthetic':<34}{synthetic.count(chr(10)):>7}{analysis_time(synthetic) * 1000:>12.3f}")
+    total = 0.0
+    for corpus in CORPORA:
+        for source_file in sorted((BASE_DIR / corpus).glob("*.cpp")):
+            source_code = source_file.read_text()
+            seconds = analysis_time(source_code)
+            total += seconds
+            print(f"{corpus + '/' + source_file.name:<34}{source_code.count(chr(10)):>7}{seconds * 1000:>12.3f}")
+    print(f"{'example and parity total':<34}{'':>7}{total * 1000:>12.3f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,50 @@
+"""
+<cmath> intrinsics benchmark
+Numeric loops built on math library calls, which lower to math module calls
+and operators. "pow squared" is strength-reduced to a multiplication; "pow
+general" goes through the cpp_pow runtime helper for comparison. Each runs
+STEPS iterations; reports the best run time of the generated program.
+"""
+
+from bench_common import compile_to_python, run_generated, best_of
+
+STEPS = 200000
+ROUNDS = 5
+
+KERNEL = """
+int main() {
+    double total = 0;
+    for (int i = 1; i <= %STEPS%; i++) {
+        double x = i * 0.001;
+        total = total + %EXPRESSION%;
+    }
+    cout << total << endl;
+    return 0;
+}
+"""
+
+LOOPS = {
+    "sqrt": "sqrt(x)",
+    "distance": "sqrt(pow(x - 1.5, 2) + pow(x * 0.5, 2))",
+    "pow squared": "pow(x, 2)",
+    "pow general": "pow(x, 2.5)",
+    "sin + cos": "sin(x) + cos(x)",
+    "exp + log": "exp(-x) + log(x)",
+    "floor + round": "floor(x) + round(x)",
+    "fabs + fmax": "fabs(x - 100) + fmax(x, 50)",
+}
+
+
+def main():
+    print(f"{STEPS} iterations per loop, best of {ROUNDS}")
+    print(f"{'loop':<32}{'ms':>10}")
+    for name, expression in LOOPS.items():
+        body = KERNEL.replace("%STEPS%", str(STEPS)).replace("%EXPRESSION%", expression)
+        source_code = "#include <iostream>\n#include <cmath>\nusing namespace std;\n" + body
+        generated_code = compile_to_python(source_code)
+        seconds = best_of(lambda: run_generated(generated_code), ROUNDS)
+        print(f"{name:<32}{seconds * 1000:>10.1f}")
+
+
+if __name__ == "__main__":
+    main()
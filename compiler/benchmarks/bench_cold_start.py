@@ -0,0 +1,108 @@
+"""
+Cold-start benchmark
+Measures time-to-first-successful-compile from a fresh interpreter for the CLI
+(`main.py program.cpp`), the Flask API and the asyncio API, then compares the
+first /compile latency after startup with steady-state latency. It starts with
+an import audit of `import main` (python -X importtime) listing the heaviest
+modules, to catch heavy dependencies that are imported eagerly.
+"""
+
+import asyncio
+import os
+import statistics
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+from bench_servers import HOST, request
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+PORT = 5104
+CLI_RUNS = 5
+STEADY_REQUESTS = 20
+AUDIT_TOP = 10
+# Modules the CLI path should not import
+HEAVY_MODULES = ['flask', 'werkzeug', 'jinja2', 'flask_cors']
+
+PROGRAM = (BASE_DIR / 'examples' / 'functions.cpp').read_text()
+
+
+def import_audit():
+    """Print the modules with the most import time of their own under `import main`"""
+    result = subprocess.run([sys.executable, '-X', 'importtime', '-c', 'import main'],
+                            cwd=BASE_DIR, capture_output=True, text=True)
+    modules = []
+    for line in result.stderr.splitlines():
+        if not line.startswith('import time:') or 'cumulative' in line:
+            continue
+        self_us, cumulative_us, name = line.replace('import time:', '').split('|')
+        modules.append((int(cumulative_us), int(self_us), name.strip()))
+    total = next((cumulative for cumulative, _, name in modules if name == 'main'), 0)
+    print(f"import main: {total / 1000:.1f} ms")
+    print(f"{'module':<40}{'self ms':>10}{'cumulative ms':>15}")
+    for cumulative, self_us, name in sorted(modules, key=lambda m: m[1], reverse=True)[:AUDIT_TOP]:
+        print(f"{name:<40}{self_us / 1000:>10.1f}{cumulative / 1000:>15.1f}")
+    eager = [name for name in HEAVY_MODULES if any(m[2] == name for m in modules)]
+    print(f"heavy modules imported eagerly: {', '.join(eager) if eager else 'none'}")
+
+
+def cli_first_compile():
+    """Wall time of `python main.py <program>` from process start to exit"""
+    program = BASE_DIR / 'examples' / 'functions.cpp'
+    times = []
+    for _ in range(CLI_RUNS):
+        start = time.perf_counter()
+        subprocess.run([sys.executable, 'main.py', str(program)], cwd=BASE_DIR,
+                       check=True, capture_output=True)
+        times.append(time.perf_counter() - start)
+    return statistics.median(times)
+
+
+async def first_success(process: subprocess.Popen) -> float:
+    """Seconds from now until a /compile request succeeds"""
+    start = time.perf_counter()
+    while process.poll() is None:
+        try:
+            if await request(PORT, 'POST', '/compile', {'code': PROGRAM}) == 200:
+                return time.perf_counter() - start
+        except OSError:
+            await asyncio.sleep(0.01)
+    raise RuntimeError("server exited before serving a compile")
+
+
+async def compile_latency() -> float:
+    start = time.perf_counter()
+    await request(PORT, 'POST', '/compile', {'code': PROGRAM + f"\n// {time.time()}\n"})
+    return time.perf_counter() - start
+
+
+def server_cold_start(name: str, command):
+    """Time to first successful compile, then first and steady /compile latency"""
+    env = dict(os.environ, PORT=str(PORT), RATE_LIMIT_RPS='0')
+    start = time.perf_counter()
+    process = subprocess.Popen(command, cwd=BASE_DIR, env=env,
+                               stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    try:
+        asyncio.run(first_success(process))
+        ready = time.perf_counter() - start
+        # Unique sources so nothing is served from a result cache
+        first = asyncio.run(compile_latency())
+        steady = statistics.median(asyncio.run(compile_latency()) for _ in range(STEADY_REQUESTS))
+        print(f"{name:<22}{ready * 1000:>14.0f}{first * 1000:>14.1f}{steady * 1000:>14.1f}")
+    finally:
+        process.terminate()
+        process.wait()
+
+
+def main():
+    import_audit()
+    print()
+    print(f"{'entry point':<22}{'first ok ms':>14}{'next req ms':>14}{'steady ms':>14}")
+    print(f"{'CLI main.py file.cpp':<22}{cli_first_compile() * 1000:>14.0f}{'-':>14}{'-':>14}")
+    server_cold_start("Flask API", [sys.executable, 'main.py', '--api'])
+    server_cold_start("asyncio API", [sys.executable, 'async_server.py', '--host', HOST, '--workers', '1'])
+
+
+if __name__ == "__main__":
+    main()
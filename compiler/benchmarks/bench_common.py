@@ -0,0 +1,49 @@
+"""
+Shared helpers for the compiler benchmarks.
+Each benchmark script can be run directly, e.g. `python benchmarks/bench_switch.py`.
+"""
+
+import sys
+import time
+from io import StringIO
+from pathlib import Path
+from contextlib import redirect_stdout
+
+# Make the compiler modules importable from the benchmarks directory
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent))
+
+from lexer import Lexer
+from parser import Parser
+from semantic_analyzer import SemanticAnalyzer
+from code_generator import CodeGenerator
+
+
+def compile_to_python(source_code: str) -> str:
+    """Run the front end and code generator, returning the generated Python"""
+    ast = Parser(Lexer(source_code).tokenize()).parse()
+    analyzer = SemanticAnalyzer()
+    if not analyzer.analyze(ast):
+        raise RuntimeError("Semantic errors:\n" + "\n".join(analyzer.errors))
+    return CodeGenerator(analyzer).generate(ast)
+
+
+def run_generated(generated_code: str) -> str:
+    """Execute generated code the way the API does and return its output"""
+    output = StringIO()
+    try:
+        with redirect_stdout(output):
+            exec(compile(generated_code, "<generated>", "exec"),
+                 {'__name__': '__main__', '__builtins__': __builtins__})
+    except SystemExit:
+        pass
+    return output.getvalue()
+
+
+def best_of(func, repeat: int = 5) -> float:
+    """Return the best wall time of several runs, in seconds"""
+    best = float('inf')
+    for _ in range(repeat):
+        start = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - start)
+    return best
@@ -0,0 +1,155 @@
+"""
+Delta upload benchmark
+Models a student on poor classroom Wi-Fi. The client edits one line of a
+FUNCTIONS-function program and presses Run after each edit. Requests go
+through a loopback proxy that throttles the uplink to UPLINK_BYTES_PER_SECOND,
+the downlink to DOWNLINK_BYTES_PER_SECOND, and adds LATENCY seconds each way.
+Compares uploading the whole program every time with sending line changes
+against the previous submission (base_hash). Reports bytes uploaded per run
+and Run latency.
+"""
+
+import asyncio
+import json
+import random
+import sys
+import time
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from bench_servers import HOST, percentile, start_server
+from source_deltas import apply_line_changes
+
+PORT = 5109
+PROXY_PORT = 5110
+UPLINK_BYTES_PER_SECOND = 32 * 1024
+DOWNLINK_BYTES_PER_SECOND = 128 * 1024
+LATENCY = 0.05
+SEGMENT = 1460
+FUNCTIONS = 100
+RUNS = 40
+
+
+def program(constants) -> str:
+    lines = ["#include <iostream>", "using namespace std;", ""]
+    for i, constant in enumerate(constants):
+        lines += [f"int step{i}(int value) {{", f"    return value + {constant};", "}", ""]
+    lines += ["int main() {", "    int total = 0;"]
+    lines += [f"    total = step{i}(total);" for i in range(len(constants))]
+    lines += ['    cout << "total " << total << endl;', "    return 0;", "}", ""]
+    return "\n".join(lines)
+
+
+async def pump(reader: asyncio.StreamReader, writer: asyncio.StreamWriter, rate: float):
+    """Forward one direction of a connection at rate bytes/s after LATENCY"""
+    try:
+        while True:
+            data = await reader.read(65536)
+            if not data:
+                break
+            await asyncio.sleep(LATENCY)
+            for offset in range(0, len(data), SEGMENT):
+                segment = data[offset:offset + SEGMENT]
+                await asyncio.sleep(len(segment) / rate)
+                writer.write(segment)
+            await writer.drain()
+    except ConnectionError:
+        pass
+    finally:
+        writer.close()
+
+
+async def proxy_connection(client_reader, client_writer):
+    server_reader, server_writer = await asyncio.open_connection(HOST, PORT)
+    await asyncio.gather(pump(client_reader, server_writer, UPLINK_BYTES_PER_SECOND),
+                         pump(server_reader, client_writer, DOWNLINK_BYTES_PER_SECOND))
+
+
+async def post(payload: dict) -> tuple:
+    """(status, source hash header, bytes sent, body) of one /compile through the proxy"""
+    body = json.dumps(payload).encode('utf-8')
+    request = (f"POST /compile HTTP/1.1\r\nHost: {HOST}\r\nConnection: close\r\n"
+               f"Content-Type: application/json\r\nContent-Length: {len(body)}\r\n\r\n").encode() + body
+    reader, writer = await asyncio.open_connection(HOST, PROXY_PORT)
+    writer.write(request)
+    response = await reader.read()
+    writer.close()
+    head, _, content = response.partition(b'\r\n\r\n')
+    source_hash = None
+    for line in head.split(b'\r\n'):
+        if line.lower().startswith(b'x-source-hash:'):
+            source_hash = line.split(b':', 1)[1].strip().decode()
+    return int(head.split(b' ', 2)[1]), source_hash, len(request), json.loads(content)
+
+
+def line_changes(base: str, code: str) -> list:
+    """One line-range replacement covering every changed line, as the app computes it"""
+    old, new = base.split('\n'), code.split('\n')
+    start = 0
+    while start < min(len(old), len(new)) and old[start] == new[start]:
+        start += 1
+    old_end, new_end = len(old), len(new)
+    while old_end > start and new_end > start and old[old_end - 1] == new[new_end - 1]:
+        old_end -= 1
+        new_end -= 1
+    return [{"start": start, "end": old_end, "lines": new[start:new_end]}]
+
+
+async def session(use_deltas: bool) -> tuple:
+    rng = random.Random(7)
+    constants = list(range(FUNCTIONS))
+    base_code = base_hash = None
+    latencies, sent, fallbacks = [], [], 0
+    for run in range(RUNS):
+        # Each run edits one function, like a student fixing a bug; the new
+        # constant is distinct per run, so no result cache answers
+        constants[rng.randrange(FUNCTIONS)] = 1000 + run
+        code = program(constants)
+
+        start = time.perf_counter()
+        if use_deltas and base_hash is not None:
+            changes = line_changes(base_code, code)
+            assert apply_line_changes(base_code, changes) == code
+            status, source_hash, size, result = await post({"base_hash": base_hash, "changes": changes})
+            if status == 409:
+                fallbacks += 1
+                status, source_hash, more, result = await post({"code": code})
+                size += more
+        else:
+            status, source_hash, size, result = await post({"code": code})
+        latencies.append(time.perf_counter() - start)
+        sent.append(size)
+        assert result['success'], result
+        base_code, base_hash = code, source_hash
+    return latencies, sent, fallbacks
+
+
+async def measure():
+    proxy = await asyncio.start_server(proxy_connection, HOST, PROXY_PORT)
+    try:
+        results = {}
+        for name, use_deltas in (("full upload", False), ("line deltas", True)):
+            results[name] = await session(use_deltas)
+        return results
+    finally:
+        proxy.close()
+
+
+def main():
+    process = start_server([sys.executable, 'async_server.py', '--host', HOST, '--port', str(PORT),
+                            '--workers', '1'], PORT)
+    try:
+        print(f"{len(program(range(FUNCTIONS)))}-byte program, {RUNS} runs; uplink "
+              f"{UPLINK_BYTES_PER_SECOND // 1024} KB/s, downlink {DOWNLINK_BYTES_PER_SECOND // 1024} KB/s, "
+              f"{LATENCY * 1000:.0f} ms each way")
+        print(f"{'upload':<14}{'bytes/run':>11}{'p50 ms':>9}{'p95 ms':>9}{'max ms':>9}{'fallbacks':>11}")
+        for name, (latencies, sent, fallbacks) in asyncio.run(measure()).items():
+            # The first run of a session is always a full upload
+            print(f"{name:<14}{sum(sent[1:]) / (len(sent) - 1):>11.0f}{percentile(latencies[1:], 0.5) * 1000:>9.1f}"
+                  f"{percentile(latencies[1:], 0.95) * 1000:>9.1f}{max(latencies[1:]) * 1000:>9.1f}{fallbacks:>11}")
+    finally:
+        process.terminate()
+        process.wait()
+
+
+if __name__ == "__main__":
+    main()
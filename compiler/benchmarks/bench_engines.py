@@ -0,0 +1,99 @@
+"""
+Execution engine benchmark
+Total /compile latency (compile_source_api: front end, then code generation
+and exec, or closure building and running) of each engine on programs from
+a few lines to a few hundred, with little or a lot of work at run time.
+The auto column is the engine "auto" picks for the program and its latency.
+"""
+
+from pathlib import Path
+
+from bench_common import best_of
+
+from compilation_context import CompilationContext
+from main import compile_source_api
+from lexer import Lexer
+from parser import Parser, walk
+from semantic_analyzer import SemanticAnalyzer
+from call_graph import CallGraph
+from closure_compiler import choose_engine
+
+ROUNDS = 20
+EXAMPLES = Path(__file__).resolve().parent.parent / "examples"
+
+HELLO = """#include <iostream>
+using namespace std;
+int main() {
+    cout << "Hello, World!" << endl;
+    return 0;
+}
+"""
+
+HOT_LOOP = """#include <iostream>
+using namespace std;
+int main() {
+    long total = 0;
+    for (int i = 0; i < 100000; i++) {
+        total = total + i % 7;
+    }
+    cout << total << endl;
+    return 0;
+}
+"""
+
+
+def straight_line_program(functions: int) -> str:
+    """A long program that does little at run time: each function runs once"""
+    bodies = "\n".join(f"""int step{n}(int x) {{
+    int y = x * {n + 2} + 1;
+    if (y % 3 == 0) {{
+        y = y / 3;
+    }} else {{
+        y = y - {n};
+    }}
+    return y % 1000;
+}}""" for n in range(functions))
+    calls = "\n".join(f"    value = step{n}(value);\n    cout << \"step {n}: \" << value << endl;"
+                      for n in range(functions))
+    return (f"#include <iostream>\nusing namespace std;\n{bodies}\n"
+            f"int main() {{\n    int value = 1;\n{calls}\n    return 0;\n}}\n")
+
+
+def programs() -> dict:
+    return {
+        "hello": HELLO,
+        "functions.cpp": (EXAMPLES / "functions.cpp").read_text(),
+        "types.cpp": (EXAMPLES / "types.cpp").read_text(),
+        "structs.cpp": (EXAMPLES / "structs.cpp").read_text(),
+        "switch.cpp": (EXAMPLES / "switch.cpp").read_text(),
+        "straight line, 40 functions": straight_line_program(40),
+        "straight line, 200 functions": straight_line_program(200),
+        "hot loop, 100k iterations": HOT_LOOP,
+    }
+
+
+def auto_choice(source_code: str) -> str:
+    ast = Parser(Lexer(source_code).tokenize()).parse()
+    analyzer = SemanticAnalyzer()
+    analyzer.analyze(ast)
+    return choose_engine(ast, analyzer.call_graph or CallGraph(ast), 'auto')
+
+
+def main():
+    print(f"compile_source_api latency in ms, best of {ROUNDS}")
+    print(f"{'program':<30}{'nodes':>7}{'exec':>9}{'closure':>9}{'auto':>16}")
+    for name, source_code in programs().items():
+        nodes = sum(1 for _ in walk(Parser(Lexer(source_code).tokenize()).parse()))
+        times = {}
+        for engine in ('exec', 'closure', 'auto'):
+            context = CompilationContext(engine=engine)
+            result = compile_source_api(source_code, context)
+            if not result['success']:
+                raise RuntimeError(f"{name} failed on {engine}: {result['error']}")
+            times[engine] = best_of(lambda: compile_source_api(source_code, context), ROUNDS) * 1000
+        auto = f"{auto_choice(source_code)} {times['auto']:.2f}"
+        print(f"{name:<30}{nodes:>7}{times['exec']:>9.2f}{times['closure']:>9.2f}{auto:>16}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+"""
+/examples serving benchmark
+Compares the old handler, which globbed and read ./examples on every request,
+with the preloaded ExampleStore: plain, gzipped, and conditional GETs that
+revalidate with If-None-Match. Reports latency through the Flask test client
+and the bytes sent per response.
+"""
+
+import os
+import time
+from pathlib import Path
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from flask import Flask, jsonify
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+REQUESTS = 2000
+
+
+def legacy_app() -> Flask:
+    """The /examples route as it was before the store"""
+    app = Flask("legacy")
+
+    @app.route('/examples', methods=['GET'])
+    def get_examples():
+        examples = []
+        examples_dir = Path('./examples')
+        if examples_dir.exists():
+            for example_file in examples_dir.glob('*.cpp'):
+                try:
+                    with open(example_file, 'r', encoding='utf-8') as f:
+                        content = f.read()
+                    examples.append({
+                        "filename": example_file.name,
+                        "code": content,
+                        "description": f"Example: {example_file.stem}"
+                    })
+                except Exception:
+                    continue
+        return jsonify({"success": True, "examples": examples, "count": len(examples)})
+
+    return app
+
+
+def measure(client, headers=None):
+    """Mean latency in microseconds and bytes of the last response body"""
+    start = time.perf_counter()
+    for _ in range(REQUESTS):
+        response = client.get('/examples', headers=headers or {})
+    elapsed = time.perf_counter() - start
+    return elapsed / REQUESTS * 1e6, len(response.data), response.status_code
+
+
+def main():
+    os.chdir(BASE_DIR)
+    from main import app, example_store
+
+    start = time.perf_counter()
+    example_store.load()
+    load_time = time.perf_counter() - start
+    snapshot = example_store.snapshot
+    print(f"{len(snapshot.examples)} examples loaded and precompiled in {load_time * 1000:.1f} ms")
+    print(f"{'request':<36}{'us/req':>10}{'bytes':>9}{'status':>8}")
+
+    cases = [
+        ("legacy: read directory per request", legacy_app().test_client(), None),
+        ("store: plain", app.test_client(), None),
+        ("store: Accept-Encoding gzip", app.test_client(), {'Accept-Encoding': 'gzip'}),
+        ("store: If-None-Match (304)", app.test_client(), {'If-None-Match': snapshot.etag}),
+    ]
+    for name, client, headers in cases:
+        latency, size, status = measure(client, headers)
+        print(f"{name:<36}{latency:>10.1f}{size:>9}{status:>8}")
+
+
+if __name__ == "__main__":
+    main()
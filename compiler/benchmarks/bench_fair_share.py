@@ -0,0 +1,115 @@
+"""
+Fair-share scheduling benchmark
+Floods the asyncio API with batch (autograder) compiles while an interactive
+client submits a small program every INTERACTIVE_INTERVAL seconds, once with
+queued compiles served in arrival order (--scheduler fifo) and once with the
+deficit-round-robin scheduler (--scheduler drr). Reports client-side latency
+per class and whether interactive p95 stays under INTERACTIVE_TARGET_MS, then
+the server's own per-class metrics from /server-info.
+"""
+
+import asyncio
+import json
+import sys
+import time
+from pathlib import Path
+
+from bench_servers import HOST, percentile, request, start_server
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+PORT = 5105
+WORKERS = 1
+BATCH_CLIENTS = 32
+DURATION = 10.0
+INTERACTIVE_INTERVAL = 0.1
+INTERACTIVE_TARGET_MS = 250
+
+BATCH_PROGRAM = """#include <iostream>
+using namespace std;
+int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }
+int main() {
+    cout << fib(21) << endl;
+    return 0;
+}
+"""
+
+INTERACTIVE_PROGRAM = """#include <iostream>
+using namespace std;
+int main() {
+    int total = 0;
+    for (int i = 0; i < 100; i++) { total = total + i; }
+    cout << "total = " << total << endl;
+    return 0;
+}
+"""
+
+
+async def server_info() -> dict:
+    reader, writer = await asyncio.open_connection(HOST, PORT)
+    writer.write(f"GET /server-info HTTP/1.1\r\nHost: {HOST}\r\nConnection: close\r\n\r\n".encode())
+    await writer.drain()
+    response = await reader.read()
+    writer.close()
+    return json.loads(response.split(b'\r\n\r\n', 1)[1])
+
+
+async def mixed_load():
+    """Latencies (s) of the batch and interactive requests sent during DURATION"""
+    latencies = {'batch': [], 'interactive': []}
+    deadline = time.perf_counter() + DURATION
+
+    async def send(request_class: str, code: str):
+        start = time.perf_counter()
+        await request(PORT, 'POST', '/compile', {'code': code, 'request_class': request_class})
+        latencies[request_class].append(time.perf_counter() - start)
+
+    async def batch_client():
+        while time.perf_counter() < deadline:
+            await send('batch', BATCH_PROGRAM)
+
+    async def interactive_client():
+        pending = []
+        while time.perf_counter() < deadline:
+            pending.append(asyncio.ensure_future(send('interactive', INTERACTIVE_PROGRAM)))
+            await asyncio.sleep(INTERACTIVE_INTERVAL)
+        await asyncio.gather(*pending)
+
+    await asyncio.gather(interactive_client(), *(batch_client() for _ in range(BATCH_CLIENTS)))
+    return latencies
+
+
+def run(policy: str):
+    process = start_server([sys.executable, 'async_server.py', '--host', HOST, '--port', str(PORT),
+                            '--workers', str(WORKERS), '--scheduler', policy], PORT)
+    try:
+        latencies = asyncio.run(mixed_load())
+        info = asyncio.run(server_info())
+    finally:
+        process.terminate()
+        process.wait()
+
+    for request_class in ('interactive', 'batch'):
+        samples = latencies[request_class]
+        p95 = percentile(samples, 0.95) * 1000
+        verdict = ''
+        if request_class == 'interactive':
+            verdict = 'ok' if p95 <= INTERACTIVE_TARGET_MS else 'MISSED'
+        print(f"{policy:<8}{request_class:<13}{len(samples):>9}{percentile(samples, 0.5) * 1000:>10.1f}"
+              f"{p95:>10.1f}{verdict:>8}")
+    for name, metrics in info['scheduler']['classes'].items():
+        if metrics['granted']:
+            print(f"{'':<8}  server {name:<12} granted {metrics['granted']:>5}, "
+                  f"mean wait {metrics['mean_wait_ms']:.1f} ms, p95 {metrics['latency_ms']['p95']} ms")
+
+
+def main():
+    print(f"{WORKERS} worker, {BATCH_CLIENTS} batch clients, one interactive request every "
+          f"{INTERACTIVE_INTERVAL * 1000:.0f} ms for {DURATION:.0f} s; "
+          f"interactive p95 target {INTERACTIVE_TARGET_MS} ms")
+    print(f"{'policy':<8}{'class':<13}{'requests':>9}{'p50 ms':>10}{'p95 ms':>10}{'target':>8}")
+    for policy in ('fifo', 'drr'):
+        run(policy)
+
+
+if __name__ == "__main__":
+    main()
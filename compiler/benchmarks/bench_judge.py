@@ -0,0 +1,121 @@
+"""
+Judge mode benchmark
+Grades a submission on TESTS inputs, each a few thousand numbers, and compares
+the total judge time of:
+- a full compile and run per test, one after another (grading before /judge)
+- one compile, then every test in this process (judge_api)
+- one compile, then the tests fanned out to a pool of WORKERS processes, as
+  /judge does; the pool is started and warmed before timing, as a server's is
+"""
+
+import os
+import random
+from concurrent.futures import ProcessPoolExecutor
+
+from bench_common import best_of
+
+from compilation_context import CompilationContext
+from judge import ACCEPTED, JudgeLimits, JudgeTest
+from main import judge_api, judge_test, translate_api
+
+TESTS = 100
+NUMBERS = 2000
+ROUNDS = 3
+WORKERS = os.cpu_count() or 1
+
+# Longest run of increasing values and the largest subarray sum
+SUBMISSION = """#include <iostream>
+using namespace std;
+
+long maxSubarray(int n) {
+    long best = 0;
+    long current = 0;
+    int previous = 0;
+    int run = 0;
+    int longest = 0;
+    for (int i = 0; i < n; i++) {
+        int value;
+        cin >> value;
+        current = current + value;
+        if (current < 0) {
+            current = 0;
+        }
+        if (current > best) {
+            best = current;
+        }
+        if (i > 0 && value > previous) {
+            run = run + 1;
+        } else {
+            run = 1;
+        }
+        if (run > longest) {
+            longest = run;
+        }
+        previous = value;
+    }
+    cout << longest << endl;
+    return best;
+}
+
+int main() {
+    int n;
+    cin >> n;
+    cout << maxSubarray(n) << endl;
+    return 0;
+}
+"""
+
+
+def make_test(number: int) -> JudgeTest:
+    generator = random.Random(number)
+    values = [generator.randint(-1000, 1000) for _ in range(NUMBERS)]
+    best = current = 0
+    longest = run = 0
+    for i, value in enumerate(values):
+        current = max(0, current + value)
+        best = max(best, current)
+        run = run + 1 if i > 0 and value > values[i - 1] else 1
+        longest = max(longest, run)
+    text = f"{NUMBERS}\n" + " ".join(map(str, values)) + "\n"
+    return JudgeTest(str(number), text, f"{longest}\n{best}\n")
+
+
+def compile_per_test(tests, context, limits):
+    """Grading without /judge: every test compiles the submission again"""
+    results = []
+    for test in tests:
+        generated_code, _, _ = translate_api(SUBMISSION, context)
+        # Unique code per test defeats the compiled-code cache, as separate compiles would
+        results.append(judge_test(generated_code + f"\n# {test.name}", context.filename, test,
+                                  limits, 'tokens'))
+    return results
+
+
+def main():
+    tests = [make_test(number) for number in range(TESTS)]
+    context = CompilationContext()
+    limits = JudgeLimits()
+    print(f"{TESTS} tests of {NUMBERS} numbers, {WORKERS} workers, best of {ROUNDS}")
+    print(f"{'approach':<36}{'total ms':>10}{'speedup':>10}")
+
+    results = {}
+    serial = best_of(lambda: results.update(serial=compile_per_test(tests, context, limits)), ROUNDS)
+    scenarios = [("compile and run per test", serial)]
+    once = best_of(lambda: results.update(once=judge_api(SUBMISSION, tests, context, limits, 'tokens')), ROUNDS)
+    scenarios.append(("compile once, serial tests", once))
+    with ProcessPoolExecutor(max_workers=WORKERS) as pool:
+        # Start and warm the workers before timing
+        judge_api(SUBMISSION, tests, context, limits, 'tokens', map_tests=pool.map)
+        fanned = best_of(lambda: results.update(
+            pool=judge_api(SUBMISSION, tests, context, limits, 'tokens', map_tests=pool.map)), ROUNDS)
+    scenarios.append((f"compile once, {WORKERS} worker processes", fanned))
+
+    for name, seconds in scenarios:
+        print(f"{name:<36}{seconds * 1000:>10.1f}{serial / seconds:>9.1f}x")
+    accepted = [sum(result['verdict'] == ACCEPTED for result in results['serial']),
+                results['once']['passed'], results['pool']['passed']]
+    print(f"accepted: {accepted} of {TESTS}")
+
+
+if __name__ == "__main__":
+    main()
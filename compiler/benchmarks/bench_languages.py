@@ -0,0 +1,196 @@
+"""
+Custom language benchmark
+Uses the app's Urdu and Hindi sample languages. First it times building a
+language's translator and translating one program, in-process. Then it
+compares end-to-end /compile latency on the asyncio server for two paths.
+In the first, the client translates and uploads C++, as the app did. In the
+second, the client uploads the language once and sends the custom-language
+code with its language_hash. The client-side translation here runs this
+port in Python. A low-end phone running the Dart parser is slower; its cost
+is the "translate" column times the device's slowdown.
+"""
+
+import asyncio
+import json
+import statistics
+import sys
+import time
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from bench_servers import HOST, percentile, start_server
+from custom_language import Translator
+
+PORT = 5108
+REQUESTS = 50
+TRANSLATIONS = 500
+
+URDU = {
+    "id": "urdu-sample",
+    "name": "اردو پروگرامنگ",
+    "syntax": {
+        "controlStructures": {
+            "ifStatement": "اگر", "elseStatement": "ورنہ", "elseIfStatement": "ورنہ اگر",
+            "forLoop": "لوپ", "whileLoop": "جب تک", "doWhileLoop": "کرو", "switchStatement": "تبدیل",
+            "caseStatement": "صورت", "defaultCase": "بنیادی", "breakStatement": "توڑ",
+            "continueStatement": "جاری", "returnStatement": "واپس",
+        },
+        "dataTypes": {
+            "integerType": "عدد", "stringType": "متن", "booleanType": "بولین", "floatType": "اعشاری",
+            "doubleType": "ڈبل", "characterType": "حرف", "voidType": "خالی",
+        },
+        "functions": {"mainFunction": "بنیادی", "functionDeclaration": "فنکشن"},
+        "keywords": {
+            "include": "#شامل", "namespace": "نام_جگہ", "using": "استعمال", "struct": "ڈھانچہ",
+            "class": "کلاس", "public": "عوامی", "private": "نجی", "protected": "محفوظ",
+        },
+    },
+}
+
+HINDI = {
+    "id": "hindi-sample",
+    "name": "हिंदी प्रोग्रामिंग",
+    "syntax": {
+        "controlStructures": {
+            "ifStatement": "यदि", "elseStatement": "अन्यथा", "elseIfStatement": "अन्यथा यदि",
+            "forLoop": "के लिए", "whileLoop": "जब तक", "doWhileLoop": "करें", "switchStatement": "स्विच",
+            "caseStatement": "केस", "defaultCase": "डिफ़ॉल्ट", "breakStatement": "तोड़ें",
+            "continueStatement": "जारी", "returnStatement": "वापसी",
+        },
+        "dataTypes": {
+            "integerType": "संख्या", "stringType": "पाठ", "booleanType": "बूलियन", "floatType": "दशमलव",
+            "doubleType": "डबल", "characterType": "अक्षर", "voidType": "खाली",
+        },
+        "functions": {"mainFunction": "मुख्य", "functionDeclaration": "फंक्शन"},
+        "keywords": {
+            "include": "#शामिल", "namespace": "नाम_स्थान", "using": "उपयोग", "struct": "संरचना",
+            "class": "क्लास", "public": "सार्वजनिक", "private": "निजी", "protected": "संरक्षित",
+        },
+    },
+}
+
+# The Urdu sample spells both main and default as بنیادی, and default is
+# translated first, so the Urdu program keeps main
+URDU_PROGRAM = """#شامل <iostream>
+استعمال نام_جگہ std;
+
+عدد square(عدد x) {
+    واپس x * x;
+}
+
+عدد main() {
+    عدد total = 0;
+    لوپ (عدد i = 1; i <= 20; i++) {
+        اگر (i % 3 == 0) {
+            total = total + square(i);
+        } ورنہ اگر (i % 5 == 0) {
+            total = total - i;
+        } ورنہ {
+            total = total + 1;
+        }
+    }
+    عدد n = 0;
+    جب تک (n < 5) {
+        n = n + 1;
+    }
+    cout << "total " << total << " n " << n << endl;
+    واپس 0;
+}
+"""
+
+HINDI_PROGRAM = """#शामिल <iostream>
+उपयोग नाम_स्थान std;
+
+संख्या square(संख्या x) {
+    वापसी x * x;
+}
+
+संख्या मुख्य() {
+    संख्या total = 0;
+    के लिए (संख्या i = 1; i <= 20; i++) {
+        यदि (i % 3 == 0) {
+            total = total + square(i);
+        } अन्यथा यदि (i % 5 == 0) {
+            total = total - i;
+        } अन्यथा {
+            total = total + 1;
+        }
+    }
+    संख्या n = 0;
+    जब तक (n < 5) {
+        n = n + 1;
+    }
+    cout << "total " << total << " n " << n << endl;
+    वापसी 0;
+}
+"""
+
+
+def translation_cost(definition: dict, program: str) -> tuple:
+    """Microseconds to build a translator and to translate the program with a cached one"""
+    start = time.perf_counter()
+    for _ in range(TRANSLATIONS):
+        Translator(definition)
+    build = (time.perf_counter() - start) / TRANSLATIONS * 1e6
+    translator = Translator(definition)
+    start = time.perf_counter()
+    for _ in range(TRANSLATIONS):
+        translator.translate(program)
+    translate = (time.perf_counter() - start) / TRANSLATIONS * 1e6
+    return build, translate
+
+
+async def post(path: str, payload: dict) -> tuple:
+    body = json.dumps(payload).encode('utf-8')
+    reader, writer = await asyncio.open_connection(HOST, PORT)
+    writer.write((f"POST {path} HTTP/1.1\r\nHost: {HOST}\r\nConnection: close\r\n"
+                  f"Content-Type: application/json\r\nContent-Length: {len(body)}\r\n\r\n").encode() + body)
+    response = await reader.read()
+    writer.close()
+    head, _, content = response.partition(b'\r\n\r\n')
+    return int(head.split(b' ', 2)[1]), json.loads(content)
+
+
+async def compare(definition: dict, program: str) -> tuple:
+    """Per-request latencies of client-side and server-side translation"""
+    client_side, server_side = [], []
+    translator = Translator(definition)
+    status, registered = await post('/languages', definition)
+    assert status == 200, registered
+    for i in range(REQUESTS):
+        # A distinct program each time, so no result cache answers
+        source = program + f"// {i}\n"
+        start = time.perf_counter()
+        status, result = await post('/compile', {'code': translator.translate(source)})
+        client_side.append(time.perf_counter() - start)
+        assert result['success'], result
+
+        start = time.perf_counter()
+        status, result = await post('/compile', {'code': source, 'language_hash': registered['language_hash']})
+        server_side.append(time.perf_counter() - start)
+        assert result['success'], result
+    return client_side, server_side
+
+
+def main():
+    print(f"{'language':<10}{'build translator us':>21}{'translate us':>14}")
+    for name, definition, program in (('Urdu', URDU, URDU_PROGRAM), ('Hindi', HINDI, HINDI_PROGRAM)):
+        build, translate = translation_cost(definition, program)
+        print(f"{name:<10}{build:>21.1f}{translate:>14.1f}")
+
+    process = start_server([sys.executable, 'async_server.py', '--host', HOST, '--port', str(PORT),
+                            '--workers', '1'], PORT)
+    try:
+        print(f"\n/compile latency over {REQUESTS} requests (ms)")
+        print(f"{'language':<10}{'path':<22}{'p50':>8}{'p95':>8}{'mean':>8}")
+        for name, definition, program in (('Urdu', URDU, URDU_PROGRAM), ('Hindi', HINDI, HINDI_PROGRAM)):
+            client_side, server_side = asyncio.run(compare(definition, program))
+            for path, samples in (('client translates', client_side), ('server translates', server_side)):
+                print(f"{name:<10}{path:<22}{percentile(samples, 0.5) * 1000:>8.2f}"
+                      f"{percentile(samples, 0.95) * 1000:>8.2f}{statistics.mean(samples) * 1000:>8.2f}")
+    finally:
+        process.terminate()
+        process.wait()
+
+
+if __name__ == "__main__":
+    main()
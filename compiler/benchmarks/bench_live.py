@@ -0,0 +1,156 @@
+"""
+Live-compile benchmark
+Simulates a user typing into the editor: BURSTS bursts of KEYSTROKES single
+character insertions KEY_INTERVAL apart, each followed by a PAUSE. In live
+mode every keystroke is streamed to /live as a range edit and the server
+debounces builds; the HTTP baseline waits for the same debounce on the client
+and then POSTs the whole program to /compile. Reports the latency from the
+last keystroke of a burst to its diagnostics (live) or response (HTTP), the
+bytes the client uploaded and how many builds the server ran.
+"""
+
+import asyncio
+import base64
+import json
+import os
+import sys
+import time
+from urllib.request import urlopen
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from bench_servers import HOST, percentile, request, start_server
+from live_session import DEBOUNCE_SECONDS
+from websocket_protocol import OP_TEXT, encode_frame, read_frame
+
+PORT = 5107
+BURSTS = 20
+KEYSTROKES = 12
+KEY_INTERVAL = 0.06
+PAUSE = 0.8
+
+PROGRAM = """#include <iostream>
+using namespace std;
+
+int fib(int n) {
+    if (n < 2) return n;
+    return fib(n - 1) + fib(n - 2);
+}
+
+int main() {
+    int total = 0;
+    for (int i = 0; i < 22; i++) {
+        total = total + fib(i);
+    }
+    cout << "total " << total << endl;
+    // notes:
+    return 0;
+}
+"""
+# Typing happens at the end of the comment line
+CURSOR = PROGRAM.index("// notes:") + len("// notes:")
+
+
+class LiveClient:
+    """Minimal masked WebSocket client for /live"""
+
+    async def connect(self):
+        self.reader, self.writer = await asyncio.open_connection(HOST, PORT)
+        key = base64.b64encode(os.urandom(16)).decode()
+        self.writer.write((f"GET /live HTTP/1.1\r\nHost: {HOST}\r\nUpgrade: websocket\r\n"
+                           f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\n"
+                           f"Sec-WebSocket-Version: 13\r\n\r\n").encode())
+        head = await self.reader.readuntil(b'\r\n\r\n')
+        assert head.startswith(b'HTTP/1.1 101'), head
+        self.sent_bytes = 0
+
+    async def send(self, message: dict):
+        frame = encode_frame(OP_TEXT, json.dumps(message).encode(), mask=os.urandom(4))
+        self.sent_bytes += len(frame)
+        self.writer.write(frame)
+        await self.writer.drain()
+
+    async def receive(self) -> dict:
+        _, _, payload = await read_frame(self.reader, 1 << 24, masked=False)
+        return json.loads(payload)
+
+
+async def type_live():
+    client = LiveClient()
+    await client.connect()
+    await client.send({"type": "open"})
+    source, version = PROGRAM, 1
+    await client.send({"type": "edit", "version": version, "code": source})
+    arrivals = {}
+
+    async def receive():
+        while True:
+            message = await client.receive()
+            if message["type"] == "diagnostics":
+                arrivals[message["version"]] = time.perf_counter()
+
+    receiver = asyncio.ensure_future(receive())
+    await asyncio.sleep(PAUSE)
+    client.sent_bytes = 0
+    latencies = []
+    for burst in range(BURSTS):
+        for key in range(KEYSTROKES):
+            position = CURSOR + burst * KEYSTROKES + key
+            text = "abcdefghijklmnopqrstuvwxyz"[(burst + key) % 26]
+            source = source[:position] + text + source[position:]
+            version += 1
+            await client.send({"type": "edit", "version": version, "base": version - 1,
+                               "changes": [{"start": position, "end": position, "text": text}]})
+            last_key = time.perf_counter()
+            await asyncio.sleep(KEY_INTERVAL)
+        await asyncio.sleep(PAUSE - KEY_INTERVAL)
+        if version in arrivals:
+            latencies.append(arrivals[version] - last_key)
+    receiver.cancel()
+    client.writer.close()
+    return latencies, client.sent_bytes
+
+
+async def type_http():
+    source = PROGRAM
+    latencies, sent_bytes = [], 0
+    for burst in range(BURSTS):
+        for key in range(KEYSTROKES):
+            position = CURSOR + burst * KEYSTROKES + key
+            source = source[:position] + "abcdefghijklmnopqrstuvwxyz"[(burst + key) % 26] + source[position:]
+            last_key = time.perf_counter()
+            await asyncio.sleep(KEY_INTERVAL)
+        # The client-side debounce the editor would use
+        await asyncio.sleep(max(0.0, DEBOUNCE_SECONDS - KEY_INTERVAL))
+        payload = {"code": source}
+        sent_bytes += len(json.dumps(payload)) + 120  # body plus request line and headers
+        status = await request(PORT, 'POST', '/compile', payload)
+        assert status in (200, 400), status
+        latencies.append(time.perf_counter() - last_key)
+        await asyncio.sleep(PAUSE - DEBOUNCE_SECONDS)
+    return latencies, sent_bytes
+
+
+def report(name: str, latencies, sent_bytes: int):
+    print(f"{name:<24}{len(latencies):>6}{percentile(latencies, 0.5) * 1000:>9.1f}"
+          f"{percentile(latencies, 0.95) * 1000:>9.1f}{sent_bytes:>12}")
+
+
+def main():
+    process = start_server([sys.executable, 'async_server.py', '--host', HOST, '--port', str(PORT),
+                            '--workers', '1'], PORT)
+    try:
+        print(f"{BURSTS} bursts of {KEYSTROKES} keystrokes {KEY_INTERVAL * 1000:.0f} ms apart; "
+              f"debounce {DEBOUNCE_SECONDS * 1000:.0f} ms")
+        print(f"{'mode':<24}{'bursts':>6}{'p50 ms':>9}{'p95 ms':>9}{'bytes sent':>12}")
+        report("live (diagnostics)", *asyncio.run(type_live()))
+        report("HTTP /compile per pause", *asyncio.run(type_http()))
+        with urlopen(f"http://{HOST}:{PORT}/server-info") as response:
+            live = json.load(response)["live"]
+        print(f"live builds run: {live['builds']}, pending builds cancelled: {live['cancelled']}")
+    finally:
+        process.terminate()
+        process.wait()
+
+
+if __name__ == "__main__":
+    main()
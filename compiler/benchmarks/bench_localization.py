@@ -0,0 +1,102 @@
+"""
+Hot-name localization benchmark
+Loops whose bodies read module-level names: user functions, float arithmetic
+(cpp_float32), truncating integer division (cpp_idiv), double to int
+conversion (int) and cout. Each runs STEPS iterations; reports the best run
+time of the generated program.
+"""
+
+from bench_common import compile_to_python, run_generated, best_of
+
+STEPS = 200000
+ROUNDS = 5
+
+LOOPS = {
+    "function call": """
+int step(int value) {
+    return value % 7;
+}
+int main() {
+    long total = 0;
+    for (int i = 0; i < %STEPS%; i++) {
+        total = total + step(i);
+    }
+    cout << total << endl;
+    return 0;
+}
+""",
+    "method calling function": """
+int weight(int value) {
+    return value % 5;
+}
+struct Accumulator {
+    long total;
+    void run(int steps) {
+        for (int i = 0; i < steps; i++) {
+            total = total + weight(i);
+        }
+    }
+};
+int main() {
+    Accumulator acc;
+    acc.total = 0;
+    acc.run(%STEPS%);
+    cout << acc.total << endl;
+    return 0;
+}
+""",
+    "float arithmetic": """
+int main() {
+    float x = 1.0f;
+    for (int i = 0; i < %STEPS%; i++) {
+        x = x * 1.00001f + 0.5f;
+    }
+    cout << x << endl;
+    return 0;
+}
+""",
+    "signed division": """
+int main() {
+    int total = 0;
+    for (int i = -%STEPS%; i < 0; i++) {
+        total = total + i / 7 % 3;
+    }
+    cout << total << endl;
+    return 0;
+}
+""",
+    "double to int": """
+int main() {
+    long total = 0;
+    double scale = 0.75;
+    for (int i = 0; i < %STEPS%; i++) {
+        int part = i * scale;
+        total = total + part;
+    }
+    cout << total << endl;
+    return 0;
+}
+""",
+    "cout": """
+int main() {
+    for (int i = 0; i < %STEPS%; i++) {
+        cout << i << " " << i * 2 << endl;
+    }
+    return 0;
+}
+""",
+}
+
+
+def main():
+    print(f"{STEPS} iterations per loop, best of {ROUNDS}")
+    print(f"{'loop':<32}{'ms':>10}")
+    for name, body in LOOPS.items():
+        source_code = "#include <iostream>\nusing namespace std;\n" + body.replace("%STEPS%", str(STEPS))
+        generated_code = compile_to_python(source_code)
+        seconds = best_of(lambda: run_generated(generated_code), ROUNDS)
+        print(f"{name:<32}{seconds * 1000:>10.1f}")
+
+
+if __name__ == "__main__":
+    main()
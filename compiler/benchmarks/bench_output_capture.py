@@ -0,0 +1,61 @@
+"""
+Output capture benchmark
+Compiles and runs a program that prints OUTPUT_MB megabytes through
+compile_source_api, in a fresh process per run, with the bounded head/tail
+buffer and with the unbounded list the runtime used before. Reports latency,
+peak RSS of the process and the size of the execution_output returned.
+"""
+
+import json
+import subprocess
+import sys
+from pathlib import Path
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+OUTPUT_MB = 100
+LINE = "x" * 999
+
+PROGRAM = f"""#include <iostream>
+using namespace std;
+int main() {{
+    for (int i = 0; i < {OUTPUT_MB * 1000}; i++) {{
+        cout << "{LINE}" << endl;
+    }}
+    return 0;
+}}
+"""
+
+RUN = """
+import json, resource, sys, time
+import main
+from compilation_context import CompilationContext
+if sys.argv[1] == 'unbounded':
+    main.HeadTailBuffer = list
+source = sys.stdin.read()
+start = time.perf_counter()
+result = main.compile_source_api(source, CompilationContext())
+elapsed = time.perf_counter() - start
+body = json.dumps(result)
+print(json.dumps({"seconds": elapsed, "rss_mb": resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024,
+                  "output": len(result["execution_output"]), "response": len(body),
+                  "truncated": result["truncated_output"]}))
+"""
+
+
+def run(mode: str) -> dict:
+    result = subprocess.run([sys.executable, '-c', RUN, mode], cwd=BASE_DIR, input=PROGRAM,
+                            capture_output=True, text=True, check=True)
+    return json.loads(result.stdout)
+
+
+def main():
+    print(f"Program printing {OUTPUT_MB} MB ({OUTPUT_MB * 1000} lines of {len(LINE) + 1} characters)")
+    print(f"{'capture':<12}{'seconds':>9}{'peak RSS MB':>13}{'output chars':>14}{'response bytes':>16}{'dropped':>12}")
+    for mode in ('unbounded', 'head/tail'):
+        stats = run(mode)
+        print(f"{mode:<12}{stats['seconds']:>9.2f}{stats['rss_mb']:>13.0f}{stats['output']:>14}"
+              f"{stats['response']:>16}{stats['truncated']:>12}")
+
+
+if __name__ == "__main__":
+    main()
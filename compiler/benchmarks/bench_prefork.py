@@ -0,0 +1,92 @@
+"""
+Prefork server scaling benchmark
+Runs `async_server.py --processes N` for N in PROCESS_COUNTS and measures /compile
+throughput with unique programs (every request compiles) and with one repeated
+program (served from the shared cache), plus resident and proportional memory
+per worker process.
+"""
+
+import asyncio
+import os
+import sys
+import time
+from pathlib import Path
+
+from bench_servers import HOST, percentile, request, start_server
+
+PORT = 5103
+PROCESS_COUNTS = [1, 2, 4, 8, 16]
+CLIENTS = 32
+REQUESTS = 400
+
+PROGRAM = """#include <iostream>
+using namespace std;
+int fib(int n) {{ if (n < 2) {{ return n; }} return fib(n - 1) + fib(n - 2); }}
+int main() {{
+    int total = {seed};
+    for (int i = 0; i < 15; i++) {{ total = total + fib(i); }}
+    cout << "total = " << total << endl;
+    return 0;
+}}
+"""
+
+
+async def load(unique: bool, offset: int):
+    """Requests per second and p99 latency (ms) for REQUESTS /compile calls"""
+    latencies = []
+    failures = 0
+    counter = iter(range(REQUESTS))
+
+    async def client():
+        nonlocal failures
+        for n in counter:
+            code = PROGRAM.format(seed=offset + n if unique else 0)
+            start = time.perf_counter()
+            try:
+                status = await request(PORT, 'POST', '/compile', {'code': code})
+            except OSError:
+                status = 0
+            latencies.append(time.perf_counter() - start)
+            failures += status != 200
+
+    start = time.perf_counter()
+    await asyncio.gather(*(client() for _ in range(CLIENTS)))
+    return REQUESTS / (time.perf_counter() - start), percentile(latencies, 0.99) * 1000, failures
+
+
+def memory_kb(pid: int, field: str) -> int:
+    """A field of /proc/<pid>/smaps_rollup, in kB"""
+    for line in Path(f"/proc/{pid}/smaps_rollup").read_text().splitlines():
+        if line.startswith(field + ':'):
+            return int(line.split()[1])
+    return 0
+
+
+def worker_pids(pid: int):
+    return [int(child) for child in Path(f"/proc/{pid}/task/{pid}/children").read_text().split()]
+
+
+def main():
+    print(f"{CLIENTS} clients, {REQUESTS} requests per run, {os.cpu_count()} CPUs")
+    print(f"{'processes':>10}{'unique req/s':>14}{'p99 ms':>9}{'cached req/s':>14}{'p99 ms':>9}"
+          f"{'RSS MB/worker':>15}{'PSS MB/worker':>15}{'failed':>8}")
+    for run, processes in enumerate(PROCESS_COUNTS):
+        server = start_server([sys.executable, 'async_server.py', '--host', HOST,
+                               '--processes', str(processes)], PORT)
+        try:
+            # Seeds differ per run so no run is served from an earlier run's cache
+            unique, unique_p99, unique_failed = asyncio.run(load(True, run * REQUESTS * 10))
+            asyncio.run(load(False, 0))
+            cached, cached_p99, cached_failed = asyncio.run(load(False, 0))
+            workers = worker_pids(server.pid)
+            rss = sum(memory_kb(pid, 'Rss') for pid in workers) / len(workers) / 1024
+            pss = sum(memory_kb(pid, 'Pss') for pid in workers) / len(workers) / 1024
+            print(f"{processes:>10}{unique:>14.1f}{unique_p99:>9.1f}{cached:>14.1f}{cached_p99:>9.1f}"
+                  f"{rss:>15.1f}{pss:>15.1f}{unique_failed + cached_failed:>8}")
+        finally:
+            server.terminate()
+            server.wait()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,137 @@
+"""
+Admission limit benchmark
+Measures what turning clients away costs. First the token-bucket check alone,
+in-process; then the asyncio API under a flood of /compile requests from one
+client over its rate limit (429) and of requests whose Content-Length exceeds
+the body cap (413), offered at TARGET_RATE requests per second. Both are
+answered from the headers alone: the server closes the connection instead of
+reading the body, so clients reconnect. Reports the
+rate achieved, response latency and the server's CPU time per rejection, read
+from /proc. A /health flood at the same rate is the baseline cost of an HTTP
+request on this server.
+"""
+
+import asyncio
+import json
+import os
+import sys
+import time
+from pathlib import Path
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from bench_servers import HOST, percentile, start_server
+from rate_limit import RateLimiter
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+PORT = 5106
+TARGET_RATE = 5000
+DURATION = 5.0
+CONNECTIONS = 50
+CHECKS = 200_000
+
+PROGRAM = "int main() { return 0; }"
+
+
+def limiter_cost():
+    """Microseconds per allow() for one client over its limit and for many distinct clients"""
+    limiter = RateLimiter(rate=1, burst=1)
+    start = time.perf_counter()
+    for _ in range(CHECKS):
+        limiter.allow('ip:10.0.0.1')
+    single = (time.perf_counter() - start) / CHECKS * 1e6
+
+    keys = [f'ip:10.0.{i // 256}.{i % 256}' for i in range(10_000)]
+    start = time.perf_counter()
+    for i in range(CHECKS):
+        limiter.allow(keys[i % len(keys)])
+    many = (time.perf_counter() - start) / CHECKS * 1e6
+    print(f"RateLimiter.allow: {single:.2f} us (one client), {many:.2f} us (10k clients)")
+
+
+def cpu_seconds(pid: int) -> float:
+    """User plus system CPU time of a process"""
+    fields = Path(f'/proc/{pid}/stat').read_text().rsplit(')', 1)[1].split()
+    return (int(fields[11]) + int(fields[12])) / os.sysconf('SC_CLK_TCK')
+
+
+async def read_response(reader: asyncio.StreamReader) -> tuple:
+    """(status, whether the server closes the connection after it)"""
+    head = await reader.readuntil(b'\r\n\r\n')
+    status = int(head.split(b' ', 2)[1])
+    for line in head.split(b'\r\n'):
+        if line.lower().startswith(b'content-length:'):
+            await reader.readexactly(int(line.split(b':')[1]))
+    return status, b'\r\nconnection: close' in head.lower()
+
+
+async def flood(request: bytes, keep_alive: bool):
+    """Offer TARGET_RATE requests/s for DURATION; returns statuses and latencies"""
+    statuses, latencies = {}, []
+    interval = CONNECTIONS / TARGET_RATE
+    deadline = time.perf_counter() + DURATION
+
+    async def connection():
+        reader = writer = None
+        next_send = time.perf_counter()
+        while next_send < deadline:
+            await asyncio.sleep(max(0.0, next_send - time.perf_counter()))
+            next_send += interval
+            start = time.perf_counter()
+            closed = True
+            try:
+                if writer is None:
+                    reader, writer = await asyncio.open_connection(HOST, PORT)
+                writer.write(request)
+                status, closed = await read_response(reader)
+            except (OSError, asyncio.IncompleteReadError):
+                status = 0
+            latencies.append(time.perf_counter() - start)
+            statuses[status] = statuses.get(status, 0) + 1
+            if not keep_alive or closed:
+                if writer is not None:
+                    writer.close()
+                reader = writer = None
+        if writer is not None:
+            writer.close()
+
+    await asyncio.gather(*(connection() for _ in range(CONNECTIONS)))
+    return statuses, latencies
+
+
+def run(name: str, request: bytes, keep_alive: bool, pid: int):
+    cpu_before = cpu_seconds(pid)
+    start = time.perf_counter()
+    statuses, latencies = asyncio.run(flood(request, keep_alive))
+    elapsed = time.perf_counter() - start
+    server_cpu = cpu_seconds(pid) - cpu_before
+    total = sum(statuses.values())
+    print(f"{name:<30}{total / elapsed:>9.0f}{percentile(latencies, 0.5) * 1000:>9.2f}"
+          f"{percentile(latencies, 0.99) * 1000:>9.2f}{server_cpu / total * 1e6:>12.1f}"
+          f"{server_cpu / elapsed * 100:>9.0f}%   {statuses}")
+
+
+def main():
+    limiter_cost()
+    body = json.dumps({'code': PROGRAM}).encode()
+    over_rate = (f"POST /compile HTTP/1.1\r\nHost: {HOST}\r\nContent-Type: application/json\r\n"
+                 f"Content-Length: {len(body)}\r\n\r\n").encode() + body
+    health = f"GET /health HTTP/1.1\r\nHost: {HOST}\r\n\r\n".encode()
+    # Only the headers are sent: the server must refuse from Content-Length alone
+    oversized = (f"POST /compile HTTP/1.1\r\nHost: {HOST}\r\nContent-Type: application/json\r\n"
+                 f"Content-Length: {64 * 1024 * 1024}\r\n\r\n").encode()
+
+    process = start_server([sys.executable, 'async_server.py', '--host', HOST, '--port', str(PORT),
+                            '--workers', '1'], PORT, RATE_LIMIT_RPS='1', RATE_LIMIT_BURST='1')
+    try:
+        print(f"\n{TARGET_RATE} req/s offered for {DURATION:.0f} s on {CONNECTIONS} connections")
+        print(f"{'flood':<30}{'req/s':>9}{'p50 ms':>9}{'p99 ms':>9}{'cpu us/req':>12}{'cpu':>10}   statuses")
+        run("baseline: /health, keep-alive", health, True, process.pid)
+        run("429: over rate, body unread", over_rate, True, process.pid)
+        run("413: oversized Content-Length", oversized, False, process.pid)
+    finally:
+        process.terminate()
+        process.wait()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,73 @@
+"""
+REPL latency benchmark
+Feeds a long interactive session (a function and a few statements per round) to
+the incremental REPL and reports per-entry latency early and late in the session,
+next to the old approach of recompiling the whole accumulated program per entry.
+"""
+
+import time
+
+from bench_common import compile_to_python, run_generated
+from repl import ReplSession
+
+ROUNDS = 100
+WINDOW = 50
+
+
+def session_entries(rounds: int):
+    """Entries of a session that keeps adding functions and globals"""
+    yield "#include <iostream>"
+    yield "using namespace std;"
+    yield "int total = 0;"
+    for i in range(rounds):
+        yield f"int f{i}(int x) {{ return x * {i % 7 + 1} + {i}; }}"
+        yield f"int v{i} = f{i}({i});"
+        yield f"total = total + v{i};"
+        yield f'cout << "v{i} = " << v{i} << endl;'
+
+
+def time_incremental(entries):
+    """Latency of each entry in one persistent session"""
+    session = ReplSession()
+    latencies = []
+    for entry in entries:
+        start = time.perf_counter()
+        session.execute(entry)
+        latencies.append(time.perf_counter() - start)
+    return latencies
+
+
+def time_rebuild(entries):
+    """Latency of each entry when the whole session is recompiled and rerun"""
+    declarations, statements = [], []
+    latencies = []
+    for entry in entries:
+        start = time.perf_counter()
+        if entry.startswith(('#', 'using', 'int f')):
+            declarations.append(entry)
+        else:
+            statements.append(entry)
+        program = "\n".join(declarations) + "\nint main() {\n" + "\n".join(statements) + "\nreturn 0;\n}\n"
+        run_generated(compile_to_python(program))
+        latencies.append(time.perf_counter() - start)
+    return latencies
+
+
+def summarize(name: str, latencies):
+    """Print mean latency of the first and last windows of entries"""
+    first = sum(latencies[:WINDOW]) / WINDOW * 1000
+    last = sum(latencies[-WINDOW:]) / WINDOW * 1000
+    print(f"{name:<22}{first:>12.3f}{last:>12.3f}{sum(latencies):>12.2f}")
+
+
+def main():
+    entries = list(session_entries(ROUNDS))
+    print(f"REPL session of {len(entries)} entries")
+    print(f"{'approach':<22}{'first ms':>12}{'last ms':>12}{'total s':>12}")
+    summarize("incremental session", time_incremental(entries))
+    # Globals like total become locals of main in the rebuilt program
+    summarize("recompile everything", time_rebuild(entries))
+
+
+if __name__ == "__main__":
+    main()
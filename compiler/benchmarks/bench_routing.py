@@ -0,0 +1,57 @@
+"""
+Engine routing benchmark
+Runs every program in examples/ and production_tests/ through the production
+compiler, reporting the feature prescan cost, the engine each program was routed
+to, and wall time and success against always using the custom pipeline.
+"""
+
+import time
+from pathlib import Path
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from lexer import Lexer
+from production_compiler import ProductionCppCompiler, scan_features
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+CORPORA = ["examples", "production_tests"]
+
+
+def timed(func):
+    """Return (result, elapsed seconds) of func()"""
+    start = time.perf_counter()
+    result = func()
+    return result, time.perf_counter() - start
+
+
+def main():
+    compiler = ProductionCppCompiler()
+    print(f"g++ available: {compiler.gpp_available}")
+    print(f"{'program':<34}{'scan us':>9}  {'engine':<7}{'routed ms':>11}{'ok':>4}"
+          f"{'custom ms':>11}{'ok':>4}")
+
+    totals = {'routed': 0.0, 'custom': 0.0, 'routed_ok': 0, 'custom_ok': 0, 'programs': 0}
+    for corpus in CORPORA:
+        for source_file in sorted((BASE_DIR / corpus).glob("*.cpp")):
+            source_code = source_file.read_text()
+            tokens = Lexer(source_code).tokenize()
+            _, scan_time = timed(lambda: scan_features(tokens))
+
+            routed, routed_time = timed(lambda: compiler.compile_program(source_code, source_file.name))
+            (custom_ok, _, _), custom_time = timed(
+                lambda: compiler._compile_with_custom_compiler(source_code, source_file.name, True))
+
+            totals['programs'] += 1
+            totals['routed'] += routed_time
+            totals['custom'] += custom_time
+            totals['routed_ok'] += routed['success']
+            totals['custom_ok'] += custom_ok
+            print(f"{corpus + '/' + source_file.name:<34}{scan_time * 1e6:>9.0f}  {routed['engine']:<7}"
+                  f"{routed_time * 1000:>11.1f}{'yes' if routed['success'] else 'no':>4}"
+                  f"{custom_time * 1000:>11.1f}{'yes' if custom_ok else 'no':>4}")
+
+    print(f"\nrouted: {totals['routed_ok']}/{totals['programs']} succeeded in {totals['routed']:.2f} s")
+    print(f"custom only: {totals['custom_ok']}/{totals['programs']} succeeded in {totals['custom']:.2f} s")
+
+
+if __name__ == "__main__":
+    main()
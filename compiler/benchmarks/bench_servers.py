@@ -0,0 +1,166 @@
+"""
+API server load test
+Starts the Flask API (`main.py --api`) and the asyncio API (`async_server.py`) as
+subprocesses and drives both with the same asyncio HTTP client: /compile
+throughput and latency at several concurrency levels, then /health latency while
+a large number of idle connections are held open.
+"""
+
+import asyncio
+import json
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+BASE_DIR = Path(__file__).resolve().parent.parent
+HOST = '127.0.0.1'
+FLASK_PORT = 5101
+ASYNC_PORT = 5102
+WORKERS = os.cpu_count() or 1
+
+CONCURRENCY = [1, 8, 32]
+REQUESTS_PER_LEVEL = 200
+IDLE_CONNECTIONS = 1000
+HEALTH_PROBES = 100
+
+PROGRAM = """#include <iostream>
+using namespace std;
+int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }
+int main() {
+    int total = 0;
+    for (int i = 0; i < 15; i++) { total = total + fib(i); }
+    cout << "total = " << total << endl;
+    return 0;
+}
+"""
+
+
+async def request(port: int, method: str, path: str, payload=None) -> int:
+    """Send one request on a fresh connection and return the status code"""
+    reader, writer = await asyncio.open_connection(HOST, port)
+    body = json.dumps(payload).encode() if payload is not None else b''
+    writer.write((f"{method} {path} HTTP/1.1\r\nHost: {HOST}\r\nConnection: close\r\n"
+                  f"Content-Type: application/json\r\nContent-Length: {len(body)}\r\n\r\n").encode() + body)
+    await writer.drain()
+    response = await reader.read()
+    writer.close()
+    return int(response.split(b' ', 2)[1])
+
+
+def percentile(samples, fraction: float) -> float:
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * fraction))]
+
+
+async def compile_load(port: int, concurrency: int):
+    """Throughput (req/s) and p50/p99 latency (ms) of /compile"""
+    latencies = []
+    failures = 0
+    remaining = REQUESTS_PER_LEVEL
+
+    async def client():
+        nonlocal remaining, failures
+        while remaining > 0:
+            remaining -= 1
+            start = time.perf_counter()
+            try:
+                status = await request(port, 'POST', '/compile', {'code': PROGRAM})
+            except OSError:
+                status = 0
+            latencies.append(time.perf_counter() - start)
+            failures += status != 200
+
+    start = time.perf_counter()
+    await asyncio.gather(*(client() for _ in range(concurrency)))
+    elapsed = time.perf_counter() - start
+    return (len(latencies) / elapsed, percentile(latencies, 0.5) * 1000,
+            percentile(latencies, 0.99) * 1000, failures)
+
+
+async def idle_load(port: int):
+    """/health latency while IDLE_CONNECTIONS clients are connected but silent"""
+    idle = []
+    for _ in range(IDLE_CONNECTIONS):
+        try:
+            idle.append(await asyncio.open_connection(HOST, port))
+        except OSError:
+            break
+    await asyncio.sleep(0.5)
+
+    latencies = []
+    failures = 0
+    for _ in range(HEALTH_PROBES):
+        start = time.perf_counter()
+        try:
+            status = await asyncio.wait_for(request(port, 'GET', '/health'), 5)
+        except (OSError, asyncio.TimeoutError):
+            status = 0
+        latencies.append(time.perf_counter() - start)
+        failures += status != 200
+
+    for _, writer in idle:
+        writer.close()
+    return len(idle), percentile(latencies, 0.5) * 1000, percentile(latencies, 0.99) * 1000, failures
+
+
+def resident_mb(pid: int) -> float:
+    """Resident memory of a process and its children, in MB"""
+    total = 0
+    pids = [pid]
+    children = Path(f"/proc/{pid}/task/{pid}/children")
+    if children.exists():
+        pids += [int(child) for child in children.read_text().split()]
+    for process in pids:
+        for line in Path(f"/proc/{process}/status").read_text().splitlines():
+            if line.startswith('VmRSS:'):
+                total += int(line.split()[1])
+    return total / 1024
+
+
+def start_server(command, port: int, **environment) -> subprocess.Popen:
+    """Launch a server and wait until /health answers"""
+    # The load comes from one client address, so per-client rate limiting is off
+    env = dict(os.environ, PORT=str(port), RATE_LIMIT_RPS='0')
+    env.update(environment)
+    process = subprocess.Popen(command, cwd=BASE_DIR, env=env,
+                               stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    deadline = time.time() + 30
+    while time.time() < deadline:
+        try:
+            if asyncio.run(request(port, 'GET', '/health')) == 200:
+                return process
+        except OSError:
+            time.sleep(0.2)
+    process.kill()
+    raise RuntimeError(f"server {command} did not start")
+
+
+def run_server(name: str, command, port: int):
+    process = start_server(command, port)
+    try:
+        print(f"\n{name}")
+        print(f"{'clients':>9}{'req/s':>10}{'p50 ms':>10}{'p99 ms':>10}{'failed':>8}")
+        for concurrency in CONCURRENCY:
+            throughput, p50, p99, failures = asyncio.run(compile_load(port, concurrency))
+            print(f"{concurrency:>9}{throughput:>10.1f}{p50:>10.1f}{p99:>10.1f}{failures:>8}")
+        held, p50, p99, failures = asyncio.run(idle_load(port))
+        print(f"/health with {held} idle connections: p50 {p50:.1f} ms, p99 {p99:.1f} ms, "
+              f"{failures} failed")
+        print(f"resident memory: {resident_mb(process.pid):.0f} MB")
+    finally:
+        process.terminate()
+        process.wait()
+
+
+def main():
+    print(f"/compile load: {REQUESTS_PER_LEVEL} requests per concurrency level, "
+          f"async server with {WORKERS} workers")
+    run_server("Flask (threaded dev server)", [sys.executable, 'main.py', '--api'], FLASK_PORT)
+    run_server("asyncio + process pool",
+               [sys.executable, 'async_server.py', '--host', HOST, '--workers', str(WORKERS)], ASYNC_PORT)
+
+
+if __name__ == "__main__":
+    main()
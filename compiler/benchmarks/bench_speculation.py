@@ -0,0 +1,132 @@
+"""
+Speculative pre-compilation benchmark
+Models students who edit, pause, and sometimes tap Run. With speculation,
+each pause submits the buffer with "speculative": true, as the app does once
+typing stops. A Run on unchanged code then uses that result, waiting for it
+if it is still in flight. A Run is a normal /compile when speculation is off,
+or when the server skipped the pre-compile because no worker was idle.
+
+Reports perceived Run latency and the extra server load: how many compiles
+the server ran per Run, from the scheduler's granted counts. Both are shown
+for students taking turns on an idle server, and for a class of CLASS_SIZE
+students working at once on WORKERS workers.
+"""
+
+import asyncio
+import json
+import random
+import sys
+import time
+
+import bench_common  # noqa: F401  (puts the compiler modules on sys.path)
+from bench_servers import HOST, percentile, start_server
+
+PORT = 5111
+WORKERS = 2
+PAUSES = 20
+CLASS_SIZE = 8
+RUN_PROBABILITY = 0.4
+# Seconds a student thinks before tapping Run, or keeps typing after a pause
+THINK = (0.2, 1.2)
+TYPING = (0.3, 1.0)
+
+PROGRAM = """#include <iostream>
+using namespace std;
+int main() {
+    long total = 0;
+    for (int i = 0; i < 300000; i++) {
+        total = total + i % %d;
+    }
+    cout << total << endl;
+    return 0;
+}
+"""
+
+
+async def post(payload: dict) -> tuple:
+    """(status, X-Speculative header, body) of one /compile"""
+    body = json.dumps(payload).encode('utf-8')
+    reader, writer = await asyncio.open_connection(HOST, PORT)
+    writer.write((f"POST /compile HTTP/1.1\r\nHost: {HOST}\r\nConnection: close\r\n"
+                  f"Content-Type: application/json\r\nContent-Length: {len(body)}\r\n\r\n").encode() + body)
+    response = await reader.read()
+    writer.close()
+    head, _, content = response.partition(b'\r\n\r\n')
+    speculative = None
+    for line in head.split(b'\r\n'):
+        if line.lower().startswith(b'x-speculative:'):
+            speculative = line.split(b':', 1)[1].strip().decode()
+    return int(head.split(b' ', 2)[1]), speculative, json.loads(content)
+
+
+async def server_info() -> dict:
+    reader, writer = await asyncio.open_connection(HOST, PORT)
+    writer.write(f"GET /server-info HTTP/1.1\r\nHost: {HOST}\r\nConnection: close\r\n\r\n".encode())
+    response = await reader.read()
+    writer.close()
+    return json.loads(response.partition(b'\r\n\r\n')[2])
+
+
+async def student(number: int, speculate: bool, latencies: list, outcomes: dict):
+    rng = random.Random(number)
+    for pause in range(PAUSES):
+        # Every pause leaves a program the server has not seen
+        code = PROGRAM.replace('%d', str(7 + number * PAUSES + pause))
+        speculation = asyncio.ensure_future(post({"code": code, "speculative": True})) if speculate else None
+        if rng.random() >= RUN_PROBABILITY:
+            await asyncio.sleep(rng.uniform(*TYPING))
+            continue
+        await asyncio.sleep(rng.uniform(*THINK))
+
+        start = time.perf_counter()
+        result = None
+        if speculation is not None:
+            outcome = 'ready' if speculation.done() else 'in flight'
+            status, state, body = await speculation
+            if state in ('compiled', 'cached'):
+                result = body
+            else:
+                outcome = state
+            outcomes[outcome] = outcomes.get(outcome, 0) + 1
+        if result is None:
+            status, state, result = await post({"code": code})
+        latencies.append(time.perf_counter() - start)
+        assert result['success'], result
+
+
+async def classroom(together: bool, speculate: bool) -> tuple:
+    before = (await server_info())['scheduler']['classes']
+    latencies, outcomes = [], {}
+    if together:
+        await asyncio.gather(*(student(number, speculate, latencies, outcomes) for number in range(CLASS_SIZE)))
+    else:
+        for number in range(CLASS_SIZE):
+            await student(number, speculate, latencies, outcomes)
+    # Let pre-compiles nobody waited for finish before counting
+    await asyncio.sleep(1.0)
+    after = (await server_info())['scheduler']['classes']
+    compiles = sum(after[name]['granted'] - before[name]['granted'] for name in after)
+    return latencies, outcomes, compiles
+
+
+def main():
+    print(f"{PAUSES} pauses per student, Run after {RUN_PROBABILITY:.0%} of them; {WORKERS} workers")
+    print(f"{'scenario':<30}{'runs':>6}{'p50 ms':>9}{'p95 ms':>9}{'compiles/run':>14}  pre-compile at Run")
+    for together in (False, True):
+        for speculate in (False, True):
+            # A fresh server each time, so no result from an earlier scenario answers
+            process = start_server([sys.executable, 'async_server.py', '--host', HOST, '--port', str(PORT),
+                                    '--workers', str(WORKERS)], PORT)
+            try:
+                latencies, outcomes, compiles = asyncio.run(classroom(together, speculate))
+            finally:
+                process.terminate()
+                process.wait()
+            name = f"{'together' if together else 'one at a time'}, {'speculation' if speculate else 'plain'}"
+            summary = ", ".join(f"{count} {outcome}" for outcome, count in sorted(outcomes.items())) or "-"
+            print(f"{name:<30}{len(latencies):>6}{percentile(latencies, 0.5) * 1000:>9.1f}"
+                  f"{percentile(latencies, 0.95) * 1000:>9.1f}{compiles / len(latencies):>14.2f}  {summary}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+"""
+Struct layout benchmark
+Builds 1M instances of a small generated struct and reports memory per instance
+and field access / copy speed, comparing the generated __slots__ layout with the
+same class backed by a per-instance __dict__.
+"""
+
+import gc
+import time
+import tracemalloc
+
+from bench_common import compile_to_python, run_generated, best_of
+
+COUNT = 1000000
+
+STRUCT_PROGRAM = """#include <iostream>
+using namespace std;
+
+struct Particle {
+    int id;
+    double x;
+    double y;
+};
+
+int main() {
+    Particle p = {1, 0.5, 0.25};
+    double total = 0.0;
+    for (int i = 0; i < 200000; i = i + 1) {
+        p.x = p.x + 1.0;
+        total = total + p.x * p.y;
+    }
+    cout << total << endl;
+    return 0;
+}
+"""
+
+
+def load_struct_classes():
+    """Return the generated Particle class and an equivalent __dict__-backed class"""
+    namespace = {'__name__': 'bench_structs_generated'}
+    generated = compile_to_python(STRUCT_PROGRAM)
+    exec(generated, namespace)
+    slotted = namespace['Particle']
+    
+    body = {name: value for name, value in vars(slotted).items()
+            if name not in ('__slots__', '__dict__', '__weakref__') and name not in slotted.__slots__}
+    dict_backed = type('ParticleDict', (), body)
+    return slotted, dict_backed, generated
+
+
+def measure_layout(cls):
+    gc.collect()
+    tracemalloc.start()
+    before = tracemalloc.get_traced_memory()[0]
+    items = [cls(i, 0.5, 0.25) for i in range(COUNT)]
+    after = tracemalloc.get_traced_memory()[0]
+    tracemalloc.stop()
+    
+    def read_fields():
+        total = 0.0
+        for p in items:
+            total += p.x
+        return total
+    
+    def write_fields():
+        for p in items:
+            p.x = p.x + 1.0
+    
+    def copy_all():
+        # _cpp_copy always builds the generated class, so only time it there
+        return [p._cpp_copy() for p in items[:COUNT // 10]]
+    
+    return {
+        'bytes': (after - before) / COUNT,
+        'read': best_of(read_fields, repeat=3),
+        'write': best_of(write_fields, repeat=3),
+        'copy': best_of(copy_all, repeat=3) * 10 if '__slots__' in vars(cls) else None,
+    }
+
+
+def main():
+    slotted, dict_backed, generated = load_struct_classes()
+    print(f"{COUNT} x Particle {{int id; double x; double y;}}")
+    print(f"{'layout':<12}{'bytes/inst':>12}{'read (ns)':>12}{'write (ns)':>12}{'copy (ns)':>12}")
+    for name, cls in [("__slots__", slotted), ("__dict__", dict_backed)]:
+        result = measure_layout(cls)
+        print(f"{name:<12}{result['bytes']:>12.1f}"
+              f"{result['read'] / COUNT * 1e9:>12.1f}"
+              f"{result['write'] / COUNT * 1e9:>12.1f}"
+              + (f"{result['copy'] / COUNT * 1e9:>12.1f}" if result['copy'] is not None else f"{'-':>12}"))
+    
+    start = time.perf_counter()
+    run_generated(generated)
+    print(f"\nIn-language field update loop (200k iterations): {time.perf_counter() - start:.3f}s")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,69 @@
+"""
+Switch dispatch benchmark
+Runs a small bytecode-interpreter style loop whose body dispatches on an opcode,
+comparing the dense (index table) and sparse (dict) switch lowerings against the
+equivalent if / else-if chain.
+"""
+
+from bench_common import compile_to_python, run_generated, best_of
+
+STEPS = 200000
+OPCODES = 16
+
+
+def opcode_bodies():
+    """One small statement per opcode, so dispatch dominates the loop cost"""
+    return [f"acc = acc + {op + 1};" if op % 2 == 0 else f"acc = acc - {op};"
+            for op in range(OPCODES)]
+
+
+def interpreter_program(dispatch: str, label_scale: int = 1) -> str:
+    bodies = opcode_bodies()
+    if dispatch == 'switch':
+        cases = "\n".join(f"            case {op * label_scale}: {body} break;"
+                          for op, body in enumerate(bodies))
+        dispatch_code = f"        switch (op) {{\n{cases}\n        }}"
+    else:
+        branches = []
+        for op, body in enumerate(bodies):
+            keyword = "if" if op == 0 else "} else if"
+            branches.append(f"        {keyword} (op == {op * label_scale}) {{ {body}")
+        dispatch_code = "\n".join(branches) + "\n        }"
+    
+    return f"""#include <iostream>
+using namespace std;
+
+int main() {{
+    int acc = 0;
+    for (int step = 0; step < {STEPS}; step = step + 1) {{
+        int op = ((step * 7) % {OPCODES}) * {label_scale};
+{dispatch_code}
+    }}
+    cout << acc << endl;
+    return 0;
+}}
+"""
+
+
+def main():
+    print(f"Interpreter dispatch: {STEPS} steps over {OPCODES} opcodes")
+    print(f"{'variant':<28}{'total (s)':>12}{'ns/dispatch':>14}")
+    
+    results = {}
+    for name, dispatch, scale in [
+        ("if/else chain (dense)", 'if', 1),
+        ("switch (dense -> table)", 'switch', 1),
+        ("if/else chain (sparse)", 'if', 37),
+        ("switch (sparse -> dict)", 'switch', 37),
+    ]:
+        code = compile_to_python(interpreter_program(dispatch, scale))
+        results[name] = run_generated(code)
+        elapsed = best_of(lambda: run_generated(code), repeat=3)
+        print(f"{name:<28}{elapsed:>12.3f}{elapsed / STEPS * 1e9:>14.0f}")
+    
+    if len(set(results.values())) != 1:
+        print("WARNING: variants produced different output")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,83 @@
+"""
+Call-graph tree shaking benchmark
+A library-style submission: HELPERS helper functions, of which main calls
+USED. Times semantic analysis, code generation and Python's compile of the
+generated program, and compares:
+- main calling every helper, where nothing can be pruned (the cost of every
+  submission before tree shaking)
+- main calling USED helpers, where the rest are not generated
+- the same with fast_analysis, where the rest are not analyzed either
+"""
+
+from bench_common import best_of
+
+from compilation_context import CompilationContext
+from lexer import Lexer
+from parser import Parser
+from semantic_analyzer import SemanticAnalyzer
+from code_generator import CodeGenerator
+
+HELPERS = 60
+USED = 3
+ROUNDS = 10
+
+
+def helper(number: int) -> str:
+    return f"""long helper{number}(long n) {{
+    long acc = {number};
+    for (int i = 0; i < n; i++) {{
+        if (i % 3 == 0) {{
+            acc = acc + i * {number + 1};
+        }} else {{
+            acc = acc - i / 2;
+        }}
+        int k = 0;
+        while (k < 2) {{
+            k++;
+            acc = acc * 3 % 1000003;
+        }}
+    }}
+    return acc;
+}}
+"""
+
+
+def library_program(used: int) -> str:
+    helpers = "\n".join(helper(number) for number in range(HELPERS))
+    calls = "\n".join(f"    total = total + helper{number}(10);" for number in range(used))
+    return (f"#include <iostream>\nusing namespace std;\n\n{helpers}\n"
+            f"int main() {{\n    long total = 0;\n{calls}\n    cout << total << endl;\n    return 0;\n}}\n")
+
+
+def measure(source_code: str, context: CompilationContext) -> tuple:
+    """(ms to analyze, generate and compile, generated lines, pruned functions)"""
+    ast = Parser(Lexer(source_code).tokenize()).parse()
+    result = {}
+
+    def translate():
+        analyzer = SemanticAnalyzer(context)
+        if not analyzer.analyze(ast):
+            raise RuntimeError("Semantic errors:\n" + "\n".join(analyzer.errors))
+        generator = CodeGenerator(analyzer, context)
+        result['code'] = generator.generate(ast)
+        result['pruned'] = len(generator.call_graph.unreachable())
+        compile(result['code'], context.filename, 'exec')
+    seconds = best_of(translate, ROUNDS)
+    return seconds * 1000, result['code'].count("\n"), result['pruned']
+
+
+def main():
+    print(f"{HELPERS} helper functions, best of {ROUNDS}")
+    print(f"{'scenario':<34}{'ms':>8}{'lines':>8}{'pruned':>8}")
+    scenarios = (
+        (f"main calls all {HELPERS}", library_program(HELPERS), CompilationContext()),
+        (f"main calls {USED}", library_program(USED), CompilationContext()),
+        (f"main calls {USED}, fast_analysis", library_program(USED), CompilationContext(fast_analysis=True)),
+    )
+    for name, source_code, context in scenarios:
+        ms, lines, pruned = measure(source_code, context)
+        print(f"{name:<34}{ms:>8.2f}{lines:>8}{pruned:>8}")
+
+
+if __name__ == "__main__":
+    main()
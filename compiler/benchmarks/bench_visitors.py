@@ -0,0 +1,103 @@
+"""
+AST visitor dispatch benchmark
+Times the semantic analyzer and the code generator on a synthetic program of
+about 100k AST nodes that uses every statement and expression kind, so that
+per-node dispatch dominates the passes. Parsing is done once outside the timed
+region.
+"""
+
+from bench_common import best_of
+
+from lexer import Lexer
+from parser import Parser, walk
+from semantic_analyzer import SemanticAnalyzer
+from code_generator import CodeGenerator
+
+FUNCTIONS = 600
+ROUNDS = 5
+
+STRUCT = """struct Counter {
+    int count;
+    long total;
+    void add(int value) {
+        count++;
+        total = total + value;
+    }
+    long mean() {
+        if (count == 0) {
+            return 0;
+        }
+        return total / count;
+    }
+};
+"""
+
+
+def function(number: int) -> str:
+    return f"""long work{number}(int n, long seed) {{
+    Counter counter;
+    counter.count = 0;
+    counter.total = seed;
+    long acc = seed % {number + 3};
+    for (int i = 0; i < n; i++) {{
+        int x = (i * {number + 1} + 7) % 13;
+        if (x > 6 && !(x == 9)) {{
+            acc = acc + x * 2 - (i % 3);
+        }} else if (x < 2 || x == 4) {{
+            acc = acc - x;
+            continue;
+        }} else {{
+            counter.add(x);
+        }}
+        switch (x % 4) {{
+            case 0: acc = acc + 1; break;
+            case 1: acc = acc - 2; break;
+            default: acc = acc * 1;
+        }}
+        int k = 0;
+        while (k < 3) {{
+            k++;
+            if (k == x) {{
+                break;
+            }}
+        }}
+        double ratio = acc / 3.0;
+        bool big = ratio > 100.5;
+        if (big) {{
+            acc = acc % 1000;
+        }}
+    }}
+    return acc + counter.mean() + counter.count;
+}}
+"""
+
+
+def synthetic_program() -> str:
+    functions = "\n".join(function(number) for number in range(FUNCTIONS))
+    calls = "\n".join(f"    total = total + work{number}(5, total % 17);" for number in range(FUNCTIONS))
+    return (f"#include <iostream>\nusing namespace std;\n\n{STRUCT}\n{functions}\n"
+            f"int main() {{\n    long total = 0;\n{calls}\n    cout << \"total \" << total << endl;\n    return 0;\n}}\n")
+
+
+def main():
+    ast = Parser(Lexer(synthetic_program()).tokenize()).parse()
+    nodes = sum(1 for _ in walk(ast))
+    analyzer = SemanticAnalyzer()
+    if not analyzer.analyze(ast):
+        raise RuntimeError("Semantic errors:\n" + "\n".join(analyzer.errors))
+
+    def analyze():
+        SemanticAnalyzer().analyze(ast)
+
+    def generate():
+        CodeGenerator(analyzer).generate(ast)
+
+    print(f"{nodes} AST nodes, best of {ROUNDS}")
+    print(f"{'pass':<20}{'ms':>10}{'ns/node':>10}")
+    for name, run in (("semantic analysis", analyze), ("code generation", generate)):
+        seconds = best_of(run, ROUNDS)
+        print(f"{name:<20}{seconds * 1000:>10.1f}{seconds * 1e9 / nodes:>10.0f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,978 @@
+"""
+Closure Compiler
+An execution engine that turns the analyzed AST straight into nested Python
+closures instead of generating Python source: each node becomes a callable
+that captures its children's callables. Building the closures is one pass
+over the AST, so small programs skip code generation and Python's compile of
+the generated module, which cost more than running them. Loops run several
+times slower than compiled code, so with engine "auto" choose_engine picks
+closures only when the program's estimated work is small.
+
+Programs mean what they mean under the code generator: the same conversions,
+wraparound (decided by the same RangeAnalysis), runtime helpers and cout
+formatting. Variables live in a list per call, at slots fixed when the
+closures are built; block-scoped declarations each get their own slot.
+Statements return None to fall through, or BREAK, CONTINUE or RETURN (with
+the value in slot 0) to leave enclosing statements.
+
+Constructs the engine does not handle raise ClosureUnsupported while
+building; callers then run the program on the exec engine instead. A built
+ClosureProgram is not reentrant: runs of one program must not overlap.
+"""
+
+import math
+import re
+import struct
+import sys
+from operator import attrgetter
+from typing import Callable, Dict, List, Optional, Tuple
+
+from parser import *
+from semantic_analyzer import SemanticAnalyzer
+from code_generator import CodeGenerator, INTEGER_WRAP_MASKS, round_to_float32
+from range_analysis import INTEGER_RANGES, RangeAnalysis
+from call_graph import CallGraph
+from compilation_context import CompilationContext
+from intrinsics import Intrinsic
+from visitor import Visitor, handles
+
+# Statement results that leave enclosing statements
+BREAK = 'break'
+CONTINUE = 'continue'
+RETURN = 'return'
+
+# With engine "auto", closures run programs whose estimated executed AST
+# nodes are at most this many per node of source; beyond it the faster
+# execution of compiled code repays code generation and compile
+AUTO_WORK_PER_NODE = 60.0
+# Trip count assumed for loops whose bounds are not constant
+UNBOUNDED_TRIPS = 1000
+
+def runtime_namespace() -> dict:
+    """The generated programs' runtime support, executed once for its helpers"""
+    generator = CodeGenerator(SemanticAnalyzer())
+    generator.emit_runtime_support()
+    namespace = {'math': math, 're': re, 'struct': struct, 'sys': sys}
+    exec("\n".join(generator.output), namespace)
+    return namespace
+
+RUNTIME = runtime_namespace()
+cpp_float32 = RUNTIME['cpp_float32']
+cpp_idiv = RUNTIME['cpp_idiv']
+cpp_imod = RUNTIME['cpp_imod']
+cpp_fdiv = RUNTIME['cpp_fdiv']
+CppInput = RUNTIME['CppInput']
+
+# Intrinsic implementations by (name, pow exponent strength-reduced)
+intrinsic_functions: Dict[Tuple[str, bool], Callable] = {}
+
+class ClosureUnsupported(Exception):
+    """The program uses a construct the closure engine does not implement"""
+
+class ClosureProgram:
+    """A program built into closures, run with run()"""
+
+    def __init__(self, compiler: 'ClosureCompiler', initializers: List[Callable], main: Optional[list]):
+        self.compiler = compiler
+        self.initializers = initializers
+        self.main = main
+
+    def run(self, output_buffer, input_text: str = '') -> int:
+        """Run the program on input_text, appending its output to output_buffer; returns main's result"""
+        compiler = self.compiler
+        compiler.write[0] = output_buffer.append
+        compiler.input[0] = CppInput(input_text)
+        compiler.globals[:] = [None] * len(compiler.globals)
+        for initializer in self.initializers:
+            initializer()
+        if self.main is None:
+            output_buffer.append("No main function found\n")
+            return 1
+        return self.main[0]()
+
+class ClassLayout:
+    """How objects of one class/struct are made, copied and called"""
+
+    def __init__(self, node: ClassDeclaration):
+        self.node = node
+        self.python_class = type(node.name, (), {'__slots__': tuple(member.name for member in node.members)})
+        self.member_names = {member.name for member in node.members}
+        # Method name -> one-element list holding the built function
+        self.methods: Dict[str, list] = {method.name: [None] for method in node.methods}
+        self.construct: Optional[Callable] = None
+        self.copy: Optional[Callable] = None
+
+class ClosureCompiler(Visitor):
+    """Builds a ClosureProgram from an analyzed AST"""
+
+    def __init__(self, semantic_analyzer: SemanticAnalyzer, context: Optional[CompilationContext] = None):
+        self.analyzer = semantic_analyzer
+        self.context = context or semantic_analyzer.context
+        self.ranges = RangeAnalysis()
+        self.call_graph: Optional[CallGraph] = None
+
+        # Free functions by name, as one-element lists so calls can be built
+        # before (or while) the callee is
+        self.functions: Dict[str, list] = {}
+        self.classes: Dict[str, ClassLayout] = {}
+
+        # Global variables: slots in one list shared by every closure
+        self.global_slots: Dict[str, int] = {}
+        self.globals: list = []
+        # The append of the running program's output buffer
+        self.write: list = [None]
+        # cin of the running program
+        self.input: list = [None]
+
+        # State of the function being built
+        self.scopes: List[Dict[str, int]] = []
+        self.slot_count = 0
+        self.current_class: Optional[ClassLayout] = None
+        self.this_slot: Optional[int] = None
+
+    def build(self, program: Program) -> ClosureProgram:
+        """Build the closures of every declaration that main can reach"""
+        self.ranges.collect_program(program)
+        self.call_graph = self.analyzer.call_graph or CallGraph(program)
+        initializers = []
+        for declaration in program.declarations:
+            if type(declaration) is FunctionDeclaration and not self.call_graph.is_reachable(declaration.name):
+                continue
+            handler = self.declaration_handlers[type(declaration)]
+            if handler is not None:
+                initializer = handler(self, declaration)
+                if initializer is not None:
+                    initializers.append(initializer)
+        return ClosureProgram(self, initializers, self.functions.get('main'))
+
+    # Declarations
+
+    @handles('declaration', VariableDeclaration)
+    def build_global_variable(self, node: VariableDeclaration) -> Callable:
+        """Allocate a global's slot; returns the closure that initializes it"""
+        self.begin_function(None)
+        value = self.build_initial_value(node)
+        frame_size = self.slot_count
+        slot = self.global_slots[node.name] = len(self.globals)
+        self.globals.append(None)
+        storage = self.globals
+
+        def initialize():
+            storage[slot] = value([None] * frame_size)
+        return initialize
+
+    @handles('declaration', FunctionDeclaration)
+    def build_free_function(self, node: FunctionDeclaration):
+        self.function_cell(node.name)[0] = self.build_function(node)
+
+    @handles('declaration', ClassDeclaration)
+    def build_class(self, node: ClassDeclaration):
+        """Build the constructors, copy and methods of a class/struct"""
+        layout = self.classes[node.name] = ClassLayout(node)
+        python_class = layout.python_class
+        new = object.__new__
+
+        # Member defaults are evaluated with the new object as this
+        self.begin_function(layout)
+        defaults = [(member.name, self.build_initial_value(member)) for member in node.members]
+        frame_size = self.slot_count
+
+        def initialize_members(obj):
+            frame = [None, obj] + [None] * (frame_size - 2)
+            for name, default in defaults:
+                setattr(obj, name, default(frame))
+
+        if not node.constructors:
+            # Aggregate: positional arguments initialize the leading members
+            names = [member.name for member in node.members]
+
+            def construct(*args):
+                obj = new(python_class)
+                initialize_members(obj)
+                for name, value in zip(names, args):
+                    setattr(obj, name, value)
+                return obj
+        else:
+            # Overloads are resolved by argument count
+            constructors = {len(ctor.parameters): self.build_function(ctor, layout) for ctor in node.constructors}
+
+            def construct(*args):
+                obj = new(python_class)
+                initialize_members(obj)
+                constructors[len(args)](obj, *args)
+                return obj
+        layout.construct = construct
+
+        # Value-semantics copy; nested objects are copied too
+        copies = [(member.name, self.classes[member.var_type.name] if member.var_type.name in self.classes else None)
+                  for member in node.members]
+
+        def copy(obj):
+            other = new(python_class)
+            for name, member_layout in copies:
+                value = getattr(obj, name)
+                setattr(other, name, member_layout.copy(value) if member_layout else value)
+            return other
+        layout.copy = copy
+
+        for method in node.methods:
+            layout.methods[method.name][0] = self.build_function(method, layout)
+
+    def function_cell(self, name: str) -> list:
+        return self.functions.setdefault(name, [None])
+
+    def begin_function(self, layout: Optional[ClassLayout]):
+        """Start the slots of a new call frame: 0 holds the return value, then this"""
+        self.current_class = layout
+        self.scopes = [{}]
+        self.slot_count = 1
+        self.this_slot = None
+        if layout is not None:
+            self.this_slot = self.declare('this')
+
+    def declare(self, name: str) -> int:
+        """Give a variable of the innermost scope its slot"""
+        slot = self.scopes[-1][name] = self.slot_count
+        self.slot_count += 1
+        return slot
+
+    def build_function(self, node: FunctionDeclaration, layout: Optional[ClassLayout] = None) -> Callable:
+        """Build a callable taking (this,) then the parameters and returning the C++ result"""
+        self.begin_function(layout)
+        self.ranges.analyze_function(node, layout.node if layout else None)
+        for _, param_name in node.parameters:
+            self.declare(param_name)
+        arity = self.slot_count - 1
+        body = self.build_statement(node.body)
+        padding = (None,) * (self.slot_count - 1 - arity)
+        return_type = node.return_type.name
+        if node.name == 'main' and layout is None:
+            default_result = lambda: 0
+        elif return_type in self.classes:
+            default_result = self.classes[return_type].construct
+        else:
+            default_value = self.default_value(return_type)
+            default_result = lambda: default_value
+
+        def function(*args):
+            frame = [None, *args, *padding]
+            if body(frame) is RETURN:
+                return frame[0]
+            return default_result()
+        return function
+
+    def default_value(self, type_name: str):
+        return {'int': 0, 'long': 0, 'float': 0.0, 'double': 0.0, 'char': '', 'bool': False, 'string': ""}.get(type_name)
+
+    def build_initial_value(self, node: VariableDeclaration) -> Callable:
+        """Closure computing a declared variable's initial value"""
+        type_name = node.var_type.name
+        layout = self.classes.get(type_name)
+        if isinstance(node.initializer, InitializerList):
+            elements = [self.build_expression(element) for element in node.initializer.elements]
+            if layout is not None:
+                return self.build_call(layout.construct, elements)
+            if elements:
+                return elements[0]
+        elif node.initializer is not None:
+            return self.build_expression(node.initializer)
+        if layout is not None:
+            construct = layout.construct
+            if construct is None:
+                raise ClosureUnsupported(f"{type_name} member of itself")
+            return lambda frame: construct()
+        value = self.default_value(type_name)
+        return lambda frame: value
+
+    # Statements
+
+    def build_statement(self, node: Statement) -> Callable:
+        handler = self.statement_handlers[type(node)]
+        if handler is None:
+            raise ClosureUnsupported(f"statement {type(node).__name__}")
+        return handler(self, node)
+
+    def build_statements(self, statements: List[Statement]) -> Callable:
+        """One closure running statements in order until one leaves"""
+        closures = tuple(self.build_statement(statement) for statement in statements)
+        if not closures:
+            return lambda frame: None
+        if len(closures) == 1:
+            return closures[0]
+        if len(closures) == 2:
+            first, second = closures
+
+            def run_two(frame):
+                return first(frame) or second(frame)
+            return run_two
+
+        def run_all(frame):
+            for statement in closures:
+                result = statement(frame)
+                if result is not None:
+                    return result
+        return run_all
+
+    @handles('statement', Block)
+    def build_block(self, node: Block) -> Callable:
+        self.scopes.append({})
+        closure = self.build_statements(node.statements)
+        self.scopes.pop()
+        return closure
+
+    @handles('statement', VariableDeclaration)
+    def build_variable_declaration(self, node: VariableDeclaration) -> Callable:
+        value = self.build_initial_value(node)
+        slot = self.declare(node.name)
+
+        def declare(frame):
+            frame[slot] = value(frame)
+        return declare
+
+    @handles('statement', ExpressionStatement)
+    def build_expression_statement(self, node: ExpressionStatement) -> Callable:
+        expression = node.expression
+        if isinstance(expression, BinaryOperation) and expression.operator == '<<':
+            cout = self.build_cout_chain(expression)
+            if cout is not None:
+                return cout
+        value = self.build_expression(expression)
+
+        def evaluate(frame):
+            value(frame)
+        return evaluate
+
+    def build_cout_chain(self, node: BinaryOperation) -> Optional[Callable]:
+        """Closure writing each << operand of a chain that starts at cout, or None"""
+        args = []
+        current = node
+        while isinstance(current, BinaryOperation) and current.operator == '<<':
+            args.append(current.right)
+            current = current.left
+        if not (isinstance(current, Identifier) and current.name in ('cout', 'std::cout')):
+            return None
+        pieces = tuple(self.build_insertion(arg) for arg in reversed(args))
+        write = self.write
+
+        def cout(frame):
+            append = write[0]
+            for piece in pieces:
+                append(piece(frame))
+        return cout
+
+    def build_insertion(self, arg: Expression) -> Callable:
+        """Closure returning the text one << operand writes, as cout_insertion formats it"""
+        if isinstance(arg, Identifier) and arg.name in ('endl', 'std::endl'):
+            return lambda frame: '\n'
+        if (isinstance(arg, Literal) and arg.type_name == 'string' and arg.converted_type is None
+                and arg.value.startswith('"') and arg.value.endswith('"')):
+            text = arg.value[1:-1]
+            return lambda frame: text
+        value = self.build_expression(arg)
+        arg_type = arg.converted_type or arg.static_type
+        if arg_type in ('int', 'long', 'bool'):
+            return lambda frame: '%d' % value(frame)
+        if arg_type in ('float', 'double'):
+            return lambda frame: '%g' % value(frame)
+        return lambda frame: generic_insertion(value(frame))
+
+    @handles('statement', IfStatement)
+    def build_if_statement(self, node: IfStatement) -> Callable:
+        condition = self.build_expression(node.condition)
+        then_branch = self.build_scoped(node.then_stmt)
+        if node.else_stmt is None:
+            def run_if(frame):
+                if condition(frame):
+                    return then_branch(frame)
+            return run_if
+        else_branch = self.build_scoped(node.else_stmt)
+
+        def run_if_else(frame):
+            if condition(frame):
+                return then_branch(frame)
+            return else_branch(frame)
+        return run_if_else
+
+    def build_scoped(self, node: Statement) -> Callable:
+        """Build a branch or loop body, whose declarations are local to it"""
+        self.scopes.append({})
+        closure = self.build_statement(node)
+        self.scopes.pop()
+        return closure
+
+    @handles('statement', WhileStatement)
+    def build_while_statement(self, node: WhileStatement) -> Callable:
+        return self.build_loop(node.condition, node.body, None)
+
+    @handles('statement', ForStatement)
+    def build_for_statement(self, node: ForStatement) -> Callable:
+        self.scopes.append({})
+        init = self.build_statement(node.init) if node.init else None
+        loop = self.build_loop(node.condition, node.body, node.update)
+        self.scopes.pop()
+        if init is None:
+            return loop
+
+        def run_for(frame):
+            init(frame)
+            return loop(frame)
+        return run_for
+
+    def build_loop(self, condition_node: Optional[Expression], body_node: Statement,
+                   update_node: Optional[Expression]) -> Callable:
+        condition = self.build_expression(condition_node) if condition_node else (lambda frame: True)
+        body = self.build_scoped(body_node)
+        if update_node is None:
+            def run_loop(frame):
+                while condition(frame):
+                    result = body(frame)
+                    if result is not None and result is not CONTINUE:
+                        if result is BREAK:
+                            return None
+                        return result
+            return run_loop
+        update = self.build_expression(update_node)
+
+        def run_counted_loop(frame):
+            while condition(frame):
+                result = body(frame)
+                if result is not None and result is not CONTINUE:
+                    if result is BREAK:
+                        return None
+                    return result
+                update(frame)
+        return run_counted_loop
+
+    @handles('statement', ReturnStatement)
+    def build_return_statement(self, node: ReturnStatement) -> Callable:
+        if node.expression is None:
+            return lambda frame: RETURN
+        value = self.build_expression(node.expression)
+
+        def run_return(frame):
+            frame[0] = value(frame)
+            return RETURN
+        return run_return
+
+    @handles('statement', BreakStatement)
+    def build_break_statement(self, node: BreakStatement) -> Callable:
+        return lambda frame: BREAK
+
+    @handles('statement', ContinueStatement)
+    def build_continue_statement(self, node: ContinueStatement) -> Callable:
+        return lambda frame: CONTINUE
+
+    @handles('statement', SwitchStatement)
+    def build_switch_statement(self, node: SwitchStatement) -> Callable:
+        """Run the case statements as one list from the matching label's position
+
+        Falling through is running on; break ends the switch.
+        """
+        value = self.build_expression(node.expression)
+        self.scopes.append({})
+        statements = []
+        starts = {}
+        default_start = None
+        for case in node.cases:
+            if case.is_default:
+                default_start = len(statements)
+            else:
+                starts.setdefault(self.build_expression(case.value)([None] * self.slot_count), len(statements))
+            statements.extend(self.build_statement(statement) for statement in case.statements)
+        self.scopes.pop()
+        statements = tuple(statements)
+        count = len(statements)
+        missing = count if default_start is None else default_start
+
+        def run_switch(frame):
+            index = starts.get(value(frame), missing)
+            while index < count:
+                result = statements[index](frame)
+                if result is not None:
+                    return None if result is BREAK else result
+                index += 1
+        return run_switch
+
+    # Expressions
+
+    def build_expression(self, node: Expression) -> Callable:
+        """Closure evaluating node, converted to the type its context expects"""
+        handler = self.expression_handlers[type(node)]
+        if handler is None:
+            raise ClosureUnsupported(f"expression {type(node).__name__}")
+        closure = handler(self, node)
+        if node.converted_type:
+            closure = self.convert_arithmetic(node, closure, node.converted_type)
+        return closure
+
+    def convert_arithmetic(self, node: Expression, value: Callable, target_type: str) -> Callable:
+        """Apply the implicit C++ conversion of node's value to target_type"""
+        source_type = node.static_type
+        if target_type == 'float':
+            if isinstance(node, Literal):
+                constant = round_to_float32(float(node.value))
+                return lambda frame: constant
+            return lambda frame: cpp_float32(value(frame))
+        if target_type == 'double':
+            if source_type in INTEGER_WRAP_MASKS:
+                if isinstance(node, Literal):
+                    constant = float(node.value)
+                    return lambda frame: constant
+                return lambda frame: float(value(frame))
+            return value
+        if source_type in ('float', 'double'):
+            return lambda frame: int(value(frame))
+        if not self.ranges.fits(node, target_type):
+            return self.wrap_integer(value, target_type)
+        return value
+
+    def wrap_integer(self, value: Callable, type_name: str) -> Callable:
+        """Wrap an exact integer result to the width of type_name"""
+        bias, mask = (int(text, 16) for text in INTEGER_WRAP_MASKS[type_name])
+        return lambda frame: (value(frame) + bias & mask) - bias
+
+    @handles('expression', Literal)
+    def build_literal(self, node: Literal) -> Callable:
+        constant = node.value
+        if node.type_name == 'float':
+            constant = round_to_float32(constant)
+        return lambda frame: constant
+
+    def resolve(self, name: str) -> tuple:
+        """Where a variable lives: ('local', slot), ('member', name) or ('global', slot)"""
+        for scope in reversed(self.scopes):
+            if name in scope:
+                return 'local', scope[name]
+        if self.current_class is not None and name in self.current_class.member_names:
+            return 'member', name
+        if name in self.global_slots:
+            return 'global', self.global_slots[name]
+        raise ClosureUnsupported(f"reference to {name}")
+
+    @handles('expression', Identifier)
+    def build_identifier(self, node: Identifier) -> Callable:
+        if node.name in ('endl', 'std::endl'):
+            return lambda frame: '\n'
+        if node.name in INPUT_STREAMS:
+            source = self.input
+            return lambda frame: source[0].good
+        kind, where = self.resolve(node.name)
+        if kind == 'local':
+            closure = lambda frame: frame[where]
+        elif kind == 'member':
+            this, get = self.this_slot, attrgetter(where)
+            closure = lambda frame: get(frame[this])
+        else:
+            storage = self.globals
+            closure = lambda frame: storage[where]
+        return self.copy_if_needed(node, closure)
+
+    def copy_if_needed(self, node: Expression, value: Callable) -> Callable:
+        """Copy a class-typed value where C++ copies it rather than aliasing it"""
+        if node not in self.analyzer.value_copies:
+            return value
+        copy = self.classes[node.static_type].copy
+        return lambda frame: copy(value(frame))
+
+    @handles('expression', MemberAccess)
+    def build_member_access(self, node: MemberAccess) -> Callable:
+        obj, get = self.build_expression(node.obj), attrgetter(node.member)
+        return self.copy_if_needed(node, lambda frame: get(obj(frame)))
+
+    @handles('expression', MethodCall)
+    def build_method_call(self, node: MethodCall) -> Callable:
+        layout = self.classes.get(node.obj.static_type)
+        if layout is None or node.name not in layout.methods:
+            raise ClosureUnsupported(f"method call {node.name}")
+        return self.build_call(layout.methods[node.name], [self.build_expression(node.obj)] + self.build_arguments(node),
+                               cell=True)
+
+    def build_arguments(self, node) -> List[Callable]:
+        return [self.build_expression(arg) for arg in node.arguments]
+
+    def build_call(self, function, args: List[Callable], cell: bool = False) -> Callable:
+        """Closure calling function (or the function held in cell) with the values of args"""
+        if cell:
+            if len(args) == 0:
+                return lambda frame: function[0]()
+            if len(args) == 1:
+                first, = args
+                return lambda frame: function[0](first(frame))
+            if len(args) == 2:
+                first, second = args
+                return lambda frame: function[0](first(frame), second(frame))
+            return lambda frame: function[0](*[arg(frame) for arg in args])
+        if len(args) == 0:
+            return lambda frame: function()
+        if len(args) == 1:
+            first, = args
+            return lambda frame: function(first(frame))
+        if len(args) == 2:
+            first, second = args
+            return lambda frame: function(first(frame), second(frame))
+        return lambda frame: function(*[arg(frame) for arg in args])
+
+    @handles('expression', FunctionCall)
+    def build_function_call(self, node: FunctionCall) -> Callable:
+        if node.intrinsic:
+            return self.build_intrinsic_call(node, node.intrinsic)
+        if node.name in self.classes:
+            # A class temporary, constructed from the arguments
+            layout = self.classes[node.name]
+            args = self.build_arguments(node)
+            return lambda frame: layout.construct(*[arg(frame) for arg in args])
+        layout = self.current_class
+        if layout is not None and node.name in layout.methods and not self.is_local(node.name):
+            this = self.this_slot
+            return self.build_call(layout.methods[node.name],
+                                   [lambda frame: frame[this]] + self.build_arguments(node), cell=True)
+        if node.name not in self.call_graph.functions:
+            raise ClosureUnsupported(f"call of {node.name}")
+        return self.build_call(self.function_cell(node.name), self.build_arguments(node), cell=True)
+
+    def is_local(self, name: str) -> bool:
+        return any(name in scope for scope in self.scopes)
+
+    def build_intrinsic_call(self, node: FunctionCall, intrinsic: Intrinsic) -> Callable:
+        """Call a Python function made from the intrinsic's lowering"""
+        arguments = node.arguments
+        squared = intrinsic.name == 'pow' and isinstance(arguments[1], Literal) and arguments[1].value == 2
+        if squared:
+            arguments = arguments[:1]
+        function = intrinsic_function(intrinsic, squared)
+        if node.static_type == 'float' and not intrinsic.float_exact:
+            unrounded = function
+            function = lambda *args: cpp_float32(unrounded(*args))
+        return self.build_call(function, [self.build_expression(arg) for arg in arguments])
+
+    @handles('expression', BinaryOperation)
+    def build_binary_operation(self, node: BinaryOperation) -> Callable:
+        if node.operator == '>>':
+            return self.build_extraction(node)
+        result_type = node.static_type
+        operator = node.operator
+        left, right = self.build_expression(node.left), self.build_expression(node.right)
+        if operator == '&&':
+            return lambda frame: left(frame) and right(frame)
+        if operator == '||':
+            return lambda frame: left(frame) or right(frame)
+
+        if result_type in INTEGER_WRAP_MASKS:
+            if operator in ['/', '%']:
+                # Floor and truncating division agree on non-negative operands
+                if self.ranges.is_non_negative(node.left) and self.ranges.is_non_negative(node.right):
+                    return BINARY_OPERATORS['//' if operator == '/' else '%'](left, right)
+                helper = cpp_idiv if operator == '/' else cpp_imod
+                return lambda frame: helper(left(frame), right(frame))
+            closure = self.binary_operator(operator, left, right)
+            if self.ranges.needs_wrap(node):
+                closure = self.wrap_integer(closure, result_type)
+            return closure
+
+        if operator == '/' and not (isinstance(node.right, Literal) and node.right.value):
+            closure = lambda frame: cpp_fdiv(left(frame), right(frame))
+        else:
+            closure = self.binary_operator(operator, left, right)
+        if result_type == 'float' and operator in ['+', '-', '*', '/']:
+            unrounded = closure
+            closure = lambda frame: cpp_float32(unrounded(frame))
+        return closure
+
+    def binary_operator(self, operator: str, left: Callable, right: Callable) -> Callable:
+        if operator not in BINARY_OPERATORS:
+            raise ClosureUnsupported(f"operator {operator}")
+        return BINARY_OPERATORS[operator](left, right)
+
+    @handles('expression', UnaryOperation)
+    def build_unary_operation(self, node: UnaryOperation) -> Callable:
+        operator = node.operator
+        if operator in ['++', '--', '++_post', '--_post']:
+            return self.build_step(node)
+        operand = self.build_expression(node.operand)
+        if operator == '!':
+            return lambda frame: not operand(frame)
+        if operator == '-':
+            closure = lambda frame: -operand(frame)
+            if self.ranges.needs_wrap(node):
+                closure = self.wrap_integer(closure, node.static_type)
+            return closure
+        if operator == '+':
+            return lambda frame: +operand(frame)
+        raise ClosureUnsupported(f"operator {operator}")
+
+    def build_step(self, node: UnaryOperation) -> Callable:
+        """Increment or decrement; yields the new value, or the old one for postfix"""
+        delta = 1 if node.operator.startswith('++') else -1
+        operand_type = node.static_type
+        if operand_type == 'float':
+            step = lambda value: cpp_float32(value + delta)
+        elif operand_type in INTEGER_WRAP_MASKS and self.ranges.needs_wrap(node):
+            bias, mask = (int(text, 16) for text in INTEGER_WRAP_MASKS[operand_type])
+            step = lambda value: (value + delta + bias & mask) - bias
+        else:
+            step = None
+        postfix = node.operator.endswith('_post')
+        target = node.operand
+        if isinstance(target, Identifier):
+            kind, where = self.resolve(target.name)
+            if kind == 'local' and step is None:
+                if postfix:
+                    def post_step(frame):
+                        value = frame[where]
+                        frame[where] = value + delta
+                        return value
+                    return post_step
+
+                def pre_step(frame):
+                    value = frame[where] = frame[where] + delta
+                    return value
+                return pre_step
+        step = step or (lambda value: value + delta)
+
+        def update(old):
+            return (step(old), old) if postfix else (step(old),) * 2
+        return self.build_update(target, update)
+
+    def build_extraction(self, node: BinaryOperation) -> Callable:
+        """Closure reading each target of cin >> a >> b and returning whether the reads succeeded"""
+        source = self.input
+        reads = []
+        for target in extraction_chain(node):
+            if target.static_type in INTEGER_WRAP_MASKS:
+                low, high = INTEGER_RANGES[target.static_type]
+                read = lambda old, low=low, high=high: (source[0].read_integer(old, low, high), None)
+            else:
+                method = f"read_{target.static_type}"
+                read = lambda old, method=method: (getattr(source[0], method)(old), None)
+            reads.append(self.build_update(target, read))
+
+        def extract(frame):
+            for read in reads:
+                read(frame)
+            return source[0].good
+        return extract
+
+    @handles('expression', Assignment)
+    def build_assignment(self, node: Assignment) -> Callable:
+        value = self.build_expression(node.value)
+        target = node.target
+        if isinstance(target, Identifier):
+            kind, where = self.resolve(target.name)
+            if kind == 'local':
+                def assign_local(frame):
+                    result = frame[where] = value(frame)
+                    return result
+                return assign_local
+            if kind == 'global':
+                storage = self.globals
+
+                def assign_global(frame):
+                    result = storage[where] = value(frame)
+                    return result
+                return assign_global
+            this = self.this_slot
+            obj = lambda frame: frame[this]
+            name = where
+        elif isinstance(target, MemberAccess):
+            obj, name = self.build_expression(target.obj), target.member
+        else:
+            raise ClosureUnsupported("assignment target")
+
+        def assign_member(frame):
+            result = value(frame)
+            setattr(obj(frame), name, result)
+            return result
+        return assign_member
+
+    def build_update(self, target: Expression, update: Callable) -> Callable:
+        """Closure storing update(old)[0] into target and returning update(old)[1]"""
+        if isinstance(target, Identifier):
+            kind, where = self.resolve(target.name)
+            if kind == 'local':
+                def update_local(frame):
+                    frame[where], result = update(frame[where])
+                    return result
+                return update_local
+            if kind == 'global':
+                storage = self.globals
+
+                def update_global(frame):
+                    storage[where], result = update(storage[where])
+                    return result
+                return update_global
+            this = self.this_slot
+            obj = lambda frame: frame[this]
+            name = where
+        elif isinstance(target, MemberAccess):
+            obj, name = self.build_expression(target.obj), target.member
+        else:
+            raise ClosureUnsupported("increment target")
+
+        def update_member(frame):
+            instance = obj(frame)
+            new, result = update(getattr(instance, name))
+            setattr(instance, name, new)
+            return result
+        return update_member
+
+def generic_insertion(value) -> str:
+    """Text cout writes for a value of no arithmetic type (CppRuntime.__lshift__)"""
+    if value == '\n' or str(value) == '\n':
+        return '\n'
+    if isinstance(value, str) and value.startswith('"') and value.endswith('"'):
+        return value[1:-1]
+    if isinstance(value, bool):
+        return str(int(value))
+    if isinstance(value, float):
+        return '%g' % value
+    return str(value)
+
+def intrinsic_function(intrinsic: Intrinsic, squared: bool = False) -> Callable:
+    """A Python function computing the intrinsic from its lowering, made once per intrinsic"""
+    key = (intrinsic.name, squared)
+    function = intrinsic_functions.get(key)
+    if function is None:
+        templates = ["({0} * {0})"] if squared else intrinsic.templates()
+        parts = [template.format(*(f"a{index}" for index in range(intrinsic.arity))) for template in templates]
+        body = parts[0] if len(parts) == 1 else f"({parts[1]} if {parts[0]} else {parts[2]})"
+        params = ", ".join(f"a{index}" for index in range(1 if squared else intrinsic.arity))
+        function = intrinsic_functions[key] = eval(f"lambda {params}: {body}", RUNTIME)
+    return function
+
+BINARY_OPERATORS: Dict[str, Callable] = {
+    '+': lambda left, right: lambda frame: left(frame) + right(frame),
+    '-': lambda left, right: lambda frame: left(frame) - right(frame),
+    '*': lambda left, right: lambda frame: left(frame) * right(frame),
+    '/': lambda left, right: lambda frame: left(frame) / right(frame),
+    '//': lambda left, right: lambda frame: left(frame) // right(frame),
+    '%': lambda left, right: lambda frame: left(frame) % right(frame),
+    '==': lambda left, right: lambda frame: left(frame) == right(frame),
+    '!=': lambda left, right: lambda frame: left(frame) != right(frame),
+    '<': lambda left, right: lambda frame: left(frame) < right(frame),
+    '>': lambda left, right: lambda frame: left(frame) > right(frame),
+    '<=': lambda left, right: lambda frame: left(frame) <= right(frame),
+    '>=': lambda left, right: lambda frame: left(frame) >= right(frame),
+    '<<': lambda left, right: lambda frame: left(frame) << right(frame),
+    '>>': lambda left, right: lambda frame: left(frame) >> right(frame),
+    '&': lambda left, right: lambda frame: left(frame) & right(frame),
+    '|': lambda left, right: lambda frame: left(frame) | right(frame),
+    '^': lambda left, right: lambda frame: left(frame) ^ right(frame),
+}
+
+def estimated_work(program: Program, call_graph: CallGraph) -> Tuple[float, int]:
+    """(Estimated AST nodes a run of program evaluates, AST nodes that can run)
+
+    Each node counts once per execution: loop bodies and conditions by their
+    trip count (UNBOUNDED_TRIPS unless a for loop counts between constants)
+    and calls by the callee's own estimate. Recursion makes the estimate
+    infinite. Functions main cannot reach are not counted.
+    """
+    functions = call_graph.functions
+    estimates: Dict[str, float] = {}
+    size = 0
+
+    def work(root) -> float:
+        nonlocal size
+        total = 0.0
+        stack = [(root, 1.0)]
+        while stack:
+            node, times = stack.pop()
+            if isinstance(node, list):
+                stack.extend((item, times) for item in node)
+                continue
+            if not isinstance(node, ASTNode):
+                continue
+            size += 1
+            total += times
+            node_type = type(node)
+            if node_type is WhileStatement or node_type is ForStatement:
+                trips = times * loop_trips(node)
+                stack.append((node.body, trips))
+                stack.append((node.condition, trips))
+                if node_type is ForStatement:
+                    stack.append((node.init, times))
+                    stack.append((node.update, trips))
+                continue
+            if node_type is FunctionCall and node.name in functions:
+                total += times * function_work(node.name)
+            stack.extend((value, times) for value in vars(node).values())
+        return total
+
+    def function_work(name: str) -> float:
+        if name not in estimates:
+            estimates[name] = math.inf  # reached again while in progress: recursion
+            estimates[name] = work(functions[name].body)
+        return estimates[name]
+
+    total = work([declaration for declaration in program.declarations
+                  if type(declaration) is not FunctionDeclaration])
+    if 'main' in functions:
+        total += function_work('main')
+    return total, size
+
+def loop_trips(loop) -> float:
+    """Iterations of a for loop from a constant to a constant, else UNBOUNDED_TRIPS"""
+    if not isinstance(loop, ForStatement):
+        return UNBOUNDED_TRIPS
+    init, condition, update = loop.init, loop.condition, loop.update
+    if not (isinstance(init, VariableDeclaration) and isinstance(init.initializer, Literal)
+            and isinstance(condition, BinaryOperation) and isinstance(condition.left, Identifier)
+            and condition.left.name == init.name and isinstance(condition.right, Literal)
+            and counts_up(update, init.name)):
+        return UNBOUNDED_TRIPS
+    start, limit = init.initializer.value, condition.right.value
+    if not (isinstance(start, int) and isinstance(limit, int)):
+        return UNBOUNDED_TRIPS
+    if condition.operator == '<':
+        return max(0, limit - start)
+    if condition.operator == '<=':
+        return max(0, limit - start + 1)
+    return UNBOUNDED_TRIPS
+
+def counts_up(update, name: str) -> bool:
+    """Whether update is name++ or name = name + 1"""
+    if isinstance(update, UnaryOperation):
+        return update.operator in ['++', '++_post'] and isinstance(update.operand, Identifier) \
+            and update.operand.name == name
+    if not (isinstance(update, Assignment) and isinstance(update.target, Identifier)
+            and update.target.name == name):
+        return False
+    step = update.value
+    return (isinstance(step, BinaryOperation) and step.operator == '+'
+            and isinstance(step.left, Identifier) and step.left.name == name
+            and isinstance(step.right, Literal) and step.right.value == 1)
+
+def choose_engine(program: Program, call_graph: CallGraph, engine: str) -> str:
+    """The engine to run program on: 'closure' or 'exec'
+
+    "auto" takes closures when the estimated work is at most
+    AUTO_WORK_PER_NODE times the size of the code that can run.
+    """
+    if engine != 'auto':
+        return engine
+    work, size = estimated_work(program, call_graph)
+    return 'closure' if work <= AUTO_WORK_PER_NODE * size else 'exec'
+
+def main():
+    """Build a sample program into closures and run it"""
+    from lexer import Lexer
+
+    source_code = """
+int square(int x) { return x * x; }
+int main() {
+    for (int i = 1; i <= 3; i++) {
+        cout << i << " squared is " << square(i) << endl;
+    }
+    return 0;
+}
+"""
+    ast = Parser(Lexer(source_code).tokenize()).parse()
+    analyzer = SemanticAnalyzer()
+    analyzer.analyze(ast)
+    output = []
+    ClosureCompiler(analyzer).build(ast).run(output)
+    print("".join(output), end="")
+    print(f"engine for this program: {choose_engine(ast, analyzer.call_graph or CallGraph(ast), 'auto')}")
+
+if __name__ == "__main__":
+    main()
@@ -22,21 +22,171 @@ that maintains C++ semantics but can be executed direct            #
                 arg_code = arg_code.replace('std::', 'std.')
                 self.emit(f\"{cout_obj}.__lshift__({arg_code})\")"""
 
+import keyword
+import re
 import sys
+import struct
 from typing import Dict, List, Optional, Any, Union
 from parser import *
 from semantic_analyzer import SemanticAnalyzer, Symbol, Scope
+from range_analysis import INTEGER_RANGES, RangeAnalysis
+from call_graph import CallGraph
+from intrinsics import Intrinsic, RUNTIME_SUPPORT, fold
+from compilation_context import CompilationContext
+from visitor import Visitor, handles
 
-class CodeGenerator:
+# Masks that wrap an exact Python integer to two's complement of each width
+INTEGER_WRAP_MASKS = {
+    'int': ('0x80000000', '0xFFFFFFFF'),
+    'long': ('0x8000000000000000', '0xFFFFFFFFFFFFFFFF'),
+}
+
+# cin, emitted into every generated program. Reads numbers as operator>>
+# does: a read that finds no number fails the stream, and a failed stream
+# reads nothing more. Hosts pass the input text as cpp_stdin; without it the
+# process's standard input is read on the first read.
+INPUT_SUPPORT = '''\
+CPP_INTEGER_TOKEN = re.compile(r'[ \\t\\n\\v\\f\\r]*([+-]?[0-9]+)')
+CPP_FLOAT_TOKEN = re.compile(r'[ \\t\\n\\v\\f\\r]*([+-]?(?:[0-9]+\\.?[0-9]*|\\.[0-9]+)(?:[eE][+-]?[0-9]*)?)')
+
+class CppInput:
+    def __init__(self, text=None):
+        self.text = text
+        self.position = 0
+        self.good = True
+
+    def next_token(self, pattern):
+        if self.text is None:
+            self.text = sys.stdin.read()
+        match = pattern.match(self.text, self.position)
+        if match is None:
+            self.good = False
+            return None
+        self.position = match.end()
+        return match.group(1)
+
+    def failed_read(self, current):
+        # At the end of input the variable keeps its value; before anything
+        # that is not a number it is zeroed
+        if self.text[self.position:].strip(' \\t\\n\\v\\f\\r'):
+            return 0
+        return current
+
+    def read_integer(self, current, low, high):
+        if not self.good:
+            return current
+        token = self.next_token(CPP_INTEGER_TOKEN)
+        if token is None:
+            return self.failed_read(current)
+        value = int(token)
+        if low <= value <= high:
+            return value
+        # Out of range: the nearest limit, and the stream fails
+        self.good = False
+        return high if value > high else low
+
+    def read_bool(self, current):
+        if not self.good:
+            return current
+        token = self.next_token(CPP_INTEGER_TOKEN)
+        if token is None:
+            return bool(self.failed_read(current))
+        value = int(token)
+        if value not in (0, 1):
+            self.good = False
+        return value != 0
+
+    def read_double(self, current):
+        if not self.good:
+            return current
+        token = self.next_token(CPP_FLOAT_TOKEN)
+        if token is None:
+            return float(self.failed_read(current))
+        try:
+            value = float(token)
+        except ValueError:
+            # An exponent without digits
+            self.good = False
+            return 0.0
+        if math.isinf(value):
+            self.good = False
+            return math.copysign(sys.float_info.max, value)
+        return value
+
+    def read_float(self, current):
+        value = cpp_float32(self.read_double(current))
+        if math.isinf(value):
+            self.good = False
+            return math.copysign(3.4028234663852886e+38, value)
+        return value
+
+cin = CppInput(globals().get('cpp_stdin'))
+'''
+
+def float_literal(value: float) -> str:
+    """Python source for a float constant, including infinities"""
+    if value != value:
+        return "math.nan"
+    if value in (float('inf'), float('-inf')):
+        return "math.inf" if value > 0 else "(-math.inf)"
+    return repr(value)
+
+def member_attribute(name: str) -> str:
+    """Python attribute for a data member; Python keywords (in, from, lambda) get a trailing _
+
+    So does a keyword already followed by underscores, so in and in_ stay distinct.
+    """
+    return name + '_' if keyword.iskeyword(name.rstrip('_')) else name
+
+def round_to_float32(value: float) -> float:
+    """Round a Python float to the nearest single-precision value"""
+    try:
+        return struct.unpack('f', struct.pack('f', value))[0]
+    except OverflowError:
+        return float('inf') if value > 0 else float('-inf')
+
+class CodeGenerator(Visitor):
     """Generates executable Python code from C++ AST"""
     
-    def __init__(self, semantic_analyzer: SemanticAnalyzer):
+    # A switch whose integer labels fill at least this fraction of their
+    # value range (and whose range is not too wide) uses an index table
+    SWITCH_DENSITY_THRESHOLD = 0.5
+    SWITCH_MAX_TABLE_SPAN = 256
+    
+    def __init__(self, semantic_analyzer: SemanticAnalyzer, context: Optional[CompilationContext] = None):
         self.analyzer = semantic_analyzer
+        self.context = context or semantic_analyzer.context
         self.output = []
         self.indent_level = 0
         self.temp_var_count = 0
         self.in_main_function = False
         
+        # Call graph of the program; functions main can't reach are left out
+        self.call_graph: Optional[CallGraph] = None
+        
+        # Switch lowering state: case blocks become closures that are hoisted
+        # to the start of the enclosing def so they are built once per call
+        self.switch_count = 0
+        self.hoist_frames = []
+        self.jump_targets = []  # ('loop', update) or ('switch', None), innermost last
+        self.function_locals = set()
+        
+        # Module-level names read inside the current def's loops, by the local
+        # alias bound at its entry; None outside a def
+        self.local_aliases: Optional[Dict[str, str]] = None
+        self.loop_depth = 0
+        
+        # Class whose member functions are being generated
+        self.current_class = None
+        
+        # Top-level variables, which functions must declare global to assign
+        self.global_variables = set()
+        
+        # Integer value ranges, used to skip wraparound masks that can't matter
+        self.ranges = RangeAnalysis()
+        self.deferred_wraps = set()     # operands whose enclosing + - * wraps for them
+        self.unwrapped_results = set()  # deferred operands that did skip a mask
+        
         # Runtime environment for execution
         self.runtime_globals = {
             'cout': self,  # cout object
@@ -73,13 +223,8 @@ class CodeGenerator:
     
     def generate(self, ast: Program) -> str:
         """Generate code from AST"""
-        # Emit header
-        self.emit_raw("# Generated C++ code (Python implementation)")
-        self.emit_raw("import sys")
-        self.emit_raw("import math")
-        self.emit_raw("")
-        
-        # Emit runtime support
+        # Emit header and runtime support
+        self.emit_header()
         self.emit_runtime_support()
         
         # Generate main code
@@ -93,18 +238,42 @@ class CodeGenerator:
         self.generated_code = "\n".join(self.output)
         return self.generated_code
     
+    def generate_runtime(self) -> str:
+        """Generate just the header and runtime support, for sessions that add code later"""
+        self.output = []
+        self.emit_header()
+        self.emit_runtime_support()
+        return "\n".join(self.output)
+    
+    def emit_header(self):
+        """Emit the generated module's header and imports"""
+        self.emit_raw("# Generated C++ code (Python implementation)")
+        self.emit_raw(f"# Source: {self.context.filename!r}")
+        self.emit_raw("import re")
+        self.emit_raw("import sys")
+        self.emit_raw("import math")
+        self.emit_raw("import struct")
+        self.emit_raw("")
+    
     def emit_runtime_support(self):
         """Emit runtime support functions"""
         self.emit_raw("# Runtime support")
+        # Hosts may pass a bounded buffer type (output_capture.HeadTailBuffer)
+        self.emit_raw("cpp_output_buffer = globals().get('cpp_output_buffer', list)")
+        self.emit_raw("")
         self.emit_raw("class CppRuntime:")
         self.emit_raw("    def __init__(self):")
-        self.emit_raw("        self.output_buffer = []")
+        self.emit_raw("        self.output_buffer = cpp_output_buffer()")
         self.emit_raw("        self.return_value = 0")
         self.emit_raw("        self.return_called = False")
         self.emit_raw("")
         self.emit_raw("    def cout_output(self, value):")
         self.emit_raw("        if isinstance(value, str) and value.startswith('\"') and value.endswith('\"'):")
         self.emit_raw("            value = value[1:-1]  # Remove quotes")
+        self.emit_raw("        elif isinstance(value, bool):")
+        self.emit_raw("            value = int(value)")
+        self.emit_raw("        elif isinstance(value, float):")
+        self.emit_raw("            value = '%g' % value  # default ostream precision")
         self.emit_raw("        self.output_buffer.append(str(value))")
         self.emit_raw("        return self")
         self.emit_raw("")
@@ -150,16 +319,65 @@ class CodeGenerator:
         self.emit_raw("        result = result.__lshift__(arg)")
         self.emit_raw("    return result")
         self.emit_raw("")
+        
+        # Switch dispatch support
+        self.emit_raw("CPP_SWITCH_CONTINUE = object()")
+        self.emit_raw("")
+        self.emit_raw("def cpp_switch_skip():")
+        self.emit_raw("    return None")
+        self.emit_raw("")
+        
+        # Integer division and remainder truncate toward zero in C++
+        self.emit_raw("def cpp_idiv(a, b):")
+        self.emit_raw("    q = a // b")
+        self.emit_raw("    if q < 0 and q * b != a:")
+        self.emit_raw("        q += 1")
+        self.emit_raw("    return q")
+        self.emit_raw("")
+        self.emit_raw("def cpp_imod(a, b):")
+        self.emit_raw("    r = a % b")
+        self.emit_raw("    if r and (r < 0) != (a < 0):")
+        self.emit_raw("        r -= b")
+        self.emit_raw("    return r")
+        self.emit_raw("")
+        
+        # Floating division by zero gives IEEE infinities/NaN instead of raising
+        self.emit_raw("def cpp_fdiv(a, b):")
+        self.emit_raw("    try:")
+        self.emit_raw("        return a / b")
+        self.emit_raw("    except ZeroDivisionError:")
+        self.emit_raw("        if a != a or a == 0:")
+        self.emit_raw("            return math.nan")
+        self.emit_raw("        return math.copysign(math.inf, a) * math.copysign(1.0, b)")
+        self.emit_raw("")
+        
+        # float values are rounded to single precision after every operation
+        self.emit_raw("cpp_float_format = struct.Struct('f')")
+        self.emit_raw("")
+        self.emit_raw("def cpp_float32(value):")
+        self.emit_raw("    try:")
+        self.emit_raw("        return cpp_float_format.unpack(cpp_float_format.pack(value))[0]")
+        self.emit_raw("    except OverflowError:")
+        self.emit_raw("        return math.copysign(math.inf, value)")
+        self.emit_raw("")
+        
+        # <cmath> intrinsics that do not lower to a single expression
+        for line in RUNTIME_SUPPORT.splitlines():
+            self.emit_raw(line)
+        self.emit_raw("")
+        for line in INPUT_SUPPORT.splitlines():
+            self.emit_raw(line)
     
     def generate_program(self, node: Program):
         """Generate code for the entire program"""
-        # First pass: declare all functions
+        self.ranges.collect_program(node)
+        self.call_graph = self.analyzer.call_graph or CallGraph(node)
+        
+        # First pass: declare the reachable functions, classes and globals
         for declaration in node.declarations:
-            if isinstance(declaration, FunctionDeclaration):
-                self.generate_function_declaration(declaration)
-            elif isinstance(declaration, ClassDeclaration):
-                # Class declarations generate no runtime code in this simplified model
-                self.emit_raw(f"# Skipping class {declaration.name} declaration (no runtime effect)")
+            if type(declaration) is FunctionDeclaration and not self.call_graph.is_reachable(declaration.name):
+                continue
+            self.generate_declaration(declaration)
         
         # Generate main execution
         self.emit_raw("")
@@ -191,23 +409,175 @@ class CodeGenerator:
         
         self.decrease_indent()
     
-    def generate_function_declaration(self, node: FunctionDeclaration):
-        """Generate code for a function declaration"""
+    def generate_declaration(self, node: Statement):
+        """Generate code for a top-level declaration; includes and using directives emit nothing"""
+        handler = self.declaration_handlers[type(node)]
+        if handler is not None:
+            handler(self, node)
+    
+    @handles('declaration', VariableDeclaration)
+    def generate_global_variable(self, node: VariableDeclaration):
+        """Generate code for a variable declared at file scope"""
+        self.global_variables.add(node.name)
+        self.generate_variable_declaration(node)
+    
+    def generate_entry(self, items: List[Statement]) -> str:
+        """Generate code for one interactive entry, to run in the session's namespace
+        
+        Declarations are defined as in a program. Each run of statements is
+        wrapped in a function that is called straight away; the variables it
+        declares at its top level become globals so later entries see them.
+        """
+        self.output = []
+        self.indent_level = 0
+        self.ranges.collect_program(Program(items))
+        statements = []
+        for item in items + [None]:
+            if isinstance(item, (FunctionDeclaration, ClassDeclaration)) or item is None:
+                if statements:
+                    name = f"__entry_{self.temp_var_count}"
+                    self.temp_var_count += 1
+                    declared = {stmt.name for stmt in statements if isinstance(stmt, VariableDeclaration)}
+                    self.global_variables |= declared
+                    self.ranges.global_names |= declared
+                    wrapper = FunctionDeclaration(Type('void'), name, [], Block(statements))
+                    self.generate_function_declaration(wrapper, global_declarations=declared)
+                    self.emit(f"{name}()")
+                    statements = []
+                if item is not None:
+                    self.generate_declaration(item)
+            elif not isinstance(item, (IncludeDirective, UsingNamespace)):
+                statements.append(item)
+        self.generated_code = "\n".join(self.output)
+        return self.generated_code
+    
+    def emit_global_declarations(self, statements: List[Statement], local_names: set):
+        """Declare the globals that statements write, so Python doesn't make them locals"""
+        names = (self.assigned_names(statements) & self.global_variables) - local_names
+        if names:
+            self.emit(f"global {', '.join(sorted(names))}")
+    
+    @handles('declaration', ClassDeclaration)
+    def generate_class_declaration(self, node: ClassDeclaration):
+        """Generate a Python class with a fixed __slots__ layout for a class/struct"""
+        self.emit(f"class {node.name}:")
+        self.increase_indent()
+        self.emit(f"__slots__ = {tuple(member_attribute(member.name) for member in node.members)!r}")
+        self.emit_raw("")
+        self.current_class = node
+        self.function_locals = set()
+        
+        if not node.constructors:
+            # Aggregate: members are optional positional arguments, like brace initialization
+            params = []
+            for member in node.members:
+                default = self.member_default_value(member)
+                name = member_attribute(member.name)
+                params.append(f"{name}={default if self.is_constant_default(member) else 'None'}")
+            self.emit(f"def __init__({', '.join(['self'] + params)}):")
+            self.increase_indent()
+            for member in node.members:
+                name = member_attribute(member.name)
+                if self.is_constant_default(member):
+                    self.emit(f"self.{name} = {name}")
+                else:
+                    default = self.member_default_value(member)
+                    self.emit(f"self.{name} = {default} if {name} is None else {name}")
+            if not node.members:
+                self.emit("pass")
+            self.decrease_indent()
+            self.emit_raw("")
+        elif len(node.constructors) == 1:
+            self.generate_function_declaration(node.constructors[0], class_node=node, python_name='__init__')
+        else:
+            # Overloads are resolved by argument count
+            for ctor in node.constructors:
+                self.generate_function_declaration(ctor, class_node=node,
+                                                   python_name=f"_cpp_init{len(ctor.parameters)}")
+            table = ', '.join(f"{len(ctor.parameters)}: _cpp_init{len(ctor.parameters)}" for ctor in node.constructors)
+            self.emit(f"_cpp_constructors = {{{table}}}")
+            self.emit_raw("")
+            self.emit("def __init__(self, *args):")
+            self.emit(f"    {node.name}._cpp_constructors[len(args)](self, *args)")
+            self.emit_raw("")
+        
+        # Value-semantics copy; bypasses __init__ and copies nested objects
+        self.emit("def _cpp_copy(self):")
+        self.increase_indent()
+        self.emit(f"other = object.__new__({node.name})")
+        for member in node.members:
+            name = member_attribute(member.name)
+            if member.var_type.name in self.analyzer.classes:
+                self.emit(f"other.{name} = self.{name}._cpp_copy()")
+            else:
+                self.emit(f"other.{name} = self.{name}")
+        self.emit("return other")
+        self.decrease_indent()
+        self.emit_raw("")
+        
+        for method in node.methods:
+            self.generate_function_declaration(method, class_node=node)
+        
+        self.current_class = None
+        self.decrease_indent()
+    
+    def is_constant_default(self, member: VariableDeclaration) -> bool:
+        """Check whether a member's default can be a Python default argument"""
+        if member.initializer is None:
+            return member.var_type.name not in self.analyzer.classes
+        return isinstance(member.initializer, Literal)
+    
+    def member_default_value(self, member: VariableDeclaration) -> str:
+        """Get the code for a data member's initial value"""
+        if member.initializer is not None:
+            return self.generate_expression(member.initializer)
+        return self.get_default_value(member.var_type.name)
+    
+    @handles('declaration', FunctionDeclaration)
+    def generate_function_declaration(self, node: FunctionDeclaration,
+                                      class_node: Optional[ClassDeclaration] = None,
+                                      python_name: Optional[str] = None,
+                                      global_declarations: set = frozenset()):
+        """Generate code for a function declaration (or member function of class_node)
+        
+        Variables in global_declarations are declared by the body's top-level
+        statements but live at module level (interactive entries).
+        """
         # Function signature
         param_names = [param_name for _, param_name in node.parameters]
-        param_str = ", ".join(param_names)
+        param_str = ", ".join((['self'] if class_node else []) + param_names)
         
-        self.emit_raw(f"def {node.name}({param_str}):")
+        self.emit(f"def {python_name or node.name}({param_str}):")
         self.increase_indent()
         
         # Mark if we're in main function
-        if node.name == 'main':
+        if node.name == 'main' and class_node is None:
             self.in_main_function = True
         
         # Initialize local variables (will be handled in variable declarations)
+        self.function_locals = (set(param_names) | self.declared_names([node.body])) - global_declarations
+        self.jump_targets = []
+        self.ranges.analyze_function(node, class_node)
+        if global_declarations:
+            self.emit(f"global {', '.join(sorted(global_declarations))}")
+        # Bare member names in member functions are attributes, not globals
+        member_names = {member.name for member in class_node.members} if class_node else set()
+        self.emit_global_declarations([node.body], self.function_locals | global_declarations | member_names)
         
         # Generate function body
+        saved_aliases, saved_loop_depth = self.local_aliases, self.loop_depth
+        self.local_aliases, self.loop_depth = {}, 0
+        self.push_hoist_frame()
+        frame = self.hoist_frames[-1]
+        if class_node and node in class_node.constructors:
+            # Members start from their defaults before the initializer list and body run
+            for member in class_node.members:
+                self.emit(f"self.{member_attribute(member.name)} = {self.member_default_value(member)}")
         self.generate_statement(node.body)
+        frame['lines'][:0] = ["    " * frame['indent'] + f"{alias} = {name}"
+                              for name, alias in self.local_aliases.items()]
+        self.pop_hoist_frame()
+        self.local_aliases, self.loop_depth = saved_aliases, saved_loop_depth
         
         # Add default return if needed
         if node.return_type.name == 'void':
@@ -227,47 +597,54 @@ class CodeGenerator:
         """Get default value for a type"""
         defaults = {
             'int': '0',
+            'long': '0',
             'float': '0.0',
             'double': '0.0',
             'char': "''",
             'bool': 'False',
             'string': '""',
         }
+        if type_name in self.analyzer.classes:
+            return f"{type_name}()"
         return defaults.get(type_name, 'None')
     
     def generate_statement(self, node: Statement):
         """Generate code for a statement"""
-        if isinstance(node, VariableDeclaration):
-            self.generate_variable_declaration(node)
-        elif isinstance(node, ExpressionStatement):
-            self.generate_expression_statement(node)
-        elif isinstance(node, Block):
-            self.generate_block(node)
-        elif isinstance(node, IfStatement):
-            self.generate_if_statement(node)
-        elif isinstance(node, WhileStatement):
-            self.generate_while_statement(node)
-        elif isinstance(node, ForStatement):
-            self.generate_for_statement(node)
-        elif isinstance(node, ReturnStatement):
-            self.generate_return_statement(node)
-        else:
+        handler = self.statement_handlers[type(node)]
+        if handler is None:
             self.emit(f"# Unsupported statement: {type(node)}")
+        else:
+            handler(self, node)
     
+    @handles('statement', VariableDeclaration)
     def generate_variable_declaration(self, node: VariableDeclaration):
         """Generate code for a variable declaration"""
-        if node.initializer:
+        if isinstance(node.initializer, InitializerList):
+            element_codes = [self.generate_expression(element) for element in node.initializer.elements]
+            if node.var_type.name in self.analyzer.classes:
+                self.emit(f"{node.name} = {node.var_type.name}({', '.join(element_codes)})")
+            elif element_codes:
+                self.emit(f"{node.name} = {element_codes[0]}")
+            else:
+                self.emit(f"{node.name} = {self.get_default_value(node.var_type.name)}")
+        elif node.initializer:
             init_code = self.generate_expression(node.initializer)
             self.emit(f"{node.name} = {init_code}")
         else:
             default_value = self.get_default_value(node.var_type.name)
             self.emit(f"{node.name} = {default_value}")
     
+    @handles('statement', ExpressionStatement)
     def generate_expression_statement(self, node: ExpressionStatement):
         """Generate code for an expression statement"""
         if isinstance(node.expression, BinaryOperation) and node.expression.operator == '<<':
             # Handle cout << expressions specially
             self.generate_cout_chain(node.expression)
+        elif isinstance(node.expression, BinaryOperation) and node.expression.operator == '>>':
+            # cin >> a >> b; reads into each target in turn
+            for target in extraction_chain(node.expression):
+                target_code = self.generate_expression(target)
+                self.emit(f"{target_code} = {self.extraction_read(target, target_code)}")
         else:
             expr_code = self.generate_expression(node.expression)
             self.emit(f"{expr_code}")
@@ -290,18 +667,60 @@ class CodeGenerator:
             # Generate the cout calls - use std.cout for std::cout
             cout_obj = "std.cout" if current.name == 'std::cout' else "cout"
             for arg in args:
-                arg_code = self.generate_expression(arg)
-                self.emit(f"{cout_obj}.__lshift__({arg_code})")
+                self.emit(self.cout_insertion(cout_obj, arg))
         else:
             # Not a cout chain, generate normally
             expr_code = self.generate_expression(node)
             self.emit(f"{expr_code}")
     
+    def cout_insertion(self, cout_obj: str, arg: Expression) -> str:
+        """Statement writing one << operand, formatted by its static type
+        
+        Numbers, string literals and endl go straight to the output buffer;
+        other operands take the runtime's generic path, which inspects the value.
+        """
+        append = self.global_ref(f"{cout_obj}.output_buffer.append")
+        if isinstance(arg, Identifier) and arg.name in ('endl', 'std::endl'):
+            return f"{append}('\\n')"
+        if (isinstance(arg, Literal) and arg.type_name == 'string' and arg.converted_type is None
+                and arg.value.startswith('"') and arg.value.endswith('"')):
+            # The quotes cout_output would strip at run time
+            return f"{append}({arg.value[1:-1]!r})"
+        arg_code = self.generate_expression(arg)
+        arg_type = arg.converted_type or arg.static_type
+        if arg_type in ('int', 'long', 'bool'):
+            return f"{append}('%d' % ({arg_code}))"
+        if arg_type in ('float', 'double'):
+            return f"{append}('%g' % ({arg_code}))"
+        return f"{self.global_ref(f'{cout_obj}.__lshift__')}({arg_code})"
+    
+    def extraction_read(self, target: Expression, target_code: str) -> str:
+        """Code reading target's next value from cin; target keeps its value if the read fails"""
+        if target.static_type in ('int', 'long'):
+            low, high = INTEGER_RANGES[target.static_type]
+            return f"{self.global_ref('cin.read_integer')}({target_code}, {low}, {high})"
+        return f"{self.global_ref(f'cin.read_{target.static_type}')}({target_code})"
+    
+    def generate_extraction(self, node: BinaryOperation) -> str:
+        """Expression for cin >> a >> b in a condition: read each target, then test the stream"""
+        stores = []
+        for target in extraction_chain(node):
+            target_code = self.generate_expression(target)
+            read = self.extraction_read(target, target_code)
+            if target_code.isidentifier():
+                stores.append(f"({target_code} := {read})")
+            else:
+                obj_code, member = target_code.rsplit('.', 1)
+                stores.append(f"setattr({obj_code}, {member!r}, {read})")
+        return f"({', '.join(stores)}, {self.global_ref('cin')}.good)[-1]"
+    
+    @handles('statement', Block)
     def generate_block(self, node: Block):
         """Generate code for a block statement"""
         for statement in node.statements:
             self.generate_statement(statement)
     
+    @handles('statement', IfStatement)
     def generate_if_statement(self, node: IfStatement):
         """Generate code for an if statement"""
         condition_code = self.generate_expression(node.condition)
@@ -316,14 +735,20 @@ class CodeGenerator:
             self.generate_statement(node.else_stmt)
             self.decrease_indent()
     
+    @handles('statement', WhileStatement)
     def generate_while_statement(self, node: WhileStatement):
         """Generate code for a while statement"""
+        self.loop_depth += 1
         condition_code = self.generate_expression(node.condition)
         self.emit(f"while {condition_code}:")
         self.increase_indent()
+        self.jump_targets.append(('loop', None))
         self.generate_statement(node.body)
+        self.jump_targets.pop()
         self.decrease_indent()
+        self.loop_depth -= 1
     
+    @handles('statement', ForStatement)
     def generate_for_statement(self, node: ForStatement):
         """Generate code for a for statement"""
         # Generate initialization
@@ -331,6 +756,7 @@ class CodeGenerator:
             self.generate_statement(node.init)
         
         # Generate while loop
+        self.loop_depth += 1
         if node.condition:
             condition_code = self.generate_expression(node.condition)
         else:
@@ -340,7 +766,9 @@ class CodeGenerator:
         self.increase_indent()
         
         # Generate body
+        self.jump_targets.append(('loop', node.update))
         self.generate_statement(node.body)
+        self.jump_targets.pop()
         
         # Generate update
         if node.update:
@@ -348,7 +776,9 @@ class CodeGenerator:
             self.emit(f"{update_code}")
         
         self.decrease_indent()
+        self.loop_depth -= 1
     
+    @handles('statement', ReturnStatement)
     def generate_return_statement(self, node: ReturnStatement):
         """Generate code for a return statement"""
         if self.in_main_function:
@@ -359,6 +789,13 @@ class CodeGenerator:
             else:
                 self.emit("cpp_runtime.set_return(0)")
                 self.emit("sys.exit(0)")
+        elif self.in_switch_closure():
+            # Wrapped so the dispatch site can tell a return from a break
+            if node.expression:
+                expr_code = self.generate_expression(node.expression)
+                self.emit(f"return ({expr_code},)")
+            else:
+                self.emit("return (None,)")
         else:
             if node.expression:
                 expr_code = self.generate_expression(node.expression)
@@ -366,23 +803,258 @@ class CodeGenerator:
             else:
                 self.emit("return None")
     
-    def generate_expression(self, node: Expression) -> str:
-        """Generate code for an expression and return the code string"""
-        if isinstance(node, Literal):
-            return self.generate_literal(node)
-        elif isinstance(node, Identifier):
-            return self.generate_identifier(node)
-        elif isinstance(node, BinaryOperation):
-            return self.generate_binary_operation(node)
-        elif isinstance(node, UnaryOperation):
-            return self.generate_unary_operation(node)
-        elif isinstance(node, Assignment):
-            return self.generate_assignment(node)
-        elif isinstance(node, FunctionCall):
-            return self.generate_function_call(node)
+    @handles('statement', BreakStatement)
+    def generate_break_statement(self, node: BreakStatement):
+        """Generate code for a break statement"""
+        if self.jump_targets and self.jump_targets[-1][0] == 'switch':
+            # Leaving a case closure ends the switch
+            self.emit("return")
+        else:
+            self.emit("break")
+    
+    @handles('statement', ContinueStatement)
+    def generate_continue_statement(self, node: ContinueStatement):
+        """Generate code for a continue statement"""
+        if self.jump_targets and self.jump_targets[-1][0] == 'switch':
+            # The loop lives outside the case closure; let the dispatch site continue it
+            self.emit("return CPP_SWITCH_CONTINUE")
         else:
+            self.emit_loop_continue()
+    
+    def emit_loop_continue(self):
+        """Continue the innermost loop, running a for-loop update first"""
+        for kind, update in reversed(self.jump_targets):
+            if kind == 'loop':
+                if update:
+                    update_code = self.generate_expression(update)
+                    self.emit(f"{update_code}")
+                break
+        self.emit("continue")
+    
+    def in_switch_closure(self) -> bool:
+        """Check whether code is being generated inside a switch case closure"""
+        return any(kind == 'switch' for kind, _ in self.jump_targets)
+    
+    def global_ref(self, name: str) -> str:
+        """Code that reads name, a module-level name or attribute chain
+        
+        Inside a def's loops this is a local alias bound at the def's entry,
+        since a local load is much cheaper than a global or builtin lookup.
+        Aliases are bound when the def is called, not when it is defined, so
+        names defined later in the module resolve as before. Only names that
+        are never rebound may be read this way: runtime helpers, builtins,
+        functions and cout's bound methods, but not C++ global variables.
+        """
+        if self.loop_depth == 0 or self.local_aliases is None:
+            return name
+        alias = self.local_aliases.get(name)
+        if alias is None:
+            alias = f"__hot{len(self.local_aliases)}_{re.sub(r'[^0-9A-Za-z]', '_', name)}"
+            self.local_aliases[name] = alias
+        return alias
+    
+    def push_hoist_frame(self):
+        """Mark the start of a def body as the insertion point for hoisted code"""
+        self.hoist_frames.append({
+            'output': self.output,
+            'index': len(self.output),
+            'indent': self.indent_level,
+            'lines': [],
+        })
+    
+    def pop_hoist_frame(self):
+        """Insert the code hoisted into the current def at its start"""
+        frame = self.hoist_frames.pop()
+        frame['output'][frame['index']:frame['index']] = frame['lines']
+    
+    def declared_names(self, statements: List[Statement]) -> set:
+        """Names of all variables declared within the given statements"""
+        return {node.name for node in walk(statements) if isinstance(node, VariableDeclaration)}
+    
+    def assigned_names(self, statements: List[Statement]) -> set:
+        """Names of all variables written within the given statements"""
+        names = set()
+        for node in walk(statements):
+            if isinstance(node, Assignment) and isinstance(node.target, Identifier):
+                names.add(node.target.name)
+            elif (isinstance(node, UnaryOperation) and node.operator in ['++', '--', '++_post', '--_post']
+                  and isinstance(node.operand, Identifier)):
+                names.add(node.operand.name)
+            elif isinstance(extraction_target(node), Identifier):
+                names.add(node.right.name)
+        return names
+    
+    def switch_may_continue(self, statements: List[Statement]) -> bool:
+        """Check for a continue that targets a loop enclosing the switch"""
+        for stmt in statements:
+            if isinstance(stmt, ContinueStatement):
+                return True
+            if isinstance(stmt, Block) and self.switch_may_continue(stmt.statements):
+                return True
+            if isinstance(stmt, IfStatement):
+                branches = [stmt.then_stmt] + ([stmt.else_stmt] if stmt.else_stmt else [])
+                if self.switch_may_continue(branches):
+                    return True
+            if isinstance(stmt, SwitchStatement):
+                if any(self.switch_may_continue(case.statements) for case in stmt.cases):
+                    return True
+        return False
+    
+    @handles('statement', SwitchStatement)
+    def generate_switch_statement(self, node: SwitchStatement):
+        """Generate code for a switch statement
+        
+        Each run of statements between labels becomes a closure that falls
+        through by tail-calling the next one; ``break`` returns from it.
+        Dense integer labels dispatch through a tuple indexed by value, any
+        other label set through a dict of closures.
+        """
+        prefix = f"__sw{self.switch_count}"
+        self.switch_count += 1
+        value_code = self.generate_expression(node.expression)
+        
+        # Labels with no statements of their own share the following block
+        blocks = []
+        pending = []
+        for case in node.cases:
+            pending.append(case)
+            if case.statements:
+                blocks.append((pending, case.statements))
+                pending = []
+        if pending:
+            blocks.append((pending, []))
+        
+        # Emit the case closures and dispatch table at the top of the enclosing def
+        frame = self.hoist_frames[-1]
+        saved_output, saved_indent = self.output, self.indent_level
+        self.output, self.indent_level = frame['lines'], frame['indent']
+        self.jump_targets.append(('switch', None))
+        
+        entries = []  # (label node, closure name)
+        default_name = 'cpp_switch_skip'
+        for i, (labels, statements) in enumerate(blocks):
+            name = f"{prefix}_c{i}"
+            for case in labels:
+                if case.is_default:
+                    default_name = name
+                else:
+                    entries.append((case.value, name))
+            
+            self.emit(f"def {name}():")
+            self.increase_indent()
+            nonlocals = (self.assigned_names(statements) & self.function_locals) - self.declared_names(statements)
+            if nonlocals:
+                self.emit(f"nonlocal {', '.join(sorted(nonlocals))}")
+            self.emit_global_declarations(statements, self.function_locals | self.declared_names(statements))
+            self.push_hoist_frame()
+            for statement in statements:
+                self.generate_statement(statement)
+            self.pop_hoist_frame()
+            
+            ends_with_jump = statements and isinstance(
+                statements[-1], (BreakStatement, ContinueStatement, ReturnStatement))
+            if i + 1 < len(blocks) and not ends_with_jump:
+                # Fallthrough into the next case
+                self.emit(f"return {prefix}_c{i + 1}()")
+            elif not statements:
+                self.emit("return None")
+            self.decrease_indent()
+        
+        int_labels = [self.analyzer.constant_case_value(value) for value, _ in entries]
+        dense = False
+        if entries and all(isinstance(v, int) and not isinstance(v, bool) for v in int_labels):
+            low, high = min(int_labels), max(int_labels)
+            span = high - low + 1
+            dense = (span <= self.SWITCH_MAX_TABLE_SPAN and
+                     len(entries) / span >= self.SWITCH_DENSITY_THRESHOLD)
+        
+        if dense:
+            slots = [default_name] * span
+            for label, (_, name) in zip(int_labels, entries):
+                slots[label - low] = name
+            self.emit(f"{prefix}_table = ({', '.join(slots)},)")
+        else:
+            pairs = ', '.join(f"{self.generate_expression(value)}: {name}" for value, name in entries)
+            self.emit(f"{prefix}_table = {{{pairs}}}")
+        
+        self.jump_targets.pop()
+        self.output, self.indent_level = saved_output, saved_indent
+        
+        # Dispatch
+        if dense and not isinstance(node.expression, (Identifier, Literal)):
+            self.emit(f"{prefix}_v = {value_code}")
+            value_code = f"{prefix}_v"
+        if dense:
+            index = value_code if low == 0 else f"{value_code} - {low}"
+            call = f"({prefix}_table[{index}] if {low} <= {value_code} <= {high} else {default_name})()"
+        else:
+            call = f"{prefix}_table.get({value_code}, {default_name})()"
+        
+        all_statements = [stmt for case in node.cases for stmt in case.statements]
+        may_continue = self.switch_may_continue(all_statements)
+        may_return = not self.in_main_function and any(
+            isinstance(n, ReturnStatement) for n in walk(all_statements))
+        
+        if not (may_continue or may_return):
+            self.emit(call)
+            return
+        
+        self.emit(f"{prefix}_r = {call}")
+        if self.jump_targets and self.jump_targets[-1][0] == 'switch':
+            # Directly inside another case closure: propagate to its dispatch site
+            self.emit(f"if {prefix}_r is not None:")
+            self.increase_indent()
+            self.emit(f"return {prefix}_r")
+            self.decrease_indent()
+            return
+        if may_continue:
+            # The innermost jump target is a loop in this closure or def
+            self.emit(f"if {prefix}_r is CPP_SWITCH_CONTINUE:")
+            self.increase_indent()
+            self.emit_loop_continue()
+            self.decrease_indent()
+        if may_return:
+            self.emit(f"if {prefix}_r is not None:")
+            self.increase_indent()
+            # Still wrapped inside an outer switch's case closure
+            self.emit(f"return {prefix}_r" if self.in_switch_closure() else f"return {prefix}_r[0]")
+            self.decrease_indent()
+    
+    def generate_expression(self, node: Expression) -> str:
+        """Generate code for an expression, converted to the type its context expects"""
+        handler = self.expression_handlers[type(node)]
+        if handler is None:
             return f"# Unsupported expression: {type(node)}"
+        code = handler(self, node)
+        target_type = node.converted_type
+        if target_type:
+            code = self.convert_arithmetic(node, code, target_type)
+        return code
+    
+    def convert_arithmetic(self, node: Expression, code: str, target_type: str) -> str:
+        """Apply the implicit C++ conversion of node's value to target_type"""
+        source_type = node.static_type
+        if target_type == 'float':
+            if isinstance(node, Literal):
+                return float_literal(round_to_float32(float(node.value)))
+            return f"{self.global_ref('cpp_float32')}({code})"
+        if target_type == 'double':
+            if source_type in INTEGER_WRAP_MASKS:
+                return repr(float(node.value)) if isinstance(node, Literal) else f"{self.global_ref('float')}({code})"
+            return code
+        if source_type in ('float', 'double'):
+            # Truncates toward zero; out-of-range values are undefined in C++
+            return f"{self.global_ref('int')}({code})"
+        if not self.ranges.fits(node, target_type):
+            return self.wrap_integer(code, target_type)
+        return code
     
+    def wrap_integer(self, code: str, type_name: str) -> str:
+        """Wrap an exact integer result to the width of type_name"""
+        bias, mask = INTEGER_WRAP_MASKS[type_name]
+        return f"(({code} + {bias} & {mask}) - {bias})"
+    
+    @handles('expression', Literal)
     def generate_literal(self, node: Literal) -> str:
         """Generate code for a literal"""
         if node.type_name == 'string':
@@ -391,15 +1063,60 @@ class CodeGenerator:
             return repr(node.value)
         elif node.type_name == 'bool':
             return str(node.value)
+        elif node.type_name == 'float':
+            return float_literal(round_to_float32(node.value))
+        elif node.type_name == 'double':
+            return float_literal(node.value)
         else:
-            return str(node.value)
+            return repr(node.value)
     
+    @handles('expression', Identifier)
     def generate_identifier(self, node: Identifier) -> str:
         """Generate code for an identifier"""
-        return node.name
+        if node.name in INPUT_STREAMS:
+            # cin on its own is tested for whether its reads succeeded
+            return f"{self.global_ref('cin')}.good"
+        if node.name.startswith('std::'):
+            return node.name.replace('::', '.')
+        code = node.name
+        if self.current_class and node.name not in self.function_locals:
+            # Inside a member function, bare member names refer to this object
+            if node.name == 'this':
+                code = 'self'
+            elif any(member.name == node.name for member in self.current_class.members):
+                code = f"self.{member_attribute(node.name)}"
+        if node in self.analyzer.value_copies:
+            code += "._cpp_copy()"
+        return code
+    
+    @handles('expression', MemberAccess)
+    def generate_member_access(self, node: MemberAccess) -> str:
+        """Generate code for a data member access"""
+        code = f"{self.generate_expression(node.obj)}.{member_attribute(node.member)}"
+        if node in self.analyzer.value_copies:
+            code += "._cpp_copy()"
+        return code
+    
+    @handles('expression', MethodCall)
+    def generate_method_call(self, node: MethodCall) -> str:
+        """Generate code for a member function call"""
+        obj_code = self.generate_expression(node.obj)
+        args_str = ", ".join(self.generate_expression(arg) for arg in node.arguments)
+        return f"{obj_code}.{node.name}({args_str})"
     
+    @handles('expression', BinaryOperation)
     def generate_binary_operation(self, node: BinaryOperation) -> str:
         """Generate code for a binary operation"""
+        if node.operator == '>>':
+            return self.generate_extraction(node)
+        result_type = node.static_type
+        if result_type in INTEGER_WRAP_MASKS and node.operator in ['+', '-', '*']:
+            # Wrapping commutes with + - *, so operands that are themselves
+            # + - * of the same type leave their mask to this node
+            for operand in (node.left, node.right):
+                if (isinstance(operand, BinaryOperation) and operand.operator in ['+', '-', '*']
+                        and operand.static_type == result_type and operand.converted_type is None):
+                    self.deferred_wraps.add(operand)
         left_code = self.generate_expression(node.left)
         right_code = self.generate_expression(node.right)
         
@@ -412,7 +1129,7 @@ class CodeGenerator:
             '+': '+',
             '-': '-',
             '*': '*',
-            '/': '//',  # Integer division for int types
+            '/': '/',
             '%': '%',
             '==': '==',
             '!=': '!=',
@@ -426,13 +1143,31 @@ class CodeGenerator:
         
         python_op = operator_map.get(node.operator, node.operator)
         
-        # Handle special cases
-        if node.operator == '/':
-            # Check if we need float division
-            return f"({left_code} / {right_code})"
+        if result_type in INTEGER_WRAP_MASKS:
+            if node.operator in ['/', '%']:
+                # Floor and truncating division agree on non-negative operands
+                if self.ranges.is_non_negative(node.left) and self.ranges.is_non_negative(node.right):
+                    python_op = '//' if node.operator == '/' else '%'
+                    return f"({left_code} {python_op} {right_code})"
+                helper = self.global_ref('cpp_idiv' if node.operator == '/' else 'cpp_imod')
+                return f"{helper}({left_code}, {right_code})"
+            code = f"({left_code} {python_op} {right_code})"
+            if (self.ranges.needs_wrap(node) or node.left in self.unwrapped_results
+                    or node.right in self.unwrapped_results):
+                if node in self.deferred_wraps:
+                    self.unwrapped_results.add(node)
+                else:
+                    code = self.wrap_integer(code, result_type)
+            return code
         
-        return f"({left_code} {python_op} {right_code})"
+        code = f"({left_code} {python_op} {right_code})"
+        if node.operator == '/' and not (isinstance(node.right, Literal) and node.right.value):
+            code = f"{self.global_ref('cpp_fdiv')}({left_code}, {right_code})"
+        if result_type == 'float' and node.operator in ['+', '-', '*', '/']:
+            code = f"{self.global_ref('cpp_float32')}({code})"
+        return code
     
+    @handles('expression', UnaryOperation)
     def generate_unary_operation(self, node: UnaryOperation) -> str:
         """Generate code for a unary operation"""
         operand_code = self.generate_expression(node.operand)
@@ -440,32 +1175,37 @@ class CodeGenerator:
         if node.operator == '!':
             return f"(not {operand_code})"
         elif node.operator == '-':
-            return f"(-{operand_code})"
+            code = f"(-{operand_code})"
+            if self.ranges.needs_wrap(node):
+                code = self.wrap_integer(code, node.static_type)
+            return code
         elif node.operator == '+':
             return f"(+{operand_code})"
-        elif node.operator == '++':
-            # Pre-increment
-            self.emit(f"{operand_code} += 1")
+        elif node.operator in ['++', '--']:
+            # Pre-increment/decrement
+            self.emit_step(node, operand_code)
             return operand_code
-        elif node.operator == '--':
-            # Pre-decrement
-            self.emit(f"{operand_code} -= 1")
-            return operand_code
-        elif node.operator == '++_post':
-            # Post-increment
+        elif node.operator in ['++_post', '--_post']:
+            # Post-increment/decrement
             temp_var = self.get_temp_var()
             self.emit(f"{temp_var} = {operand_code}")
-            self.emit(f"{operand_code} += 1")
-            return temp_var
-        elif node.operator == '--_post':
-            # Post-decrement
-            temp_var = self.get_temp_var()
-            self.emit(f"{temp_var} = {operand_code}")
-            self.emit(f"{operand_code} -= 1")
+            self.emit_step(node, operand_code)
             return temp_var
         
         return f"({node.operator}{operand_code})"
     
+    def emit_step(self, node: UnaryOperation, operand_code: str):
+        """Emit the update of an increment or decrement"""
+        sign = '+' if node.operator.startswith('++') else '-'
+        operand_type = node.static_type
+        if operand_type == 'float':
+            self.emit(f"{operand_code} = {self.global_ref('cpp_float32')}({operand_code} {sign} 1)")
+        elif operand_type in INTEGER_WRAP_MASKS and self.ranges.needs_wrap(node):
+            self.emit(f"{operand_code} = {self.wrap_integer(f'({operand_code} {sign} 1)', operand_type)}")
+        else:
+            self.emit(f"{operand_code} {sign}= 1")
+    
+    @handles('expression', Assignment)
     def generate_assignment(self, node: Assignment) -> str:
         """Generate code for an assignment"""
         target_code = self.generate_expression(node.target)
@@ -475,6 +1215,7 @@ class CodeGenerator:
         self.emit(assignment)
         return target_code
     
+    @handles('expression', FunctionCall)
     def generate_function_call(self, node: FunctionCall) -> str:
         """Generate code for a function call"""
         # Handle special built-in functions
@@ -486,13 +1227,96 @@ class CodeGenerator:
             else:
                 return "cout"
         
+        if node.intrinsic:
+            return self.generate_intrinsic_call(node, node.intrinsic)
+        
         # Regular function call
         arg_codes = []
         for arg in node.arguments:
             arg_codes.append(self.generate_expression(arg))
         
         args_str = ", ".join(arg_codes)
-        return f"{node.name}({args_str})"
+        if (self.current_class and node.name not in self.function_locals
+                and any(method.name == node.name for method in self.current_class.methods)):
+            return f"self.{node.name}({args_str})"
+        if node.name in self.function_locals:
+            return f"{node.name}({args_str})"
+        return f"{self.global_ref(node.name)}({args_str})"
+    
+    def generate_intrinsic_call(self, node: FunctionCall, intrinsic: Intrinsic) -> str:
+        """Lower a <cmath> call to math module calls and operators
+        
+        pow(x, 2) becomes x * x, which is exact where pow is correctly
+        rounded. Pure calls on constant arguments are folded.
+        """
+        arguments = node.arguments
+        templates = intrinsic.templates()
+        if intrinsic.name == 'pow' and isinstance(arguments[1], Literal) and arguments[1].value == 2:
+            arguments, templates = arguments[:1], ["({0} * {0})"]
+        result_type = node.static_type
+        constants = [self.constant_value(arg) for arg in arguments]
+        if intrinsic.pure and None not in constants:
+            value = fold(self.instantiate(templates, [float_literal(value) if isinstance(value, float) else repr(value)
+                                                      for value in constants], {}))
+            if value is not None:
+                if result_type == 'float':
+                    value = round_to_float32(value)
+                return float_literal(value) if isinstance(value, float) else repr(value)
+        arg_codes = [self.generate_expression(arg) for arg in arguments]
+        
+        # Bind arguments that are read more than once and are not plain names
+        bound = {}
+        for index, code in enumerate(arg_codes):
+            placeholder = f"{{{index}}}"
+            if (sum(template.count(placeholder) for template in templates) > 1
+                    and constants[index] is None and not code.isidentifier()):
+                bound[index] = self.get_temp_var()
+        # Module-level names, localized inside loops
+        templates = [re.sub(r'math\.\w+|\b[A-Za-z_]\w*(?=\()', lambda match: self.global_ref(match.group()), template)
+                     for template in templates]
+        code = self.instantiate(templates, arg_codes, bound)
+        if result_type == 'float' and not intrinsic.float_exact:
+            code = f"{self.global_ref('cpp_float32')}({code})"
+        return code
+    
+    def instantiate(self, templates: List[str], arg_codes: List[str], bound: Dict[int, str]) -> str:
+        """Fill intrinsic templates (guard, lowering, fallback) with argument code
+        
+        The first occurrence of a bound argument assigns its temporary.
+        """
+        assigned = set()
+        def argument(match) -> str:
+            index = int(match.group(1))
+            if index not in bound:
+                return f"({arg_codes[index]})" if not arg_codes[index].isidentifier() else arg_codes[index]
+            if index in assigned:
+                return bound[index]
+            assigned.add(index)
+            return f"({bound[index]} := {arg_codes[index]})"
+        parts = [re.sub(r'\{(\d)\}', argument, template) for template in templates]
+        if len(parts) == 1:
+            return parts[0]
+        guard, lowering, fallback = parts
+        return f"({lowering} if {guard} else {fallback})"
+    
+    def constant_value(self, node: Expression) -> Optional[Union[int, float]]:
+        """The value of a numeric literal, possibly negated, after its implicit conversion"""
+        if isinstance(node, UnaryOperation) and node.operator in ['-', '+']:
+            value = self.constant_value(node.operand)
+            if value is None:
+                return None
+            value = -value if node.operator == '-' else value
+        elif isinstance(node, Literal) and node.type_name in ['int', 'long', 'bool', 'float', 'double']:
+            value = node.value
+            if node.type_name == 'float':
+                value = round_to_float32(value)
+        else:
+            return None
+        if node.converted_type in ['float', 'double']:
+            value = float(value)
+            if node.converted_type == 'float':
+                value = round_to_float32(value)
+        return value
     
     def execute(self) -> tuple[str, int]:
         """Execute the generated code and return output and exit code"""
@@ -529,6 +1353,10 @@ class CppRuntime:
         """Handle cout << value"""
         if isinstance(value, str) and value.startswith('"') and value.endswith('"'):
             value = value[1:-1]  # Remove quotes
+        elif isinstance(value, bool):
+            value = int(value)
+        elif isinstance(value, float):
+            value = '%g' % value  # default ostream precision
         self.output_buffer.append(str(value))
         return self
     
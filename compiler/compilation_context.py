@@ -0,0 +1,43 @@
+"""
+C++ Compilation Context
+The settings of one compilation, passed to every phase instead of being read
+from a shared compiler object, so compilations with different options can run
+concurrently in threads or worker processes.
+"""
+
+from dataclasses import dataclass, replace
+
+# Execution engines: generated Python code, closures built from the AST
+# (closure_compiler.py), or whichever suits the program
+ENGINES = ('exec', 'closure', 'auto')
+
+@dataclass(frozen=True)
+class CompilationContext:
+    """Immutable per-compilation options"""
+    filename: str = "<input>"
+    verbose: bool = False
+    show_tokens: bool = False
+    show_ast: bool = False
+    show_generated_code: bool = False
+    # Skip analysis of functions main can't reach (see call_graph.py), so
+    # errors in them are not reported
+    fast_analysis: bool = False
+    engine: str = 'exec'
+
+    def with_options(self, **changes) -> 'CompilationContext':
+        """Copy of this context with some options changed"""
+        return replace(self, **changes)
+
+    @classmethod
+    def from_request(cls, data: dict, default_filename: str = "input.cpp") -> 'CompilationContext':
+        """Context for an API request body"""
+        return cls(
+            filename=str(data.get('filename') or default_filename),
+            verbose=bool(data.get('verbose', False)),
+            show_generated_code=bool(data.get('show_generated_code', False)),
+            fast_analysis=bool(data.get('fast_analysis', False)),
+            # Unknown engines get the default
+            engine=data.get('engine') if data.get('engine') in ENGINES else 'exec'
+        )
+
+DEFAULT_CONTEXT = CompilationContext()
@@ -0,0 +1,51 @@
+#include <iostream>
+using namespace std;
+
+struct Point {
+    int x;
+    int y;
+};
+
+class Counter {
+public:
+    Counter() : count(0), step(1) {}
+    Counter(int start, int s) : count(start), step(s) {}
+    
+    void tick() {
+        count = count + step;
+    }
+    
+    int value() {
+        return count;
+    }
+    
+private:
+    int count;
+    int step;
+};
+
+Point shifted(Point p, int dx) {
+    p.x = p.x + dx;
+    return p;
+}
+
+int main() {
+    // Structs are values: copies don't alias
+    Point a = {1, 2};
+    Point b = a;
+    b.x = 10;
+    cout << "a.x = " << a.x << ", b.x = " << b.x << endl;
+    
+    Point c = shifted(a, 5);
+    cout << "a.x = " << a.x << ", shifted x = " << c.x << endl;
+    
+    Counter slow;
+    Counter fast(100, 25);
+    for (int i = 0; i < 3; i = i + 1) {
+        slow.tick();
+        fast.tick();
+    }
+    cout << "slow = " << slow.value() << ", fast = " << fast.value() << endl;
+    
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <iostream>
+using namespace std;
+
+int daysInMonth(int month) {
+    int days = 31;
+    switch (month) {
+        case 2:
+            days = 28;
+            break;
+        case 4:
+        case 6:
+        case 9:
+        case 11:
+            days = 30;
+            break;
+    }
+    return days;
+}
+
+int main() {
+    for (int month = 1; month <= 12; month = month + 1) {
+        cout << "Month " << month << " has " << daysInMonth(month) << " days" << endl;
+    }
+    
+    // Fallthrough accumulates every case below the entry point
+    int level = 2;
+    int bonus = 0;
+    switch (level) {
+        case 3:
+            bonus = bonus + 100;
+        case 2:
+            bonus = bonus + 10;
+        case 1:
+            bonus = bonus + 1;
+            break;
+        default:
+            bonus = -1;
+    }
+    cout << "Bonus for level " << level << ": " << bonus << endl;
+    
+    return 0;
+}
@@ -6,6 +6,7 @@ This module tokenizes C++ source code into meaningful tokens.
 import re
 from enum import Enum, auto
 from typing import List, NamedTuple, Optional
+from compilation_context import CompilationContext, DEFAULT_CONTEXT
 
 class TokenType(Enum):
     # Keywords
@@ -77,6 +78,7 @@ class TokenType(Enum):
     INCREMENT = auto()
     DECREMENT = auto()
     LEFT_SHIFT = auto()
+    RIGHT_SHIFT = auto()
     AMPERSAND = auto()
     
     # Punctuation
@@ -109,8 +111,9 @@ class Token(NamedTuple):
     column: int
 
 class Lexer:
-    def __init__(self, source_code: str):
+    def __init__(self, source_code: str, context: Optional[CompilationContext] = None):
         self.source_code = source_code
+        self.context = context or DEFAULT_CONTEXT
         self.position = 0
         self.line = 1
         self.column = 1
@@ -259,6 +262,32 @@ class Lexer:
             value += self.current_char()
             self.advance()
         
+        # Exponent (1e9, 2.5E-3)
+        if self.current_char() and self.current_char() in 'eE':
+            exponent = self.current_char()
+            offset = 1
+            if self.peek_char() and self.peek_char() in '+-':
+                exponent += self.peek_char()
+                offset = 2
+            if self.peek_char(offset) and self.peek_char(offset).isdigit():
+                for _ in range(offset):
+                    self.advance()
+                value += exponent
+                while self.current_char() and self.current_char().isdigit():
+                    value += self.current_char()
+                    self.advance()
+                token_type = TokenType.FLOAT_LITERAL
+        
+        # Suffixes are kept in the token value: f/F marks a float literal,
+        # l/L/ll/LL a long integer literal
+        if token_type == TokenType.FLOAT_LITERAL and self.current_char() and self.current_char() in 'fF':
+            value += self.current_char()
+            self.advance()
+        elif token_type == TokenType.INTEGER_LITERAL:
+            while self.current_char() and self.current_char() in 'lL':
+                value += self.current_char()
+                self.advance()
+        
         return value, token_type
     
     def read_identifier(self) -> str:
@@ -394,6 +423,11 @@ class Lexer:
                 self.advance()
                 self.advance()
                 continue
+            elif two_char == '>>':
+                tokens.append(Token(TokenType.RIGHT_SHIFT, '>>', start_line, start_column))
+                self.advance()
+                self.advance()
+                continue
             
             # Handle single character tokens
             if self.current_char() in self.single_char_tokens:
@@ -6,25 +6,46 @@ Usage:
     python main.py <source_file>    # Compile file
     python main.py                  # Interactive mode  
     python main.py --api           # Start Flask web API
+    python main.py --api --async   # Start the asyncio web API with worker processes
+    python main.py --api --prefork # Start prefork asyncio servers sharing one port and cache
 """
 
 import sys
 import os
 import json
+import threading
+import time
 import traceback
+from concurrent.futures import ProcessPoolExecutor
 from pathlib import Path
 from io import StringIO
-from contextlib import redirect_stdout, redirect_stderr
-
-# Web framework imports
-from flask import Flask, request, jsonify
-from flask_cors import CORS
+from contextlib import contextmanager, nullcontext
+from functools import lru_cache, partial
 
 # Import compiler modules
 from lexer import Lexer, TokenType
 from parser import Parser
 from semantic_analyzer import SemanticAnalyzer
 from code_generator import CodeGenerator
+from call_graph import CallGraph
+from compilation_context import CompilationContext
+from custom_language import LanguageStore, register_response, translate_request
+from examples_store import ExampleStore
+from judge import (ACCEPTED, OUTPUT_LIMIT_EXCEEDED, RUNTIME_ERROR, TIME_LIMIT_EXCEEDED, WRONG_ANSWER,
+                   CappedOutput, JudgeLimits, JudgeTest, OutputLimitExceeded, TimeLimitExceeded,
+                   compile_failure, judgement, outputs_match, parse_judge_request, test_result,
+                   time_limit)
+from output_capture import HeadTailBuffer, output_dropped
+from rate_limit import (AdmissionLimits, RateLimiter, client_key, known_token, retry_after,
+                        too_large, too_many_requests)
+from readiness import ReadinessThresholds, RequestStats, check_readiness
+from scheduler import BATCH, SPECULATIVE, FairScheduler, request_class
+from source_deltas import SOURCE_HASH_HEADER, SourceStore, resolve_source
+from speculation import (CACHED, COMPILED, SKIPPED, SPECULATIVE_HEADER, TIMED_OUT, ResultCache,
+                         is_speculative, result_key, run_speculatively, skipped_response,
+                         timed_out_response)
+from repl import ReplSession, ReplError
+import warm_up
 
 class CppCompiler:
     """Main C++ Compiler class"""
@@ -36,6 +57,16 @@ class CppCompiler:
         self.show_ast = False
         self.show_generated_code = False
     
+    def context(self, filename: str = "<input>") -> CompilationContext:
+        """Snapshot of the current settings for one compilation"""
+        return CompilationContext(
+            filename=filename,
+            verbose=self.verbose,
+            show_tokens=self.show_tokens,
+            show_ast=self.show_ast,
+            show_generated_code=self.show_generated_code
+        )
+    
     def compile_file(self, source_file: str) -> bool:
         """Compile a C++ source file"""
         try:
@@ -54,58 +85,61 @@ class CppCompiler:
     
     def compile_source(self, source_code: str, filename: str = "<input>") -> bool:
         """Compile C++ source code"""
+        context = self.context(filename)
         try:
             print(f"Compiling {filename}...")
             
             # Phase 1: Lexical Analysis
-            if self.verbose:
+            if context.verbose:
                 print("Phase 1: Lexical Analysis...")
             
-            lexer = Lexer(source_code)
+            lexer = Lexer(source_code, context)
             tokens = lexer.tokenize()
             
-            if self.show_tokens:
+            if context.show_tokens:
                 self.print_tokens(tokens)
             
             # Phase 2: Syntax Analysis (Parsing)
-            if self.verbose:
+            if context.verbose:
                 print("Phase 2: Syntax Analysis...")
             
-            parser = Parser(tokens)
+            parser = Parser(tokens, context)
             ast = parser.parse()
             
-            if self.show_ast:
+            if context.show_ast:
                 self.print_ast(ast)
             
             # Phase 3: Semantic Analysis
-            if self.verbose:
+            if context.verbose:
                 print("Phase 3: Semantic Analysis...")
             
-            analyzer = SemanticAnalyzer()
+            analyzer = SemanticAnalyzer(context)
             if not analyzer.analyze(ast):
                 print("Compilation failed with semantic errors:")
                 for error in analyzer.errors:
                     print(f"  {error}")
                 return False
             
-            if self.verbose:
+            if context.verbose:
                 print("Semantic analysis passed!")
             
             # Phase 4: Code Generation
-            if self.verbose:
+            if context.verbose:
                 print("Phase 4: Code Generation...")
             
-            generator = CodeGenerator(analyzer)
+            generator = CodeGenerator(analyzer, context)
             generated_code = generator.generate(ast)
+            if context.verbose:
+                print(generator.call_graph.report(bool(analyzer.skipped_functions)))
             
-            if self.show_generated_code:
+            if context.show_generated_code:
                 print("\nGenerated Code:")
                 print("=" * 50)
                 print(generated_code)
                 print("=" * 50)
             
             # Phase 5: Execution
-            if self.verbose:
+            if context.verbose:
                 print("Phase 5: Execution...")
             
             print(f"\nExecuting {filename}:")
@@ -154,6 +188,7 @@ class CppCompiler:
         print("Enter C++ code (type 'EXIT' to quit, 'HELP' for commands):")
         print("-" * 50)
         
+        session = ReplSession()
         buffer = []
         
         while True:
@@ -172,6 +207,11 @@ class CppCompiler:
                     buffer.clear()
                     print("Buffer cleared.")
                     continue
+                elif line.strip().upper() == 'RESET':
+                    session = ReplSession()
+                    buffer.clear()
+                    print("Session reset.")
+                    continue
                 elif line.strip().upper() == 'TOKENS':
                     self.show_tokens = not self.show_tokens
                     print(f"Token display: {'ON' if self.show_tokens else 'OFF'}")
@@ -190,38 +230,62 @@ class CppCompiler:
                     continue
                 elif line.strip().upper() == 'RUN':
                     if buffer:
-                        source_code = '\n'.join(buffer)
-                        print("\nCompiling and running...")
-                        self.compile_source(source_code, "<interactive>")
+                        self.run_entry(session, '\n'.join(buffer))
                         buffer.clear()
                     else:
                         print("Buffer is empty. Enter some C++ code first.")
                     continue
                 
+                # An if waits for the next line; without an else there, it runs first
+                if buffer and session.awaits_else('\n'.join(buffer)) and not session.continues_if(line):
+                    self.run_entry(session, '\n'.join(buffer))
+                    buffer.clear()
+                
                 buffer.append(line)
                 
-                # Try to compile when we have a complete program
+                # Run each entry as soon as it is a complete declaration or statement
                 source_code = '\n'.join(buffer)
-                if self.is_complete_program(source_code):
-                    print("\nCompiling and running...")
-                    if self.compile_source(source_code, "<interactive>"):
-                        buffer.clear()
-                    else:
-                        print("Keep the code in buffer. Type 'CLEAR' to clear or continue editing.")
+                if source_code.strip() and session.is_complete(source_code):
+                    self.run_entry(session, source_code)
+                    buffer.clear()
                 
             except KeyboardInterrupt:
                 print("\nUse 'EXIT' to quit.")
             except EOFError:
+                if buffer and session.awaits_else('\n'.join(buffer)):
+                    print()
+                    self.run_entry(session, '\n'.join(buffer))
                 print("\nGoodbye!")
                 break
     
-    def is_complete_program(self, source_code: str) -> bool:
-        """Check if the source code looks like a complete program"""
-        # Simple heuristic: check for main function and balanced braces
-        has_main = 'int main()' in source_code or 'int main(' in source_code
-        open_braces = source_code.count('{')
-        close_braces = source_code.count('}')
-        return has_main and open_braces > 0 and open_braces == close_braces
+    def run_entry(self, session: 'ReplSession', source_code: str) -> bool:
+        """Compile and run one interactive entry, printing its output or errors"""
+        start = time.perf_counter()
+        error = None
+        try:
+            output = session.execute(source_code)
+        except ReplError as e:
+            error = e
+            output = e.output
+        
+        if self.show_tokens and session.last_tokens:
+            self.print_tokens(session.last_tokens)
+        if self.show_ast and session.last_items:
+            self.print_ast(session.last_items)
+        if self.show_generated_code and session.last_code:
+            print("\nGenerated Code:")
+            print("=" * 50)
+            print(session.last_code)
+            print("=" * 50)
+        
+        print(output, end='' if output.endswith('\n') or not output else '\n')
+        if error:
+            print(error)
+            for detail in error.details:
+                print(f"  {detail}")
+        if self.verbose:
+            print(f"[entry {session.entry_count}: {(time.perf_counter() - start) * 1000:.2f} ms]")
+        return error is None
     
     def show_help(self):
         """Show help information"""
@@ -229,191 +293,618 @@ class CppCompiler:
         print("  EXIT     - Exit the compiler")
         print("  HELP     - Show this help")
         print("  CLEAR    - Clear the input buffer")
+        print("  RESET    - Start a new session, forgetting all declarations")
         print("  RUN      - Compile and run current buffer")
         print("  TOKENS   - Toggle token display")
         print("  AST      - Toggle AST display")
         print("  CODE     - Toggle generated code display")
         print("  VERBOSE  - Toggle verbose mode")
-        print("\nEnter C++ code and it will be compiled automatically when complete.")
+        print("\nEach declaration or statement runs as soon as it is complete; functions,")
+        print("classes and variables are kept for later entries. Entering a function")
+        print("again replaces it, and entering main runs it.")
         print()
     
     def compile_source_api(self, source_code: str, filename: str = "<api_input>") -> dict:
-        """Compile C++ source code and return result as dictionary for API"""
-        try:
-            # Capture all output
-            stdout_buffer = StringIO()
-            stderr_buffer = StringIO()
-            
-            with redirect_stdout(stdout_buffer), redirect_stderr(stderr_buffer):
-                # Phase 1: Lexical Analysis
-                lexer = Lexer(source_code)
-                tokens = lexer.tokenize()
-                
-                # Phase 2: Syntax Analysis (Parsing)
-                parser = Parser(tokens)
-                ast = parser.parse()
-                
-                # Phase 3: Semantic Analysis
-                analyzer = SemanticAnalyzer()
-                if not analyzer.analyze(ast):
-                    return {
-                        "success": False,
-                        "error": "Semantic Analysis Failed",
-                        "details": analyzer.errors,
-                        "output": "",
-                        "execution_output": ""
-                    }
-                
-                # Phase 4: Code Generation
-                generator = CodeGenerator(analyzer)
-                generated_code = generator.generate(ast)
-                
-                # Phase 5: Execution
-                execution_output = StringIO()
-                try:
-                    with redirect_stdout(execution_output):
-                        # Create isolated namespace for execution
-                        exec_globals = {
-                            '__name__': '__main__',
-                            '__builtins__': __builtins__,
-                        }
-                        exec(generated_code, exec_globals)
-                except SystemExit:
-                    # This is expected behavior - the program calls sys.exit()
-                    pass
-                except Exception as exec_error:
-                    return {
-                        "success": False,
-                        "error": f"Runtime Error: {str(exec_error)}",
-                        "details": [str(exec_error)],
-                        "output": stdout_buffer.getvalue(),
-                        "execution_output": execution_output.getvalue()
-                    }
-            
-            return {
-                "success": True,
-                "error": None,
-                "details": [],
-                "output": stdout_buffer.getvalue(),
-                "execution_output": execution_output.getvalue(),
-                "generated_code": generated_code if self.show_generated_code else None
-            }
-            
-        except SyntaxError as e:
-            return {
-                "success": False,
-                "error": f"Syntax Error: {str(e)}",
-                "details": [str(e)],
-                "output": "",
-                "execution_output": ""
-            }
-        except Exception as e:
-            return {
+        """Compile C++ source code with this compiler's settings, for API callers"""
+        return compile_source_api(source_code, self.context(filename))
+
+def compile_source_api(source_code: str, context: CompilationContext) -> dict:
+    """Compile and run C++ source code and return result as dictionary for API.
+
+    Everything request-specific comes from context and program output goes to
+    per-call buffers, so concurrent calls don't interfere.
+    """
+    if context.engine != 'exec' and not context.show_generated_code:
+        return run_closures_api(source_code, context)
+    generated_code, output, error = translate_api(source_code, context)
+    if error is not None:
+        return error
+    return execute_api(generated_code, context, output)
+
+def translate_api(source_code: str, context: CompilationContext) -> tuple:
+    """Run the compiler phases for the API.
+
+    Returns (generated_code, phase log, None) on success, or
+    (None, "", error result) when a phase fails.
+    """
+    analysis, output, error = analyze_api(source_code, context)
+    if error is not None:
+        return None, "", error
+    return generate_api(*analysis, context, output)
+
+def analyze_api(source_code: str, context: CompilationContext) -> tuple:
+    """Phases 1-3 for the API.
+
+    Returns ((ast, analyzer), phase log, None) on success, or
+    (None, "", error result) when a phase fails.
+    """
+    log = []
+    try:
+        # Phase 1: Lexical Analysis
+        if context.verbose:
+            log.append("Phase 1: Lexical Analysis...")
+        tokens = Lexer(source_code, context).tokenize()
+        
+        # Phase 2: Syntax Analysis (Parsing)
+        if context.verbose:
+            log.append("Phase 2: Syntax Analysis...")
+        ast = Parser(tokens, context).parse()
+        
+        # Phase 3: Semantic Analysis
+        if context.verbose:
+            log.append("Phase 3: Semantic Analysis...")
+        analyzer = SemanticAnalyzer(context)
+        if not analyzer.analyze(ast):
+            return None, "", {
                 "success": False,
-                "error": f"Compilation Error: {str(e)}",
-                "details": [str(e), traceback.format_exc()],
+                "error": "Semantic Analysis Failed",
+                "details": analyzer.errors,
                 "output": "",
                 "execution_output": ""
             }
+        return (ast, analyzer), "".join(line + "\n" for line in log), None
+    except Exception as e:
+        return None, "", compile_error_result(e)
+
+def generate_api(ast, analyzer: SemanticAnalyzer, context: CompilationContext, output: str = "") -> tuple:
+    """Phase 4 (code generation) for the API, with translate_api's results"""
+    try:
+        if context.verbose:
+            output += "Phase 4: Code Generation...\n"
+        generator = CodeGenerator(analyzer, context)
+        generated_code = generator.generate(ast)
+        if context.verbose:
+            output += generator.call_graph.report(bool(analyzer.skipped_functions)) + "\n"
+        return generated_code, output, None
+    except Exception as e:
+        return None, "", compile_error_result(e)
 
-# Initialize Flask app
-app = Flask(__name__)
-CORS(app)  # Enable CORS for Flutter app
-
-# Global compiler instance
-compiler = CppCompiler()
-
-@app.route('/', methods=['GET'])
-def home():
-    """Root endpoint"""
-    return jsonify({
-        "message": "C++ Compiler API",
-        "version": "1.0.0",
-        "endpoints": {
-            "/compile": "POST - Compile C++ code",
-            "/health": "GET - Health check"
+def compile_error_result(error: Exception) -> dict:
+    """The API result for an exception raised while compiling"""
+    if isinstance(error, SyntaxError):
+        return {
+            "success": False,
+            "error": f"Syntax Error: {str(error)}",
+            "details": [str(error)],
+            "output": "",
+            "execution_output": ""
         }
-    })
+    return {
+        "success": False,
+        "error": f"Compilation Error: {str(error)}",
+        "details": [str(error), traceback.format_exc()],
+        "output": "",
+        "execution_output": ""
+    }
 
-@app.route('/health', methods=['GET'])
-def health():
-    """Health check endpoint"""
-    return jsonify({"status": "healthy", "message": "Compiler API is running"})
+def run_closures_api(source_code: str, context: CompilationContext) -> dict:
+    """compile_source_api for the closure and auto engines
 
-@app.route('/compile', methods=['POST'])
-def compile_code():
-    """Compile C++ code endpoint"""
+    Runs on generated code instead when "auto" prefers it, when the program
+    uses something the closure engine does not implement, or when it
+    recurses deeper than closures can on the Python stack.
+    """
+    from closure_compiler import ClosureCompiler, ClosureUnsupported, choose_engine
+    analysis, output, error = analyze_api(source_code, context)
+    if error is not None:
+        return error
+    ast, analyzer = analysis
+    if analyzer.call_graph is None:
+        # Shared by the engine choice and whichever engine runs the program
+        analyzer.call_graph = CallGraph(ast)
     try:
-        # Get JSON data
-        data = request.get_json()
-        
-        if not data:
-            return jsonify({
-                "success": False,
-                "error": "No JSON data provided",
-                "details": ["Request must contain JSON data"]
-            }), 400
+        engine = choose_engine(ast, analyzer.call_graph, context.engine)
+        reason = "chosen by auto"
+        if engine == 'closure':
+            program = ClosureCompiler(analyzer, context).build(ast)
+    except ClosureUnsupported as unsupported:
+        engine, reason = 'exec', f"closures do not support {unsupported}"
+    except Exception as e:
+        return compile_error_result(e)
+    if engine == 'closure':
+        if context.verbose:
+            output += "Phase 4: Closure Compilation...\n"
+        try:
+            return execute_closures_api(program, context, output)
+        except RecursionError:
+            reason = "recursion too deep for closures"
+    if context.verbose:
+        output += f"Engine: exec ({reason})\n"
+    generated_code, output, error = generate_api(ast, analyzer, context, output)
+    if error is not None:
+        return error
+    return execute_api(generated_code, context, output)
+
+@lru_cache(maxsize=None)
+def runtime_support_code() -> tuple:
+    """The runtime support section every generated program starts with, and its code object"""
+    generator = CodeGenerator(SemanticAnalyzer())
+    generator.emit_runtime_support()
+    source = "\n".join(generator.output)
+    return source, compile(source, "<cpp runtime>", "exec")
+
+@lru_cache(maxsize=16)
+def compile_generated_code(generated_code: str, filename: str) -> tuple:
+    """The code objects generated code runs as, reusing the compiled runtime support section.
+
+    The runtime support is about 40% of the Python compile time of a typical
+    program, and it is the same for every program. Cached, so a judge worker
+    compiles a submission once for all the tests it runs.
+    """
+    support, support_code = runtime_support_code()
+    start = generated_code.find(support)
+    if start < 0:
+        return (compile(generated_code, filename, 'exec'),)
+    end = start + len(support)
+    # Pad with newlines so tracebacks keep the generated code's line numbers
+    padding = "\n" * generated_code.count("\n", 0, end)
+    return (compile(generated_code[:start], filename, 'exec'), support_code,
+            compile(padding + generated_code[end:], filename, 'exec'))
+
+def run_generated_code(generated_code: str, filename: str, exec_globals: dict):
+    """Execute generated code"""
+    for code in compile_generated_code(generated_code, filename):
+        exec(code, exec_globals)
+
+def execute_closures_api(program, context: CompilationContext, output: str = "") -> dict:
+    """Phase 5 for the closure engine: run a ClosureProgram and return the API result
+
+    RecursionError propagates, so the caller can run generated code instead.
+    """
+    if context.verbose:
+        output += "Phase 5: Execution...\n"
+    execution_output = HeadTailBuffer()
+    try:
+        program.run(execution_output)
+    except RecursionError:
+        raise
+    except Exception as exec_error:
+        return {
+            "success": False,
+            "error": f"Runtime Error: {str(exec_error)}",
+            "details": [str(exec_error)],
+            "output": output,
+            "execution_output": execution_output.getvalue(),
+            "truncated_output": execution_output.dropped
+        }
+    return {
+        "success": True,
+        "error": None,
+        "details": [],
+        "output": output,
+        "execution_output": execution_output.getvalue(),
+        "truncated_output": execution_output.dropped,
+        "generated_code": None
+    }
+
+def execute_api(generated_code: str, context: CompilationContext, output: str = "") -> dict:
+    """Phase 5: run generated code and return the API result"""
+    if context.verbose:
+        output += "Phase 5: Execution...\n"
+    execution_output = StringIO()
+    try:
+        # Create isolated namespace for execution. Generated code writes through
+        # print, so binding print to this call's buffer captures its output
+        # without swapping the process-wide sys.stdout
+        exec_globals = {
+            '__name__': '__main__',
+            '__builtins__': __builtins__,
+            'print': partial(print, file=execution_output),
+            # Keep only the head and tail of huge outputs
+            'cpp_output_buffer': HeadTailBuffer,
+            # Programs run here read an empty standard input
+            'cpp_stdin': '',
+        }
+        run_generated_code(generated_code, context.filename, exec_globals)
+    except SystemExit:
+        # This is expected behavior - the program calls sys.exit()
+        pass
+    except Exception as exec_error:
+        return {
+            "success": False,
+            "error": f"Runtime Error: {str(exec_error)}",
+            "details": [str(exec_error)],
+            "output": output,
+            "execution_output": execution_output.getvalue(),
+            "truncated_output": output_dropped(exec_globals)
+        }
+    
+    return {
+        "success": True,
+        "error": None,
+        "details": [],
+        "output": output,
+        "execution_output": execution_output.getvalue(),
+        "truncated_output": output_dropped(exec_globals),
+        "generated_code": generated_code if context.show_generated_code else None
+    }
+
+def judge_test(generated_code: str, filename: str, test: JudgeTest, limits: JudgeLimits,
+               comparison: str) -> dict:
+    """Run a compiled submission on one test and return its result (judge.test_result)
+
+    A module-level function of picklable arguments, so hosts can run it in
+    worker processes.
+    """
+    execution_output = StringIO()
+    exec_globals = {
+        '__name__': '__main__',
+        '__builtins__': __builtins__,
+        'print': partial(print, file=execution_output),
+        'cpp_output_buffer': partial(CappedOutput, limits.output_limit_bytes),
+        'cpp_stdin': test.input,
+    }
+    # Compiled before the clock starts; cached for the worker's later tests
+    code = compile_generated_code(generated_code, filename)
+    verdict, error = None, None
+    start = time.perf_counter()
+    try:
+        with time_limit(limits.time_limit_ms / 1000):
+            for section in code:
+                exec(section, exec_globals)
+    except SystemExit as exit_status:
+        if exit_status.code:
+            verdict, error = RUNTIME_ERROR, f"Exit status {exit_status.code}"
+    except TimeLimitExceeded:
+        verdict, error = TIME_LIMIT_EXCEEDED, f"Exceeded {limits.time_limit_ms} ms"
+    except OutputLimitExceeded:
+        verdict, error = OUTPUT_LIMIT_EXCEEDED, f"Printed more than {limits.output_limit_bytes} characters"
+    except Exception as exec_error:
+        verdict, error = RUNTIME_ERROR, f"Runtime Error: {str(exec_error)}"
+    seconds = time.perf_counter() - start
+    output = execution_output.getvalue()
+    if not output and 'cpp_runtime' in exec_globals:
+        # Stopped before main returned: what it had printed so far
+        output = exec_globals['cpp_runtime'].get_output()
+    if verdict is None:
+        verdict = ACCEPTED if outputs_match(output, test.expected, comparison) else WRONG_ANSWER
+    return test_result(test, verdict, seconds, output, error)
+
+def judge_api(source_code: str, tests: list, context: CompilationContext, limits: JudgeLimits,
+              comparison: str, map_tests=map, compile_slot=nullcontext) -> dict:
+    """Compile a submission once and judge it on every test
+
+    map_tests runs judge_test over the tests, in order: the builtin map runs
+    them here, scheduled_map fans them out to a process pool. compile_slot()
+    is held while compiling. Tests run on generated code whatever the
+    context's engine, since only code can be sent to another process.
+    """
+    start = time.perf_counter()
+    with compile_slot():
+        generated_code, _, error = translate_api(source_code, context)
+    if error is not None:
+        return compile_failure(error, len(tests))
+    compiled = time.perf_counter()
+    results = list(map_tests(partial(judge_test, generated_code, context.filename,
+                                     limits=limits, comparison=comparison), tests))
+    return judgement(results, (compiled - start) * 1000, (time.perf_counter() - start) * 1000)
+
+def acquire_slot(scheduler: FairScheduler, stats: RequestStats, job_class: str):
+    """scheduler.acquire(job_class), with the wait counted in stats' queue"""
+    waiting = stats.queued()
+    try:
+        return scheduler.acquire(job_class)
+    finally:
+        stats.dequeued(waiting)
+
+@contextmanager
+def scheduled(scheduler: FairScheduler, stats: RequestStats, job_class: str):
+    """Hold a scheduler slot of job_class, counted in stats, for the block"""
+    ticket = acquire_slot(scheduler, stats, job_class)
+    token = stats.start()
+    success = False
+    try:
+        yield
+        success = True
+    finally:
+        scheduler.release(ticket, success)
+        stats.finish(token, success)
+
+def scheduled_map(scheduler: FairScheduler, stats: RequestStats, job_class: str, pool):
+    """A map_tests for judge_api that runs each test in pool while it holds a scheduler slot
+
+    The pool's processes only do work the scheduler granted, so judging
+    shares the scheduler's capacity with every other request.
+    """
+    def map_tests(function, tests):
+        futures = []
+        for test in tests:
+            ticket = acquire_slot(scheduler, stats, job_class)
+            token = stats.start()
+            try:
+                future = pool.submit(function, test)
+            except BaseException:
+                scheduler.release(ticket, False)
+                stats.finish(token, False)
+                raise
+
+            def finished(future, ticket=ticket, token=token):
+                success = not future.cancelled() and future.exception() is None
+                scheduler.release(ticket, success)
+                stats.finish(token, success)
+            future.add_done_callback(finished)
+            futures.append(future)
+        return [future.result() for future in futures]
+    return map_tests
+
+# Example programs, loaded and compiled once when the server starts
+example_store = ExampleStore('./examples', compile_source_api)
+
+# Compiles allowed to run at once in request threads, shared fairly between
+# interactive, examples and batch requests
+COMPILE_CONCURRENCY = int(os.environ.get('COMPILE_CONCURRENCY', 4))
+compile_scheduler = FairScheduler(COMPILE_CONCURRENCY)
+
+# Per-client /compile rate limit and request size caps
+admission_limits = AdmissionLimits.from_environment()
+rate_limiter = RateLimiter(admission_limits.rate, admission_limits.burst)
+# Limits of /judge tests, and the worker processes that run them, started on
+# the first /judge request. Tests take compile_scheduler slots, so the pool
+# never runs more than the scheduler grants
+judge_limits = JudgeLimits.from_environment()
+_judge_pool = None
+_judge_pool_lock = threading.Lock()
+
+def judge_pool():
+    """The process pool /judge runs tests in"""
+    global _judge_pool
+    with _judge_pool_lock:
+        if _judge_pool is None:
+            _judge_pool = ProcessPoolExecutor(max_workers=COMPILE_CONCURRENCY)
+        return _judge_pool
+
+# Load statistics for /ready
+request_stats = RequestStats(workers=COMPILE_CONCURRENCY)
+ready_thresholds = ReadinessThresholds.from_environment()
+
+# Custom languages uploaded through /languages
+language_store = LanguageStore()
+# Programs clients submitted, the bases of their delta uploads
+source_store = SourceStore()
+# Results by program hash, filled by every compile including speculative ones
+result_cache = ResultCache()
+
+_app = None
+
+def create_app():
+    """Build the Flask API app.
+
+    Flask is imported here rather than at module level because it is most of
+    this module's import time, and the CLI and the asyncio server's workers
+    never use it.
+    """
+    # Web framework imports
+    from flask import Flask, Response, request, jsonify
+    from flask_cors import CORS
+    from werkzeug.exceptions import RequestEntityTooLarge
+    
+    app = Flask(__name__)
+    CORS(app, expose_headers=[SOURCE_HASH_HEADER, SPECULATIVE_HEADER])  # Enable CORS for Flutter app
+    # Werkzeug stops reading a body at this size, including chunked uploads
+    app.config['MAX_CONTENT_LENGTH'] = admission_limits.max_body_bytes
+
+    @app.before_request
+    def admit():
+        """Turn away oversized bodies and clients over their rate before /compile or /judge reads anything"""
+        if request.method != 'POST' or request.endpoint not in ('compile_code', 'judge_code'):
+            return None
+        if request.content_length is not None and request.content_length > admission_limits.max_body_bytes:
+            return jsonify(too_large(admission_limits.max_body_bytes)), 413
+        allowed, wait = rate_limiter.allow(client_key(admission_limits, request.remote_addr,
+                                                      request.headers.get('Authorization')))
+        if not allowed:
+            return jsonify(too_many_requests(wait)), 429, {'Retry-After': retry_after(wait)}
+        return None
+    
+    @app.route('/', methods=['GET'])
+    def home():
+        """Root endpoint"""
+        return jsonify({
+            "message": "C++ Compiler API",
+            "version": "1.0.0",
+            "endpoints": {
+                "/compile": "POST - Compile C++ code",
+                "/judge": "POST - Compile once and judge on many tests",
+                "/languages": "POST - Upload a custom language definition",
+                "/health": "GET - Health check",
+                "/ready": "GET - Readiness check (503 when overloaded)"
+            }
+        })
+
+    @app.route('/health', methods=['GET'])
+    def health():
+        """Health check endpoint"""
+        return jsonify({"status": "healthy", "message": "Compiler API is running",
+                        "warm_up": warm_up.last_report})
+
+    @app.route('/ready', methods=['GET'])
+    def ready():
+        """Readiness check: 503 when the queue, the worker or latency are over their thresholds"""
+        status, payload = check_readiness(request_stats, ready_thresholds)
+        payload["scheduler"] = compile_scheduler.snapshot()
+        return jsonify(payload), status
+
+    @app.route('/compile', methods=['POST'])
+    def compile_code():
+        """Compile C++ code endpoint"""
+        try:
+            # Get JSON data
+            data = request.get_json()
         
-        # Extract source code
-        source_code = data.get('code', '').strip()
+            if not data:
+                return jsonify({
+                    "success": False,
+                    "error": "No JSON data provided",
+                    "details": ["Request must contain JSON data"]
+                }), 400
         
-        if not source_code:
-            return jsonify({
-                "success": False,
-                "error": "No source code provided",
-                "details": ["The 'code' field is required and cannot be empty"]
-            }), 400
+            # Extract source code, sent whole or as changes to an earlier submission
+            submitted, rejection = resolve_source(source_store, data)
+            if rejection is not None:
+                return jsonify(rejection[1]), rejection[0]
+            source_code = submitted.strip()
         
-        # Optional parameters
-        filename = data.get('filename', 'input.cpp')
-        show_generated_code = data.get('show_generated_code', False)
-        verbose = data.get('verbose', False)
+            if not source_code:
+                return jsonify({
+                    "success": False,
+                    "error": "No source code provided",
+                    "details": ["The 'code' field is required and cannot be empty"]
+                }), 400
+            if len(source_code.encode('utf-8')) > admission_limits.max_code_bytes:
+                return jsonify(too_large(admission_limits.max_code_bytes, "Source code")), 413
+            # The client's next request may send only its changes against this program
+            response_headers = {SOURCE_HASH_HEADER: source_store.put(submitted)}
+            source_code, rejection = translate_request(language_store, data, source_code)
+            if rejection is not None:
+                return jsonify(rejection[1]), rejection[0], response_headers
         
-        # Set compiler options
-        compiler.show_generated_code = show_generated_code
-        compiler.verbose = verbose
+            # Optional parameters (filename, show_generated_code, verbose, fast_analysis, engine)
+            context = CompilationContext.from_request(data)
         
-        # Compile the code
-        result = compiler.compile_source_api(source_code, filename)
+            # Compile the code; unmodified examples were already run at startup
+            speculative = is_speculative(data)
+            result = example_store.cached_result(source_code, context)
+            if result is not None:
+                if speculative:
+                    response_headers[SPECULATIVE_HEADER] = CACHED
+                return jsonify(result), 200 if result['success'] else 400, response_headers
+            
+            # A program compiled before, possibly speculatively, is answered at once
+            key = result_key(source_code, context)
+            stored = result_cache.get(key)
+            if stored is not None:
+                if speculative:
+                    response_headers[SPECULATIVE_HEADER] = CACHED
+                return Response(stored[1], stored[0], response_headers, mimetype='application/json')
+            
+            if speculative:
+                # Pre-compile only on an idle worker
+                ticket = compile_scheduler.try_acquire(SPECULATIVE)
+                if ticket is None:
+                    response_headers[SPECULATIVE_HEADER] = SKIPPED
+                    return jsonify(skipped_response()), 202, response_headers
+                response_headers[SPECULATIVE_HEADER] = COMPILED
+            else:
+                api_client = known_token(admission_limits, request.headers.get('Authorization')) is not None
+                ticket = acquire_slot(compile_scheduler, request_stats,
+                                      request_class(data, request.headers, api_client=api_client))
+            token = request_stats.start()
+            try:
+                if speculative:
+                    result = run_speculatively(compile_source_api, source_code, context)
+                else:
+                    result = compile_source_api(source_code, context)
+            finally:
+                compile_scheduler.release(ticket, result is not None)
+                request_stats.finish(token, result is not None)
+            if result is None:
+                # Never cached, so a Run of this program compiles it without the limit
+                response_headers[SPECULATIVE_HEADER] = TIMED_OUT
+                return jsonify(timed_out_response()), 202, response_headers
         
-        # Return appropriate HTTP status
-        status_code = 200 if result['success'] else 400
+            # Return appropriate HTTP status
+            status_code = 200 if result['success'] else 400
+            body = json.dumps(result).encode('utf-8')
+            result_cache.put(key, status_code, body)
         
-        return jsonify(result), status_code
+            return Response(body, status_code, response_headers, mimetype='application/json')
         
-    except Exception as e:
-        return jsonify({
-            "success": False,
-            "error": f"Server Error: {str(e)}",
-            "details": [traceback.format_exc()],
-            "output": "",
-            "execution_output": ""
-        }), 500
+        except RequestEntityTooLarge:
+            return jsonify(too_large(admission_limits.max_body_bytes)), 413
+        except Exception as e:
+            return jsonify({
+                "success": False,
+                "error": f"Server Error: {str(e)}",
+                "details": [traceback.format_exc()],
+                "output": "",
+                "execution_output": ""
+            }), 500
 
-@app.route('/examples', methods=['GET'])
-def get_examples():
-    """Get example C++ programs"""
-    examples = []
-    examples_dir = Path('./examples')
-    
-    if examples_dir.exists():
-        for example_file in examples_dir.glob('*.cpp'):
-            try:
-                with open(example_file, 'r', encoding='utf-8') as f:
-                    content = f.read()
-                examples.append({
-                    "filename": example_file.name,
-                    "code": content,
-                    "description": f"Example: {example_file.stem}"
-                })
-            except Exception as e:
-                continue
+    @app.route('/judge', methods=['POST'])
+    def judge_code():
+        """Compile a submission once and judge it on many tests in the worker processes"""
+        try:
+            data = request.get_json(silent=True)
+            if not isinstance(data, dict) or not data:
+                return jsonify({
+                    "success": False,
+                    "error": "No JSON data provided",
+                    "details": ["Request must contain JSON data"]
+                }), 400
+            source_code = str(data.get('code') or '').strip()
+            if not source_code:
+                return jsonify({
+                    "success": False,
+                    "error": "No source code provided",
+                    "details": ["The 'code' field is required and cannot be empty"]
+                }), 400
+            if len(source_code.encode('utf-8')) > admission_limits.max_code_bytes:
+                return jsonify(too_large(admission_limits.max_code_bytes, "Source code")), 413
+            tests, comparison, limits, rejection = parse_judge_request(data, judge_limits)
+            if rejection is not None:
+                return jsonify(rejection[1]), rejection[0]
+            context = CompilationContext.from_request(data)
+            # Grading is always batch work
+            job_class = request_class(data, request.headers, BATCH)
+            result = judge_api(source_code, tests, context, limits, comparison,
+                               map_tests=scheduled_map(compile_scheduler, request_stats, job_class,
+                                                       judge_pool()),
+                               compile_slot=partial(scheduled, compile_scheduler, request_stats, job_class))
+            return jsonify(result), 200 if result['success'] else 400
+        except RequestEntityTooLarge:
+            return jsonify(too_large(admission_limits.max_body_bytes)), 413
+        except Exception as e:
+            return jsonify({
+                "success": False,
+                "error": f"Server Error: {str(e)}",
+                "details": [traceback.format_exc()],
+                "output": "",
+                "execution_output": ""
+            }), 500
+
+    @app.route('/languages', methods=['POST'])
+    def upload_language():
+        """Store a custom language definition; /compile then takes its language_hash"""
+        status, payload = register_response(language_store, request.get_json(silent=True))
+        return jsonify(payload), status
+
+    @app.route('/examples', methods=['GET'])
+    def get_examples():
+        """Get example C++ programs, with ETag revalidation and gzip"""
+        status, body, headers = example_store.response(request.headers.get('If-None-Match'),
+                                                       request.headers.get('Accept-Encoding'))
+        return Response(body, status=status, headers=headers)
     
-    return jsonify({
-        "success": True,
-        "examples": examples,
-        "count": len(examples)
-    })
+    return app
+
+def __getattr__(name):
+    """Create the module-level Flask app (main.app, e.g. for gunicorn) on first access"""
+    global _app
+    if name == 'app':
+        if _app is None:
+            _app = create_app()
+        return _app
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
 
 def start_api_server(host='0.0.0.0', port=5000, debug=False):
     """Start the Flask API server"""
@@ -421,6 +912,12 @@ def start_api_server(host='0.0.0.0', port=5000, debug=False):
     print(f"API Documentation: http://{host}:{port}/")
     print("Press Ctrl+C to stop the server")
     
+    app = create_app()
+    # Prime the pipeline and caches before accepting the first request
+    report = warm_up.warm_up(compile_function=compile_source_api)
+    example_store.load()
+    example_store.watch()
+    print(f"Ready: warmed up on {report['programs']} programs in {report['seconds'] * 1000:.0f} ms")
     try:
         app.run(host=host, port=port, debug=debug)
     except KeyboardInterrupt:
@@ -436,7 +933,16 @@ def main():
         host = '0.0.0.0'
         port = int(os.environ.get('PORT', 5000))  # Use environment PORT or default to 5000
         debug = '--debug' in sys.argv
-        start_api_server(host=host, port=port, debug=debug)
+        if '--prefork' in sys.argv:
+            from async_server import start_prefork_server
+            # WEB_CONCURRENCY is the usual process count setting for prefork servers
+            processes = int(os.environ.get('WEB_CONCURRENCY', 0))
+            start_prefork_server(host=host, port=port, processes=processes)
+        elif '--async' in sys.argv:
+            from async_server import start_async_server
+            start_async_server(host=host, port=port)
+        else:
+            start_api_server(host=host, port=port, debug=debug)
         return
     
     # Original CLI functionality
@@ -453,6 +959,8 @@ def main():
             print(f"  {sys.argv[0]} <source_file>      # Compile and run a C++ file")
             print(f"  {sys.argv[0]} --api              # Start Flask API server")
             print(f"  {sys.argv[0]} --api --debug      # Start Flask API server with debug mode")
+            print(f"  {sys.argv[0]} --api --async      # Start asyncio API server with worker processes")
+            print(f"  {sys.argv[0]} --api --prefork    # Start $WEB_CONCURRENCY prefork servers (default: CPU count)")
             print(f"  {sys.argv[0]} --help             # Show this help")
             return
         
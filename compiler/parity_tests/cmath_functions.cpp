@@ -0,0 +1,51 @@
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+// <cmath> calls, including the inputs where Python's math module raises
+// but C++ returns an infinity, and pow with a squared exponent
+
+double distance(double x1, double y1, double x2, double y2) {
+    return sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
+}
+
+void roundings(double v) {
+    cout << v << ": " << floor(v) << " " << ceil(v) << " " << trunc(v) << " " << round(v) << endl;
+}
+
+int main() {
+    cout << "sqrt: " << sqrt(2.0) << " " << sqrt(49) << " " << std::sqrt(0.25) << endl;
+    cout << "distance: " << distance(1, 2, 4, 6) << endl;
+    cout << "pow: " << pow(2, 10) << " " << pow(1.5, 3) << " " << pow(-2.0, 3) << " " << pow(9.0, 0.5) << endl;
+    cout << "pow poles: " << pow(0.0, -1) << " " << pow(-0.0, -3) << " " << pow(10.0, 400) << endl;
+    cout << "log: " << log(1.0) << " " << log10(1000.0) << " " << log2(8) << " " << log(0.0) << endl;
+    cout << "exp: " << exp(1.0) << " " << exp(800.0) << " " << exp(-800.0) << endl;
+    cout << "trig: " << sin(0.5) << " " << cos(0.5) << " " << tan(0.5) << " " << atan2(1.0, -1.0) << endl;
+    cout << "inverse: " << asin(0.5) << " " << acos(-1.0) << " " << atan(1.0) << " " << tanh(0.5) << endl;
+
+    // Rounding of halfway cases and negative values
+    roundings(2.5);
+    roundings(-2.5);
+    roundings(0.5);
+    roundings(-0.4);
+    roundings(7.0);
+    roundings(-7.75);
+
+    cout << "abs: " << abs(-7) << " " << abs(-2.5) << " " << fabs(-0.125) << endl;
+    cout << "fmod: " << fmod(7.5, 2.0) << " " << fmod(-7.5, 2.0) << " " << hypot(3.0, 4.0) << endl;
+    cout << "fmin/fmax: " << fmin(1.5, -2) << " " << fmax(1.5, -2) << endl;
+
+    // float overloads round to single precision
+    float f = 2.0f;
+    float root = sqrt(f);
+    float cube = pow(f + 0.1f, 3.0f);
+    cout << "float: " << root * 1000000 << " " << cube << endl;
+
+    double total = 0;
+    for (int i = 1; i <= 1000; i++) {
+        double x = i * 0.01;
+        total = total + sqrt(x) * sin(x) + pow(x, 2) - exp(-x) + log(x + 1);
+    }
+    cout << "total: " << total << endl;
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+using namespace std;
+
+float scale(float value, float factor) {
+    return value * factor;
+}
+
+double average(int a, int b) {
+    return (a + b) / 2.0;
+}
+
+int main() {
+    float f = 0.1f;
+    double d = 0.1;
+    cout << "float 0.1 * 3 = " << (f * 3) << endl;
+    cout << "double 0.1 * 3 = " << (d * 3) << endl;
+    cout << "0.1f == 0.1: " << (f == d) << endl;
+    
+    float third = 1.0f / 3;
+    double precise = 1.0 / 3;
+    cout << "float third: " << third << endl;
+    cout << "double third: " << precise << endl;
+    cout << "difference: " << (precise - third) << endl;
+    
+    float accumulated = 0.0f;
+    for (int i = 0; i < 10; i++) {
+        accumulated = accumulated + 0.1f;
+    }
+    cout << "Ten 0.1f steps: " << accumulated << endl;
+    cout << "Equal to 1: " << (accumulated == 1.0f) << endl;
+    
+    float big = 16777216.0f;
+    float bigger = big + 1;
+    cout << "2^24 + 1 in float: " << (bigger - big) << endl;
+    
+    int truncated = 2.9;
+    int negative = -2.9;
+    cout << "int(2.9) = " << truncated << ", int(-2.9) = " << negative << endl;
+    
+    cout << "scale(1.5, 2.5) = " << scale(1.5, 2.5) << endl;
+    cout << "average(3, 4) = " << average(3, 4) << endl;
+    cout << "1e10 = " << 1e10 << ", 1.5e-7 = " << 1.5e-7 << endl;
+    cout << "100000.0 = " << 100000.0 << ", 1234567.0 = " << 1234567.0 << endl;
+    return 0;
+}
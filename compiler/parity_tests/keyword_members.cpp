@@ -0,0 +1,51 @@
+#include <iostream>
+using namespace std;
+
+// Data members named after Python keywords, in aggregates and classes
+struct Range {
+    int from;
+    int in;
+    int in_;
+    bool is;
+    double lambda;
+};
+
+class Flags {
+public:
+    int pass;
+    int yield;
+    Flags(int p) { pass = p; yield = p * 2; }
+    int sum() { return pass + yield; }
+    void bump() { pass++; yield = yield + pass; }
+};
+
+struct Span {
+    Range range;
+    int global;
+};
+
+int main() {
+    Range r;
+    r.from = 3;
+    r.in = 4;
+    r.in_ = 5;
+    r.is = true;
+    r.lambda = 1.5;
+    r.in++;
+    Range copy = r;
+    copy.in = 9;
+    cout << r.from << " " << r.in << " " << r.in_ << " " << copy.in << " " << r.is << " " << r.lambda << endl;
+
+    Flags f(5);
+    f.pass = f.pass + 1;
+    f.bump();
+    cout << f.pass << " " << f.yield << " " << f.sum() << endl;
+
+    Span s;
+    s.range = r;
+    s.global = 2;
+    Span t = s;
+    t.range.from = 30;
+    cout << s.range.from << " " << t.range.from << " " << t.global << endl;
+    return 0;
+}
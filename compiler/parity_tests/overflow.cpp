@@ -0,0 +1,48 @@
+#include <iostream>
+using namespace std;
+
+int mix(int seed, int rounds) {
+    int h = seed;
+    for (int i = 0; i < rounds; i++) {
+        h = h * 31 + i;
+    }
+    return h;
+}
+
+int factorial(int n) {
+    int result = 1;
+    for (int i = 2; i <= n; i++) {
+        result = result * i;
+    }
+    return result;
+}
+
+int main() {
+    int big = 2147483647;
+    int wrapped = big + 1;
+    cout << "INT_MAX + 1 = " << wrapped << endl;
+    
+    int smallest = -big - 1;
+    cout << "INT_MIN = " << smallest << endl;
+    cout << "-INT_MIN = " << -smallest << endl;
+    cout << "INT_MIN - 1 = " << (smallest - 1) << endl;
+    
+    int counter = big;
+    counter++;
+    cout << "INT_MAX++ = " << counter << endl;
+    counter--;
+    cout << "INT_MIN-- = " << counter << endl;
+    
+    cout << "mix(7, 100) = " << mix(7, 100) << endl;
+    for (int n = 10; n <= 15; n++) {
+        cout << n << "! = " << factorial(n) << endl;
+    }
+    
+    // Small loops stay in range and need no wraparound
+    int sum = 0;
+    for (int i = 0; i < 1000; i++) {
+        sum = sum + i * i;
+    }
+    cout << "Sum of squares: " << sum << endl;
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+using namespace std;
+
+// Returns of variables declared inside loops and branches
+int firstAbove(int limit, int n) {
+    for (int i = 0; i < n; i++) {
+        int square = i * i;
+        if (square > limit) {
+            return square;
+        }
+    }
+    return -1;
+}
+
+long collatzPeak(long start) {
+    long value = start;
+    long peak = start;
+    while (value != 1) {
+        long next = value / 2;
+        if (value % 2 != 0) {
+            next = 3 * value + 1;
+        }
+        if (next > peak) {
+            peak = next;
+        }
+        value = next;
+    }
+    return peak;
+}
+
+double halfOf(int value) {
+    if (value > 0) {
+        double half = value / 2.0;
+        return half;
+    }
+    return 0;
+}
+
+bool isEven(int value) {
+    bool even = value % 2 == 0;
+    return even;
+}
+
+int main() {
+    cout << "First square above 50: " << firstAbove(50, 20) << endl;
+    cout << "First square above 500: " << firstAbove(500, 20) << endl;
+    cout << "Collatz peak of 27: " << collatzPeak(27) << endl;
+    cout << "Half of 7: " << halfOf(7) << endl;
+    cout << "Half of -3: " << halfOf(-3) << endl;
+    cout << "4 is even: " << isEven(4) << ", 9 is even: " << isEven(9) << endl;
+    float third = 1.0f / 3;
+    cout << "A third: " << third << ", doubled: " << third * 2 << endl;
+    return 0;
+}
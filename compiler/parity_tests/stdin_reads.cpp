@@ -0,0 +1,49 @@
+#include <iostream>
+using namespace std;
+
+// cin >> reads from stdin_reads.in: a counted loop, reads into globals and
+// members, every readable type, and a read at the end of input
+
+int total;
+
+struct Sample {
+    int id;
+    double weight;
+};
+
+void readTotal() {
+    cin >> total;
+}
+
+long sumOf(int n) {
+    long sum = 0;
+    for (int i = 0; i < n; i++) {
+        int value;
+        cin >> value;
+        sum = sum + value;
+    }
+    return sum;
+}
+
+int main() {
+    int n;
+    cin >> n;
+    cout << "sum of " << n << ": " << sumOf(n) << endl;
+
+    readTotal();
+    Sample sample;
+    cin >> sample.id >> sample.weight;
+    cout << "total " << total << ", sample " << sample.id << " weighs " << sample.weight << endl;
+
+    bool flag;
+    float ratio;
+    long big;
+    cin >> flag >> ratio >> big;
+    cout << flag << " " << ratio << " " << big << endl;
+
+    // At the end of input the variable keeps its value and the stream fails
+    int extra = 3;
+    cin >> extra;
+    cout << "extra " << extra << " " << !cin << endl;
+    return 0;
+}
@@ -0,0 +1,22 @@
+#include <iostream>
+using namespace std;
+
+// Reading until cin fails on something that is not a number, which zeroes
+// the variable; a failed stream reads nothing more
+
+int main() {
+    long sum = 0;
+    int count = 0;
+    int value = -1;
+    while (cin >> value) {
+        sum = sum + value;
+        count++;
+    }
+    cout << count << " values, sum " << sum << ", last " << value << endl;
+
+    double d = 2.5;
+    if (!(cin >> d)) {
+        cout << "failed, d = " << d << endl;
+    }
+    return count;
+}
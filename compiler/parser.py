@@ -6,6 +6,7 @@ This module parses tokens into an Abstract Syntax Tree using recursive descent p
 from abc import ABC, abstractmethod
 from typing import List, Optional, Union, Any
 from lexer import Token, TokenType, Lexer
+from compilation_context import CompilationContext, DEFAULT_CONTEXT
 
 # AST Node Classes
 class ASTNode(ABC):
@@ -14,7 +15,11 @@ class ASTNode(ABC):
 
 class Expression(ASTNode):
     """Base class for expressions"""
-    pass
+    # Set by the semantic analyzer: the expression's static type, and the
+    # arithmetic type it is implicitly converted to where that differs (int
+    # initializing a double, long passed as int, ...)
+    static_type: Optional[str] = None
+    converted_type: Optional[str] = None
 
 class Statement(ASTNode):
     """Base class for statements"""
@@ -78,6 +83,9 @@ class UnaryOperation(Expression):
 
 class FunctionCall(Expression):
     """Represents a function call"""
+    # The <cmath> Intrinsic this call resolves to, set by the semantic analyzer
+    intrinsic = None
+    
     def __init__(self, name: str, arguments: List[Expression]):
         self.name = name
         self.arguments = arguments
@@ -86,9 +94,39 @@ class FunctionCall(Expression):
         args = ', '.join(str(arg) for arg in self.arguments)
         return f"FunctionCall({self.name}({args}))"
 
+class MemberAccess(Expression):
+    """Represents a data member access (obj.member or this->member)"""
+    def __init__(self, obj: Expression, member: str, operator: str = '.'):
+        self.obj = obj
+        self.member = member
+        self.operator = operator
+    
+    def __repr__(self):
+        return f"MemberAccess({self.obj}{self.operator}{self.member})"
+
+class MethodCall(Expression):
+    """Represents a member function call (obj.method(args))"""
+    def __init__(self, obj: Expression, name: str, arguments: List[Expression], operator: str = '.'):
+        self.obj = obj
+        self.name = name
+        self.arguments = arguments
+        self.operator = operator
+    
+    def __repr__(self):
+        args = ', '.join(str(arg) for arg in self.arguments)
+        return f"MethodCall({self.obj}{self.operator}{self.name}({args}))"
+
+class InitializerList(Expression):
+    """Represents a brace initializer ({a, b, ...}) for aggregates"""
+    def __init__(self, elements: List[Expression]):
+        self.elements = elements
+    
+    def __repr__(self):
+        return f"InitList({', '.join(str(element) for element in self.elements)})"
+
 class Assignment(Expression):
     """Represents an assignment"""
-    def __init__(self, target: Identifier, value: Expression):
+    def __init__(self, target: Union[Identifier, MemberAccess], value: Expression):
         self.target = target
         self.value = value
     
@@ -155,6 +193,39 @@ class ForStatement(Statement):
     def __repr__(self):
         return f"For({self.init}; {self.condition}; {self.update}) {self.body}"
 
+class BreakStatement(Statement):
+    """Represents a break statement"""
+    def __repr__(self):
+        return "Break"
+
+class ContinueStatement(Statement):
+    """Represents a continue statement"""
+    def __repr__(self):
+        return "Continue"
+
+class SwitchCase(ASTNode):
+    """Represents one case (or default) label and the statements following it"""
+    def __init__(self, value: Optional[Expression], statements: List[Statement]):
+        self.value = value  # None for the default label
+        self.statements = statements
+    
+    @property
+    def is_default(self) -> bool:
+        return self.value is None
+    
+    def __repr__(self):
+        label = "default" if self.is_default else f"case {self.value}"
+        return f"{label}: [{', '.join(str(stmt) for stmt in self.statements)}]"
+
+class SwitchStatement(Statement):
+    """Represents a switch statement"""
+    def __init__(self, expression: Expression, cases: List[SwitchCase]):
+        self.expression = expression
+        self.cases = cases
+    
+    def __repr__(self):
+        return f"Switch({self.expression}) {{{'; '.join(str(case) for case in self.cases)}}}"
+
 class ReturnStatement(Statement):
     """Represents a return statement"""
     def __init__(self, expression: Optional[Expression] = None):
@@ -202,21 +273,80 @@ class UsingNamespace(Statement):
 
 class ClassDeclaration(Statement):
     """Represents a class/struct declaration (simplified)"""
-    def __init__(self, name: str, members: List[Statement], is_struct: bool = False):
+    def __init__(self, name: str, members: List[Statement], is_struct: bool = False,
+                 methods: Optional[List[FunctionDeclaration]] = None,
+                 constructors: Optional[List[FunctionDeclaration]] = None):
         self.name = name
-        self.members = members  # Only variable declarations for now
+        self.members = members  # Data members (variable declarations)
         self.is_struct = is_struct
+        self.methods = methods or []
+        self.constructors = constructors or []
     def __repr__(self):
         kind = 'Struct' if self.is_struct else 'Class'
-        return f"{kind}Decl({self.name}, members=[{', '.join(str(m) for m in self.members)}])"
+        parts = [str(m) for m in self.members + self.constructors + self.methods]
+        return f"{kind}Decl({self.name}, members=[{', '.join(parts)}])"
+
+# What walk does with a value, by its type: yield and descend into an AST
+# node, descend into a list or tuple, or skip it. Filled in the first time a
+# type is seen, so isinstance (which goes through ABCMeta for AST nodes) runs
+# once per type instead of once per value
+WALK_SKIP, WALK_NODE, WALK_SEQUENCE = 0, 1, 2
+walk_kinds: dict = {}
+
+def walk_kind(value_type: type) -> int:
+    if issubclass(value_type, (list, tuple)):
+        kind = WALK_SEQUENCE
+    elif issubclass(value_type, ASTNode):
+        kind = WALK_NODE
+    else:
+        kind = WALK_SKIP
+    walk_kinds[value_type] = kind
+    return kind
+
+def walk(node: Any):
+    """Yield node and every AST node nested below it (pre-order)"""
+    kinds = walk_kinds
+    stack = [node]
+    while stack:
+        current = stack.pop()
+        kind = kinds.get(type(current))
+        if kind is None:
+            kind = walk_kind(type(current))
+        if kind == WALK_NODE:
+            yield current
+            stack.extend(reversed(vars(current).values()))
+        elif kind == WALK_SEQUENCE:
+            stack.extend(reversed(current))
+
+# Names of the input stream; cin >> a >> b reads a, then b
+INPUT_STREAMS = ('cin', 'std::cin')
+
+def extraction_chain(node: Any) -> Optional[List[Expression]]:
+    """The variables a cin >> a >> b chain reads into, in order, or None if node is not one"""
+    targets = []
+    while type(node) is BinaryOperation and node.operator == '>>':
+        targets.append(node.right)
+        node = node.left
+    if not targets or type(node) is not Identifier or node.name not in INPUT_STREAMS:
+        return None
+    targets.reverse()
+    return targets
+
+def extraction_target(node: Any) -> Optional[Expression]:
+    """The variable one >> of an extraction chain writes, or None if node is no such >>"""
+    targets = extraction_chain(node)
+    return targets[-1] if targets else None
 
 # Parser class
 class Parser:
     """Recursive descent parser for C++"""
     
-    def __init__(self, tokens: List[Token]):
+    def __init__(self, tokens: List[Token], context: Optional[CompilationContext] = None):
         self.tokens = tokens
+        self.context = context or DEFAULT_CONTEXT
         self.current = 0
+        # Class/struct names seen so far; C++ requires declaration before use
+        self.user_types = set()
     
     def current_token(self) -> Token:
         """Get the current token"""
@@ -267,12 +397,53 @@ class Parser:
             if self.match(TokenType.EOF):
                 break
                 
+            start = self.current
             decl = self.parse_declaration()
             if decl:
                 declarations.append(decl)
+            elif self.current == start:
+                # Nothing at top level starts with this token; stop instead of spinning
+                token = self.current_token()
+                raise SyntaxError(f"Unexpected {token.type.name} '{token.value}' at line {token.line}")
         
         return Program(declarations)
     
+    def parse_entry(self) -> List[Statement]:
+        """Parse an interactive entry: top-level declarations and statements in any order"""
+        items = []
+        while True:
+            self.skip_newlines()
+            if self.match(TokenType.EOF):
+                break
+            if (self.match(TokenType.HASH, TokenType.USING, TokenType.CLASS, TokenType.STRUCT)
+                    or self.at_function_definition()):
+                item = self.parse_declaration()
+                if item is None:
+                    raise SyntaxError(f"Unexpected {self.current_token().type.name}")
+            else:
+                item = self.parse_statement()
+            if item:
+                items.append(item)
+        return items
+    
+    def at_function_definition(self) -> bool:
+        """Check if a return type, a name and a parameter list start here"""
+        if not self.at_type_start():
+            return False
+        start = self.current
+        try:
+            self.parse_type()
+            if not (self.match(TokenType.IDENTIFIER) and self.peek_token().type == TokenType.LEFT_PAREN):
+                return False
+            # Point p(1, 2) declares a variable; a function has types or nothing in its parentheses
+            self.advance()
+            self.advance()
+            return self.match(TokenType.RIGHT_PAREN) or self.at_type_start()
+        except SyntaxError:
+            return False
+        finally:
+            self.current = start
+    
     def parse_declaration(self) -> Optional[Statement]:
         """Parse a top-level declaration"""
         self.skip_newlines()
@@ -283,10 +454,21 @@ class Parser:
             return self.parse_using_namespace()
         elif self.match(TokenType.CLASS, TokenType.STRUCT):
             return self.parse_class_declaration()
-        elif self.match(TokenType.INT, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL, TokenType.VOID):
+        elif self.match(TokenType.INT, TokenType.LONG, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL, TokenType.VOID):
+            return self.parse_function_or_variable()
+        elif self.match_user_type():
             return self.parse_function_or_variable()
         
         return None
+    
+    def match_user_type(self) -> bool:
+        """Check if the current token names a declared class/struct"""
+        return self.match(TokenType.IDENTIFIER) and self.current_token().value in self.user_types
+    
+    def at_type_start(self) -> bool:
+        """Check if the current token can begin a type"""
+        return (self.match(TokenType.CONST, TokenType.INT, TokenType.LONG, TokenType.FLOAT, TokenType.DOUBLE,
+                           TokenType.CHAR, TokenType.BOOL, TokenType.VOID) or self.match_user_type())
 
     def parse_class_declaration(self) -> ClassDeclaration:
         is_struct = self.match(TokenType.STRUCT)
@@ -297,16 +479,45 @@ class Parser:
             while not self.match(TokenType.LEFT_BRACE, TokenType.EOF):
                 self.advance()
         self.consume(TokenType.LEFT_BRACE)
+        # Registered before the body so members and methods can use the type
+        self.user_types.add(name)
         members: List[Statement] = []
+        methods: List[FunctionDeclaration] = []
+        constructors: List[FunctionDeclaration] = []
         while not self.match(TokenType.RIGHT_BRACE, TokenType.EOF):
             self.skip_newlines()
             if self.match(TokenType.RIGHT_BRACE):
                 break
-            if self.match(TokenType.INT, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL):
+            token = self.current_token()
+            if (token.type == TokenType.IDENTIFIER and token.value in ('public', 'private', 'protected')
+                    and self.peek_token().type == TokenType.COLON):
+                # Access specifiers don't affect the generated layout
+                self.advance()
+                self.advance()
+            elif token.type == TokenType.IDENTIFIER and token.value == name and self.peek_token().type == TokenType.LEFT_PAREN:
+                self.advance()
+                constructors.append(self.parse_constructor(name))
+            elif self.at_type_start():
                 mtype = self.parse_type()
                 mname = self.consume(TokenType.IDENTIFIER).value
+                if self.match(TokenType.LEFT_PAREN):
+                    methods.append(self.parse_method_declaration(mtype, mname))
+                    continue
+                # One or more data members, each with an optional default initializer
+                while True:
+                    initializer = None
+                    if self.match(TokenType.ASSIGN):
+                        self.advance()
+                        initializer = self.parse_expression()
+                    members.append(VariableDeclaration(mtype, mname, initializer))
+                    if not self.match(TokenType.COMMA):
+                        break
+                    self.advance()
+                    mname = self.consume(TokenType.IDENTIFIER).value
                 self.consume(TokenType.SEMICOLON)
-                members.append(VariableDeclaration(mtype, mname))
+            elif token.type == TokenType.UNKNOWN and token.value == '~':
+                # Destructors have no observable effect without resources; skip them
+                self.skip_member_definition()
             else:
                 # Skip unsupported member syntax for now
                 self.advance()
@@ -314,7 +525,75 @@ class Parser:
         # Optional trailing semicolon
         if self.match(TokenType.SEMICOLON):
             self.advance()
-        return ClassDeclaration(name, members, is_struct)
+        return ClassDeclaration(name, members, is_struct, methods, constructors)
+    
+    def parse_parameter_list(self) -> List[tuple]:
+        """Parse a parenthesized parameter list into (Type, name) tuples"""
+        self.consume(TokenType.LEFT_PAREN)
+        parameters = []
+        if not self.match(TokenType.RIGHT_PAREN):
+            param_type = self.parse_type()
+            param_name = self.consume(TokenType.IDENTIFIER).value
+            parameters.append((param_type, param_name))
+            
+            while self.match(TokenType.COMMA):
+                self.advance()
+                param_type = self.parse_type()
+                param_name = self.consume(TokenType.IDENTIFIER).value
+                parameters.append((param_type, param_name))
+        self.consume(TokenType.RIGHT_PAREN)
+        return parameters
+    
+    def parse_method_declaration(self, return_type: Type, name: str) -> FunctionDeclaration:
+        """Parse an inline member function definition"""
+        parameters = self.parse_parameter_list()
+        if self.match(TokenType.CONST):
+            self.advance()  # const member functions behave the same here
+        self.skip_newlines()
+        if self.match(TokenType.SEMICOLON):
+            raise SyntaxError(f"Member function '{name}' must be defined inside the class body")
+        body = self.parse_block()
+        return FunctionDeclaration(return_type, name, parameters, body)
+    
+    def parse_constructor(self, class_name: str) -> FunctionDeclaration:
+        """Parse a constructor, folding its member initializer list into the body"""
+        parameters = self.parse_parameter_list()
+        initializers = []
+        if self.match(TokenType.COLON):
+            self.advance()
+            while True:
+                self.skip_newlines()
+                member = self.consume(TokenType.IDENTIFIER, "Expected member name in initializer list").value
+                self.consume(TokenType.LEFT_PAREN)
+                value = self.parse_expression()
+                self.consume(TokenType.RIGHT_PAREN)
+                target = MemberAccess(Identifier('this'), member, '->')
+                initializers.append(ExpressionStatement(Assignment(target, value)))
+                if not self.match(TokenType.COMMA):
+                    break
+                self.advance()
+        self.skip_newlines()
+        body = self.parse_block()
+        body.statements[:0] = initializers
+        return FunctionDeclaration(Type('void'), class_name, parameters, body)
+    
+    def skip_member_definition(self):
+        """Skip a member we don't model, up to its ';' or balanced body"""
+        while not self.match(TokenType.LEFT_BRACE, TokenType.SEMICOLON, TokenType.EOF):
+            self.advance()
+        if self.match(TokenType.SEMICOLON):
+            self.advance()
+            return
+        depth = 0
+        while not self.match(TokenType.EOF):
+            if self.match(TokenType.LEFT_BRACE):
+                depth += 1
+            elif self.match(TokenType.RIGHT_BRACE):
+                depth -= 1
+                if depth == 0:
+                    self.advance()
+                    return
+            self.advance()
     
     def parse_preprocessor(self) -> Statement:
         """Parse preprocessor directives"""
@@ -360,19 +639,29 @@ class Parser:
         if self.match(TokenType.CONST):
             is_const = True
             self.advance()
-        if self.match(TokenType.INT, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL, TokenType.VOID):
-            base = self.advance().value
-            is_pointer = False
-            is_reference = False
-            # Collect * and & (single level for now)
-            if self.match(TokenType.MULTIPLY):
+        if self.match(TokenType.LONG):
+            # long, long int, long long and long long int are all 64-bit here
+            self.advance()
+            if self.match(TokenType.LONG):
                 self.advance()
-                is_pointer = True
-            if self.match(TokenType.AMPERSAND):
+            if self.match(TokenType.INT):
                 self.advance()
-                is_reference = True
-            return Type(base, is_pointer=is_pointer, is_reference=is_reference, is_const=is_const)
-        raise SyntaxError(f"Expected type, got {self.current_token().type.name}")
+            base = 'long'
+        elif (self.match(TokenType.INT, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL, TokenType.VOID)
+                or self.match_user_type()):
+            base = self.advance().value
+        else:
+            raise SyntaxError(f"Expected type, got {self.current_token().type.name}")
+        is_pointer = False
+        is_reference = False
+        # Collect * and & (single level for now)
+        if self.match(TokenType.MULTIPLY):
+            self.advance()
+            is_pointer = True
+        if self.match(TokenType.AMPERSAND):
+            self.advance()
+            is_reference = True
+        return Type(base, is_pointer=is_pointer, is_reference=is_reference, is_const=is_const)
     
     def parse_function_or_variable(self) -> Statement:
         """Parse function or variable declaration"""
@@ -388,22 +677,7 @@ class Parser:
     
     def parse_function_declaration(self, return_type: Type, name: str) -> FunctionDeclaration:
         """Parse function declaration"""
-        self.consume(TokenType.LEFT_PAREN)
-        
-        parameters = []
-        if not self.match(TokenType.RIGHT_PAREN):
-            # Parse parameter list
-            param_type = self.parse_type()
-            param_name = self.consume(TokenType.IDENTIFIER).value
-            parameters.append((param_type, param_name))
-            
-            while self.match(TokenType.COMMA):
-                self.advance()
-                param_type = self.parse_type()
-                param_name = self.consume(TokenType.IDENTIFIER).value
-                parameters.append((param_type, param_name))
-        
-        self.consume(TokenType.RIGHT_PAREN)
+        parameters = self.parse_parameter_list()
         body = self.parse_block()
         
         return FunctionDeclaration(return_type, name, parameters, body)
@@ -414,11 +688,42 @@ class Parser:
         
         if self.match(TokenType.ASSIGN):
             self.advance()
-            initializer = self.parse_expression()
+            if self.match(TokenType.LEFT_BRACE):
+                initializer = self.parse_initializer_list()
+            else:
+                initializer = self.parse_expression()
+        elif self.match(TokenType.LEFT_PAREN) and var_type.name in self.user_types:
+            # Direct initialization: Point p(1, 2);
+            self.advance()
+            arguments = []
+            if not self.match(TokenType.RIGHT_PAREN):
+                arguments.append(self.parse_expression())
+                while self.match(TokenType.COMMA):
+                    self.advance()
+                    arguments.append(self.parse_expression())
+            self.consume(TokenType.RIGHT_PAREN)
+            initializer = FunctionCall(var_type.name, arguments)
+        elif self.match(TokenType.LEFT_BRACE) and var_type.name in self.user_types:
+            initializer = self.parse_initializer_list()
         
         self.consume(TokenType.SEMICOLON)
         return VariableDeclaration(var_type, name, initializer)
     
+    def parse_initializer_list(self) -> InitializerList:
+        """Parse a brace initializer list"""
+        self.consume(TokenType.LEFT_BRACE)
+        elements = []
+        self.skip_newlines()
+        if not self.match(TokenType.RIGHT_BRACE):
+            elements.append(self.parse_expression())
+            while self.match(TokenType.COMMA):
+                self.advance()
+                self.skip_newlines()
+                elements.append(self.parse_expression())
+        self.skip_newlines()
+        self.consume(TokenType.RIGHT_BRACE)
+        return InitializerList(elements)
+    
     def parse_block(self) -> Block:
         """Parse a block statement"""
         self.consume(TokenType.LEFT_BRACE)
@@ -440,7 +745,11 @@ class Parser:
         """Parse a statement"""
         self.skip_newlines()
         
-        if self.match(TokenType.INT, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL):
+        if self.match(TokenType.CONST, TokenType.INT, TokenType.LONG, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL):
+            var_type = self.parse_type()
+            name = self.consume(TokenType.IDENTIFIER).value
+            return self.parse_variable_declaration(var_type, name)
+        elif self.match_user_type() and self.peek_token().type in (TokenType.IDENTIFIER, TokenType.AMPERSAND):
             var_type = self.parse_type()
             name = self.consume(TokenType.IDENTIFIER).value
             return self.parse_variable_declaration(var_type, name)
@@ -450,8 +759,18 @@ class Parser:
             return self.parse_while_statement()
         elif self.match(TokenType.FOR):
             return self.parse_for_statement()
+        elif self.match(TokenType.SWITCH):
+            return self.parse_switch_statement()
         elif self.match(TokenType.RETURN):
             return self.parse_return_statement()
+        elif self.match(TokenType.BREAK):
+            self.advance()
+            self.consume(TokenType.SEMICOLON)
+            return BreakStatement()
+        elif self.match(TokenType.CONTINUE):
+            self.advance()
+            self.consume(TokenType.SEMICOLON)
+            return ContinueStatement()
         elif self.match(TokenType.LEFT_BRACE):
             return self.parse_block()
         else:
@@ -470,6 +789,8 @@ class Parser:
         then_stmt = self.parse_statement()
         else_stmt = None
         
+        # The else may start the next line
+        self.skip_newlines()
         if self.match(TokenType.ELSE):
             self.advance()
             else_stmt = self.parse_statement()
@@ -494,7 +815,7 @@ class Parser:
         # Init
         init = None
         if not self.match(TokenType.SEMICOLON):
-            if self.match(TokenType.INT, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL):
+            if self.match(TokenType.INT, TokenType.LONG, TokenType.FLOAT, TokenType.DOUBLE, TokenType.CHAR, TokenType.BOOL):
                 var_type = self.parse_type()
                 name = self.consume(TokenType.IDENTIFIER).value
                 initializer = None
@@ -522,6 +843,45 @@ class Parser:
         
         return ForStatement(init, condition, update, body)
     
+    def parse_switch_statement(self) -> SwitchStatement:
+        """Parse switch statement"""
+        self.consume(TokenType.SWITCH)
+        self.consume(TokenType.LEFT_PAREN)
+        expression = self.parse_expression()
+        self.consume(TokenType.RIGHT_PAREN)
+        self.skip_newlines()
+        self.consume(TokenType.LEFT_BRACE)
+        
+        cases = []
+        while True:
+            self.skip_newlines()
+            if self.match(TokenType.RIGHT_BRACE, TokenType.EOF):
+                break
+            
+            if self.match(TokenType.CASE):
+                self.advance()
+                value = self.parse_expression()
+            elif self.match(TokenType.DEFAULT):
+                self.advance()
+                value = None
+            else:
+                raise SyntaxError(f"Expected case or default label in switch, got {self.current_token().type.name}")
+            self.consume(TokenType.COLON)
+            
+            # Statements run until the next label; fallthrough is resolved by codegen
+            statements = []
+            while True:
+                self.skip_newlines()
+                if self.match(TokenType.CASE, TokenType.DEFAULT, TokenType.RIGHT_BRACE, TokenType.EOF):
+                    break
+                stmt = self.parse_statement()
+                if stmt:
+                    statements.append(stmt)
+            cases.append(SwitchCase(value, statements))
+        
+        self.consume(TokenType.RIGHT_BRACE)
+        return SwitchStatement(expression, cases)
+    
     def parse_return_statement(self) -> ReturnStatement:
         """Parse return statement"""
         self.consume(TokenType.RETURN)
@@ -540,7 +900,7 @@ class Parser:
         if self.match(TokenType.ASSIGN):
             self.advance()
             value = self.parse_expression()
-            if isinstance(expr, Identifier):
+            if isinstance(expr, (Identifier, MemberAccess)):
                 return Assignment(expr, value)
             else:
                 raise SyntaxError("Invalid assignment target")
@@ -604,10 +964,10 @@ class Parser:
         return expr
     
     def parse_shift(self) -> Expression:
-        """Parse shift expression (for cout <<)"""
+        """Parse shift expression (for cout << and cin >>)"""
         expr = self.parse_multiplication()
         
-        while self.match(TokenType.LEFT_SHIFT):
+        while self.match(TokenType.LEFT_SHIFT, TokenType.RIGHT_SHIFT):
             operator = self.advance().value
             right = self.parse_multiplication()
             expr = BinaryOperation(expr, operator, right)
@@ -654,8 +1014,14 @@ class Parser:
                 
                 if isinstance(expr, Identifier):
                     expr = FunctionCall(expr.name, arguments)
+                elif isinstance(expr, MemberAccess):
+                    expr = MethodCall(expr.obj, expr.member, arguments, expr.operator)
                 else:
                     raise SyntaxError("Invalid function call")
+            elif self.match(TokenType.DOT, TokenType.ARROW):
+                operator = self.advance().value
+                member = self.consume(TokenType.IDENTIFIER, "Expected member name").value
+                expr = MemberAccess(expr, member, operator)
             elif self.match(TokenType.INCREMENT, TokenType.DECREMENT):
                 operator = self.advance().value
                 expr = UnaryOperation(operator + "_post", expr)
@@ -667,11 +1033,17 @@ class Parser:
     def parse_primary(self) -> Expression:
         """Parse primary expression"""
         if self.match(TokenType.INTEGER_LITERAL):
-            value = int(self.advance().value)
-            return Literal(value, "int")
+            text = self.advance().value
+            value = int(text.rstrip('lL'))
+            # Decimal literals too large for int take the next wider type
+            is_long = text[-1] in 'lL' or value > 2**31 - 1
+            return Literal(value, "long" if is_long else "int")
         elif self.match(TokenType.FLOAT_LITERAL):
-            value = float(self.advance().value)
-            return Literal(value, "float")
+            text = self.advance().value
+            # Unsuffixed floating literals are double, as in C++
+            if text[-1] in 'fF':
+                return Literal(float(text[:-1]), "float")
+            return Literal(float(text), "double")
         elif self.match(TokenType.STRING_LITERAL):
             value = self.advance().value
             return Literal(value, "string")
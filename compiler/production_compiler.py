@@ -8,13 +8,104 @@ import os
 import tempfile
 import subprocess
 from pathlib import Path
-from typing import Tuple, Optional
+from typing import Tuple, Optional, List, NamedTuple
 
 # Import existing compiler modules
-from lexer import Lexer
+from lexer import Lexer, Token, TokenType
 from parser import Parser
 from semantic_analyzer import SemanticAnalyzer
 from code_generator import CodeGenerator
+from intrinsics import lookup_intrinsic
+
+# Engines, cheapest first: the in-process pipeline has no compile/link step
+ENGINE_CUSTOM = "custom"
+ENGINE_GPP = "g++"
+
+# Headers whose facilities the custom pipeline implements
+CUSTOM_HEADERS = {'iostream', 'cmath'}
+
+# Keyword tokens for features the custom pipeline doesn't implement
+UNSUPPORTED_KEYWORDS = {
+    TokenType.NEW: 'new',
+    TokenType.DELETE: 'delete',
+    TokenType.AUTO: 'auto',
+    TokenType.ENUM: 'enum',
+    TokenType.DO: 'do-while',
+    TokenType.NULLPTR: 'nullptr',
+    TokenType.SHORT: 'short',
+    TokenType.UNSIGNED: 'unsigned',
+    TokenType.SIGNED: 'signed',
+    TokenType.STD_STRING: 'std::string',
+}
+
+# C++ keywords and library names the lexer reads as plain identifiers
+UNSUPPORTED_IDENTIFIERS = {
+    'template', 'typename', 'try', 'catch', 'throw', 'operator', 'virtual',
+    'static', 'typedef', 'goto', 'sizeof', 'friend', 'static_cast',
+    'dynamic_cast', 'reinterpret_cast', 'const_cast', 'string', 'vector',
+}
+
+# Standard library names the custom pipeline provides under std::, besides the
+# <cmath> functions in intrinsics.py
+CUSTOM_STD_NAMES = {'std::cout', 'std::endl', 'std::cin'}
+
+# Error prefixes of the custom pipeline's compile phases (as opposed to runtime errors)
+CUSTOM_COMPILE_ERRORS = ("Compilation failed", "Semantic errors")
+
+COMPOUND_OPERATORS = {TokenType.PLUS, TokenType.MINUS, TokenType.MULTIPLY,
+                      TokenType.DIVIDE, TokenType.MODULO}
+
+class RoutingDecision(NamedTuple):
+    engine: str
+    reason: str
+    features: List[str]  # constructs that rule out the custom pipeline
+
+def scan_features(tokens: List[Token]) -> List[str]:
+    """Single pass over the token stream listing constructs the custom pipeline lacks"""
+    features = []
+    
+    def note(feature: str):
+        if feature not in features:
+            features.append(feature)
+    
+    previous = None
+    for i, token in enumerate(tokens):
+        kind = token.type
+        if kind == TokenType.HASH:
+            directive = tokens[i + 1] if i + 1 < len(tokens) else token
+            if directive.type != TokenType.INCLUDE:
+                note(f"#{directive.value}")
+            else:
+                header = []
+                for t in tokens[i + 2:]:
+                    if t.type in (TokenType.NEWLINE, TokenType.EOF) or t.type == TokenType.GREATER_THAN:
+                        break
+                    if t.type != TokenType.LESS_THAN:
+                        header.append(t.value)
+                name = ''.join(header).strip('"')
+                if name and name.split('.')[0] not in CUSTOM_HEADERS:
+                    note(f"#include <{name}>")
+        elif kind in UNSUPPORTED_KEYWORDS:
+            note(UNSUPPORTED_KEYWORDS[kind])
+        elif kind == TokenType.IDENTIFIER:
+            if token.value in UNSUPPORTED_IDENTIFIERS:
+                note(token.value)
+            elif (token.value.startswith('std::') and token.value not in CUSTOM_STD_NAMES
+                  and lookup_intrinsic(token.value) is None):
+                note(token.value)
+        elif kind == TokenType.NAMESPACE and (previous is None or previous.type != TokenType.USING):
+            note('namespace')
+        elif kind == TokenType.LEFT_BRACKET:
+            note('arrays')
+        elif kind == TokenType.SCOPE_RESOLUTION:
+            note('::')
+        elif kind == TokenType.UNKNOWN and token.value != '~':
+            note(f"operator {token.value}")
+        elif (kind == TokenType.ASSIGN and previous is not None and previous.type in COMPOUND_OPERATORS
+              and previous.line == token.line and previous.column + 1 == token.column):
+            note(f"{previous.value}=")
+        previous = token
+    return features
 
 class ProductionCppCompiler:
     """Production C++ Compiler wrapper"""
@@ -23,6 +114,7 @@ class ProductionCppCompiler:
         self.cpp_standard = "c++17"
         self.optimization = "-O2"
         self.flags = ["-Wall", "-Wextra"]
+        self.gpp_available = False
         self.gpp_path = self.find_gpp()
     
     def find_gpp(self) -> str:
@@ -35,6 +127,7 @@ class ProductionCppCompiler:
                 result = subprocess.run([path, "--version"], 
                                       capture_output=True, text=True, timeout=5)
                 if result.returncode == 0:
+                    self.gpp_available = True
                     return path
             except:
                 continue
@@ -63,20 +156,64 @@ class ProductionCppCompiler:
         Returns:
             Tuple of (success, output, error)
         """
+        result = self.compile_program(source_code, filename, run_after_compile)
+        return result["success"], result["output"], result["error"]
+    
+    def compile_program(self, source_code: str, filename: str = "main.cpp",
+                        run_after_compile: bool = True) -> dict:
+        """
+        Compile (and run) a program on the cheapest engine that supports it
+        
+        Returns:
+            Dict with success, output, error, and the engine that ran the
+            program with the reason it was chosen
+        """
         try:
-            # Use our custom compiler pipeline
-            return self._compile_with_custom_compiler(source_code, filename, run_after_compile)
-            
+            tokens = Lexer(source_code).tokenize()
+            decision = self.route(tokens)
+            if decision.engine == ENGINE_CUSTOM:
+                success, output, error = self._compile_with_custom_compiler(
+                    source_code, filename, run_after_compile, tokens)
+                if not success and error.startswith(CUSTOM_COMPILE_ERRORS) and self.gpp_available:
+                    # The prescan can't see every unsupported construct
+                    decision = RoutingDecision(ENGINE_GPP, f"custom pipeline rejected the program ({error})",
+                                               decision.features)
+            if decision.engine == ENGINE_GPP:
+                success, output, error = self._compile_with_real_gpp(source_code, filename, run_after_compile)
         except Exception as e:
-            return False, "", f"Compilation error: {str(e)}"
+            return self.response(False, "", f"Compilation error: {str(e)}", None)
+        return self.response(success, output, error, decision)
+    
+    def response(self, success: bool, output: str, error: str, decision: Optional[RoutingDecision]) -> dict:
+        """Build the result of compile_program"""
+        return {
+            "success": success,
+            "output": output,
+            "error": error,
+            "engine": decision.engine if decision else None,
+            "routing_reason": decision.reason if decision else None,
+            "detected_features": decision.features if decision else [],
+        }
+    
+    def route(self, tokens: List[Token]) -> RoutingDecision:
+        """Pick an engine from the features the program uses"""
+        features = scan_features(tokens)
+        if not features:
+            return RoutingDecision(ENGINE_CUSTOM, "only uses features the custom pipeline implements", [])
+        listed = ", ".join(features[:5]) + (", ..." if len(features) > 5 else "")
+        if not self.gpp_available:
+            return RoutingDecision(ENGINE_CUSTOM, f"g++ is unavailable; program uses {listed}", features)
+        return RoutingDecision(ENGINE_GPP, f"uses {listed}", features)
     
     def _compile_with_custom_compiler(self, source_code: str, filename: str, 
-                                    run_after_compile: bool) -> Tuple[bool, str, str]:
-        """Compile using our custom compiler pipeline"""
+                                    run_after_compile: bool,
+                                    tokens: Optional[List[Token]] = None) -> Tuple[bool, str, str]:
+        """Compile using our custom compiler pipeline (tokens: already lexed source)"""
         try:
             # Phase 1: Lexical Analysis
-            lexer = Lexer(source_code)
-            tokens = lexer.tokenize()
+            if tokens is None:
+                lexer = Lexer(source_code)
+                tokens = lexer.tokenize()
             
             # Phase 2: Syntax Analysis
             parser = Parser(tokens)
@@ -90,8 +227,11 @@ class ProductionCppCompiler:
             
             # Phase 4: Code Generation
             generator = CodeGenerator(analyzer)
-            generated_code = generator.generate(ast)
-            
+            generated_code = compile(generator.generate(ast), filename, 'exec')
+        except Exception as e:
+            return False, "", f"Compilation failed: {str(e)}"
+        
+        try:
             # Phase 5: Execution (if requested)
             output = ""
             if run_after_compile:
@@ -124,7 +264,7 @@ class ProductionCppCompiler:
             return True, output, ""
             
         except Exception as e:
-            return False, "", f"Compilation failed: {str(e)}"
+            return False, "", f"Runtime error: {str(e)}"
     
     def _compile_with_real_gpp(self, source_code: str, filename: str, 
                              run_after_compile: bool) -> Tuple[bool, str, str]:
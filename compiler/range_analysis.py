@@ -0,0 +1,299 @@
+"""
+C++ Integer Range Analysis
+This module computes conservative value ranges for integer expressions so the
+code generator only emits 32/64-bit wraparound masks where overflow is possible.
+"""
+
+from typing import Dict, Optional, Tuple
+from parser import *
+from visitor import Visitor, handles
+
+Range = Tuple[int, int]
+
+# Value ranges of the fixed-width integer types (int is 32-bit, long 64-bit)
+INTEGER_RANGES: Dict[str, Range] = {
+    'int': (-2**31, 2**31 - 1),
+    'long': (-2**63, 2**63 - 1),
+    'bool': (0, 1),
+}
+
+class RangeAnalysis(Visitor):
+    """Interval analysis over the integer expressions of one function at a time
+
+    Variables get a range only when it holds for every read: locals that are
+    assigned once (at their declaration) take the range of their initializer,
+    and for-loop counters stepped by ++/-- towards a bounded limit take the
+    span from their start to that limit. Everything else is assumed to hold
+    any value of its type.
+    """
+
+    def __init__(self, program: Optional[Program] = None):
+        self.global_names = set()
+        # Callee name -> positions of reference parameters (writes through calls)
+        self.reference_parameters: Dict[str, set] = {}
+        if program is not None:
+            self.collect_program(program)
+        self.reset()
+
+    def collect_program(self, program: Program):
+        """Record globals and reference parameters of every function"""
+        for declaration in program.declarations:
+            if isinstance(declaration, VariableDeclaration):
+                self.global_names.add(declaration.name)
+            elif isinstance(declaration, FunctionDeclaration):
+                self.note_reference_parameters(declaration.name, declaration.parameters)
+            elif isinstance(declaration, ClassDeclaration):
+                for function in declaration.methods + declaration.constructors:
+                    self.note_reference_parameters(function.name, function.parameters)
+
+    def note_reference_parameters(self, name: str, parameters: List[tuple]):
+        """Remember which argument positions of name are passed by reference"""
+        positions = self.reference_parameters.setdefault(name, set())
+        for i, (param_type, _) in enumerate(parameters):
+            if param_type.is_reference:
+                positions.add(i)
+
+    def reset(self):
+        """Forget everything learned about the current function"""
+        self.function_nodes = set()
+        self.variable_ranges: Dict[str, Range] = {}
+        self.single_assignments: Dict[str, VariableDeclaration] = {}
+        self.pending = set()
+        self.safe_steps = set()
+        self.cache: Dict[Expression, Optional[Range]] = {}
+
+    def analyze_function(self, function: FunctionDeclaration, class_node: Optional[ClassDeclaration] = None):
+        """Find the variables of function whose values stay in a known range"""
+        self.reset()
+        nodes = list(walk(function.body))
+        self.function_nodes = set(nodes)
+
+        # Names that may refer to something other than one local variable
+        excluded = set(self.global_names)
+        excluded.update(name for _, name in function.parameters)
+        if class_node is not None:
+            excluded.update(member.name for member in class_node.members)
+
+        declarations: Dict[str, list] = {}
+        writes: Dict[str, int] = {}
+        for node in nodes:
+            if isinstance(node, VariableDeclaration):
+                declarations.setdefault(node.name, []).append(node)
+            elif isinstance(node, Assignment) and isinstance(node.target, Identifier):
+                writes[node.target.name] = writes.get(node.target.name, 0) + 1
+            elif (isinstance(node, UnaryOperation) and node.operator in ['++', '--', '++_post', '--_post']
+                    and isinstance(node.operand, Identifier)):
+                writes[node.operand.name] = writes.get(node.operand.name, 0) + 1
+            elif isinstance(extraction_target(node), Identifier):
+                # cin >> name
+                writes[node.right.name] = writes.get(node.right.name, 0) + 1
+            elif isinstance(node, (FunctionCall, MethodCall)):
+                positions = self.reference_parameters.get(node.name, ())
+                for i, argument in enumerate(node.arguments):
+                    if i in positions and isinstance(argument, Identifier):
+                        writes[argument.name] = writes.get(argument.name, 0) + 1
+
+        def is_integer_local(name: str) -> bool:
+            decls = declarations.get(name, [])
+            return (name not in excluded and len(decls) == 1
+                    and decls[0].var_type.name in INTEGER_RANGES and not decls[0].var_type.is_reference)
+
+        for name, decls in declarations.items():
+            declaration = decls[0]
+            if (is_integer_local(name) and not writes.get(name)
+                    and declaration.initializer is not None
+                    and not isinstance(declaration.initializer, InitializerList)):
+                self.single_assignments[name] = declaration
+
+        for node in nodes:
+            if isinstance(node, ForStatement) and isinstance(node.init, VariableDeclaration):
+                name = node.init.name
+                if is_integer_local(name) and writes.get(name) == 1 and node.init.initializer is not None:
+                    self.analyze_counter(node, node.init.var_type.name)
+
+    def analyze_counter(self, loop: ForStatement, type_name: str):
+        """Bound a for-loop counter that only its own ++/-- update writes"""
+        name = loop.init.name
+        update, condition = loop.update, loop.condition
+        if not (isinstance(update, UnaryOperation) and isinstance(update.operand, Identifier)
+                and update.operand.name == name):
+            return
+        if not (isinstance(condition, BinaryOperation) and isinstance(condition.left, Identifier)
+                and condition.left.name == name):
+            return
+        start = self.expression_range(loop.init.initializer)
+        limit = self.expression_range(condition.right)
+        low, high = INTEGER_RANGES[type_name]
+        if start is None or limit is None or limit[0] < low or limit[1] > high:
+            return
+        start = (max(start[0], low), min(start[1], high))
+
+        increasing = update.operator in ['++', '++_post']
+        if increasing and condition.operator == '<':
+            # The step runs only after i < limit held, so i + 1 <= limit
+            self.variable_ranges[name] = (start[0], max(start[1], limit[1]))
+            self.safe_steps.add(update)
+        elif increasing and condition.operator == '<=' and limit[1] < high:
+            self.variable_ranges[name] = (start[0], max(start[1], limit[1] + 1))
+            self.safe_steps.add(update)
+        elif not increasing and condition.operator == '>':
+            self.variable_ranges[name] = (min(start[0], limit[0]), start[1])
+            self.safe_steps.add(update)
+        elif not increasing and condition.operator == '>=' and limit[0] > low:
+            self.variable_ranges[name] = (min(start[0], limit[0] - 1), start[1])
+            self.safe_steps.add(update)
+        # Ranges seen before the counter was bounded are stale
+        self.cache.clear()
+
+    def type_range(self, node: Expression) -> Optional[Range]:
+        """Full range of node's integer type, or None for non-integer types"""
+        return INTEGER_RANGES.get(node.static_type)
+
+    def expression_range(self, node: Expression) -> Optional[Range]:
+        """Range of the value node evaluates to after any wraparound"""
+        if node in self.cache:
+            return self.cache[node]
+        bounds = self.type_range(node)
+        if bounds is not None:
+            raw = self.raw_range(node)
+            if raw is not None and bounds[0] <= raw[0] and raw[1] <= bounds[1]:
+                bounds = raw
+        self.cache[node] = bounds
+        return bounds
+
+    def needs_wrap(self, node: Expression) -> bool:
+        """Whether node's exact result can fall outside its integer type"""
+        bounds = self.type_range(node)
+        if bounds is None or node in self.safe_steps:
+            return False
+        if isinstance(node, UnaryOperation) and node.operator in ['++', '--', '++_post', '--_post']:
+            operand = self.expression_range(node.operand)
+            step = 1 if node.operator.startswith('++') else -1
+            raw = (operand[0] + step, operand[1] + step) if operand else None
+        else:
+            raw = self.raw_range(node)
+        return raw is None or raw[0] < bounds[0] or raw[1] > bounds[1]
+
+    def is_non_negative(self, node: Expression) -> bool:
+        """Whether node is an integer that is never negative"""
+        bounds = self.expression_range(node)
+        return bounds is not None and bounds[0] >= 0
+
+    def fits(self, node: Expression, type_name: str) -> bool:
+        """Whether node's value always fits in the integer type type_name"""
+        bounds = self.expression_range(node)
+        target = INTEGER_RANGES.get(type_name)
+        return (bounds is not None and target is not None
+                and target[0] <= bounds[0] and bounds[1] <= target[1])
+
+    def raw_range(self, node: Expression) -> Optional[Range]:
+        """Exact (unwrapped) range of node's result, assuming in-range operands"""
+        handler = self.range_handlers[type(node)]
+        if handler is None:
+            return self.type_range(node)
+        return handler(self, node)
+
+    @handles('range', Literal)
+    def literal_range(self, node: Literal) -> Optional[Range]:
+        """Range of an integer or bool constant"""
+        if node.type_name in ['int', 'long', 'bool']:
+            return (int(node.value), int(node.value))
+        return None
+
+    @handles('range', UnaryOperation)
+    def unary_range(self, node: UnaryOperation) -> Optional[Range]:
+        """Range of a unary operation's result"""
+        if node.operator == '!':
+            return (0, 1)
+        operand = self.expression_range(node.operand)
+        if operand is None:
+            return None
+        if node.operator == '-':
+            return (-operand[1], -operand[0])
+        if node.operator == '+' or node.operator.endswith('_post'):
+            return operand
+        step = 1 if node.operator == '++' else -1
+        return (operand[0] + step, operand[1] + step)
+
+    @handles('range', Identifier)
+    def identifier_range(self, node: Identifier) -> Optional[Range]:
+        """Range of a variable read"""
+        bounds = self.type_range(node)
+        if node not in self.function_nodes or bounds is None:
+            return bounds
+        if node.name in self.variable_ranges:
+            return self.variable_ranges[node.name]
+        declaration = self.single_assignments.get(node.name)
+        if declaration is None or node.name in self.pending:
+            return bounds
+        self.pending.add(node.name)
+        initial = self.expression_range(declaration.initializer)
+        self.pending.discard(node.name)
+        target = INTEGER_RANGES[declaration.var_type.name]
+        if initial is None or initial[0] < target[0] or initial[1] > target[1]:
+            initial = target
+        self.variable_ranges[node.name] = initial
+        return initial
+
+    @handles('range', BinaryOperation)
+    def binary_range(self, node: BinaryOperation) -> Optional[Range]:
+        """Interval arithmetic for one binary operation"""
+        if node.operator in ['==', '!=', '<', '>', '<=', '>=', '&&', '||']:
+            return (0, 1)
+        left = self.expression_range(node.left)
+        right = self.expression_range(node.right)
+        if left is None or right is None:
+            return None
+        if node.operator == '+':
+            return (left[0] + right[0], left[1] + right[1])
+        if node.operator == '-':
+            return (left[0] - right[1], left[1] - right[0])
+        if node.operator == '*':
+            products = [a * b for a in left for b in right]
+            return (min(products), max(products))
+        magnitude = max(abs(left[0]), abs(left[1]))
+        if node.operator == '/':
+            # Truncating division never grows the dividend, except INT_MIN / -1
+            if left[0] >= 0 and right[0] > 0:
+                return (left[0] // right[1], left[1] // right[0])
+            return (-magnitude, magnitude)
+        if node.operator == '%':
+            # The remainder takes the dividend's sign and is smaller than the divisor
+            bound = max(0, min(magnitude, max(abs(right[0]), abs(right[1])) - 1))
+            return (0 if left[0] >= 0 else -bound, 0 if left[1] <= 0 else bound)
+        return None
+
+def main():
+    """Test the range analysis"""
+    from lexer import Lexer
+    from semantic_analyzer import SemanticAnalyzer
+
+    sample_code = """
+int main() {
+    int total = 0;
+    for (int i = 0; i < 100; i++) {
+        int square = i * i;
+        total = total + square;
+    }
+    return 0;
+}
+"""
+
+    ast = Parser(Lexer(sample_code).tokenize()).parse()
+    analyzer = SemanticAnalyzer()
+    if not analyzer.analyze(ast):
+        print("Semantic errors found:")
+        for error in analyzer.errors:
+            print(f"  {error}")
+        return
+
+    ranges = RangeAnalysis(ast)
+    function = ast.declarations[0]
+    ranges.analyze_function(function)
+    for node in walk(function.body):
+        if isinstance(node, (BinaryOperation, UnaryOperation)) and ranges.type_range(node):
+            print(f"{node}: range {ranges.expression_range(node)}, "
+                  f"{'needs' if ranges.needs_wrap(node) else 'no'} wrap")
+
+if __name__ == "__main__":
+    main()
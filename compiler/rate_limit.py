@@ -0,0 +1,148 @@
+"""
+Request Admission Limits
+Per-client token buckets for /compile and the request-size caps. Both are
+checked before a request body is decoded, and oversized bodies are refused
+from their Content-Length before they are read, so clients over their rate or
+sending huge programs are turned away with 429 or 413 without reaching the
+compiler.
+"""
+
+import hashlib
+import math
+import os
+import threading
+import time
+from collections import OrderedDict
+from typing import Callable, FrozenSet, NamedTuple, Optional, Tuple
+
+class AdmissionLimits(NamedTuple):
+    """Rate and size limits for /compile
+
+    rate is requests per second refilled into each client's bucket, burst the
+    bucket size; rate 0 disables rate limiting. The body cap allows for JSON
+    escaping of a program up to max_code_bytes. With key 'token', clients
+    sending one of the known bearer tokens get a bucket per token; any other
+    Authorization header is ignored, since a client could send a new one with
+    every request to get a fresh bucket.
+    """
+    rate: float = 20.0
+    burst: int = 60
+    key: str = 'ip'               # 'ip': IP only; 'token': a known bearer token, else IP
+    tokens: FrozenSet[str] = frozenset()
+    max_code_bytes: int = 256 * 1024
+    max_body_bytes: int = 2 * 256 * 1024 + 4096
+
+    @classmethod
+    def from_environment(cls) -> 'AdmissionLimits':
+        """Limits overridden by RATE_LIMIT_RPS, RATE_LIMIT_BURST, RATE_LIMIT_KEY,
+        RATE_LIMIT_TOKENS (comma-separated), MAX_CODE_BYTES and MAX_BODY_BYTES"""
+        defaults = cls()
+        max_code_bytes = int(os.environ.get('MAX_CODE_BYTES', defaults.max_code_bytes))
+        return cls(
+            rate=float(os.environ.get('RATE_LIMIT_RPS', defaults.rate)),
+            burst=int(os.environ.get('RATE_LIMIT_BURST', defaults.burst)),
+            key=os.environ.get('RATE_LIMIT_KEY', defaults.key),
+            tokens=frozenset(filter(None, (token.strip() for token in
+                                           os.environ.get('RATE_LIMIT_TOKENS', '').split(',')))),
+            max_code_bytes=max_code_bytes,
+            max_body_bytes=int(os.environ.get('MAX_BODY_BYTES', 2 * max_code_bytes + 4096)),
+        )
+
+def known_token(limits: AdmissionLimits, authorization: Optional[str]) -> Optional[str]:
+    """The bearer token of an Authorization header if it is one of the known tokens, else None"""
+    if not authorization:
+        return None
+    scheme, _, token = authorization.strip().partition(' ')
+    token = token.strip()
+    return token if scheme.lower() == 'bearer' and token in limits.tokens else None
+
+def client_key(limits: AdmissionLimits, remote_addr: Optional[str], authorization: Optional[str]) -> str:
+    """Rate-limit key of a client: its bearer token when configured and known, else its IP"""
+    token = known_token(limits, authorization) if limits.key == 'token' else None
+    if token:
+        return 'token:' + hashlib.sha256(token.encode('utf-8')).hexdigest()[:32]
+    return 'ip:' + (remote_addr or 'unknown')
+
+class RateLimiter:
+    """Token buckets keyed by client, holding at most max_clients least recently seen clients
+
+    Each bucket is a [tokens, last refill time] pair refilled lazily on access,
+    so a check is O(1) and idle clients cost nothing until they are evicted.
+    """
+
+    def __init__(self, rate: float, burst: int, max_clients: int = 100_000,
+                 clock: Callable[[], float] = time.monotonic):
+        self.rate = rate
+        self.burst = max(1, burst)
+        self.max_clients = max_clients
+        self.clock = clock
+        self.buckets: 'OrderedDict[str, list]' = OrderedDict()
+        self.lock = threading.Lock()
+        self.allowed = 0
+        self.rejected = 0
+
+    @property
+    def enabled(self) -> bool:
+        return self.rate > 0
+
+    def allow(self, key: str) -> Tuple[bool, float]:
+        """Take a token for key: (allowed, seconds until a token is available)"""
+        if self.rate <= 0:
+            return True, 0.0
+        now = self.clock()
+        with self.lock:
+            bucket = self.buckets.get(key)
+            if bucket is None:
+                bucket = self.buckets[key] = [float(self.burst), now]
+                if len(self.buckets) > self.max_clients:
+                    self.buckets.popitem(last=False)
+            else:
+                self.buckets.move_to_end(key)
+                bucket[0] = min(float(self.burst), bucket[0] + (now - bucket[1]) * self.rate)
+                bucket[1] = now
+            if bucket[0] >= 1.0:
+                bucket[0] -= 1.0
+                self.allowed += 1
+                return True, 0.0
+            self.rejected += 1
+            return False, (1.0 - bucket[0]) / self.rate
+
+    def stats(self) -> dict:
+        return {"rate": self.rate, "burst": self.burst, "clients": len(self.buckets),
+                "allowed": self.allowed, "rejected": self.rejected}
+
+def retry_after(seconds: float) -> str:
+    """Retry-After header value, in whole seconds"""
+    return str(max(1, math.ceil(seconds)))
+
+def too_large(limit: int, what: str = "Request body") -> dict:
+    """413 response body"""
+    return {
+        "success": False,
+        "error": f"{what} too large",
+        "details": [f"{what} is limited to {limit} bytes"],
+        "output": "",
+        "execution_output": ""
+    }
+
+def too_many_requests(wait: float) -> dict:
+    """429 response body"""
+    return {
+        "success": False,
+        "error": "Too many requests",
+        "details": [f"Rate limit exceeded; retry in {wait:.1f} seconds"],
+        "output": "",
+        "execution_output": ""
+    }
+
+def main():
+    """Test a limiter with a simulated clock"""
+    now = [0.0]
+    limiter = RateLimiter(rate=2, burst=3, clock=lambda: now[0])
+    for _ in range(8):
+        print(f"t={now[0]:.2f}s {limiter.allow('ip:127.0.0.1')}")
+        now[0] += 0.25
+    print(limiter.stats())
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,277 @@
+"""
+Server Readiness Statistics
+Sliding-window request statistics for the /ready endpoint: queue depth and
+wait, worker utilization and latency percentiles. Requests are recorded into a
+ring of one-second buckets, each holding a log-scale latency histogram and the
+time requests spent queued for a worker. Running totals
+over the whole window are kept alongside, so recording is O(1) and a readiness
+check only walks one histogram.
+"""
+
+import itertools
+import math
+import os
+import threading
+import time
+from typing import Callable, Dict, NamedTuple, Optional, Tuple
+
+# Latency histogram: bin i holds latencies up to BIN_BASE * 2 ** (i / BINS_PER_DOUBLING)
+BIN_BASE = 0.0001          # 0.1 ms
+BINS_PER_DOUBLING = 4      # ~19% bin width
+BIN_COUNT = 80             # up to ~100 s; slower requests land in the last bin
+
+# Shortest window rates and utilization are averaged over, so one slow request
+# right after startup doesn't read as a saturated server
+MIN_WINDOW_SECONDS = 5.0
+
+def latency_bin(seconds: float) -> int:
+    """Histogram bin of a latency"""
+    if seconds <= BIN_BASE:
+        return 0
+    return min(BIN_COUNT - 1, math.ceil(math.log2(seconds / BIN_BASE) * BINS_PER_DOUBLING))
+
+def bin_upper_bound(index: int) -> float:
+    """Largest latency counted in a bin, in seconds"""
+    return BIN_BASE * 2 ** (index / BINS_PER_DOUBLING)
+
+class Bucket:
+    """Counters for one second of the window"""
+    __slots__ = ('second', 'counts', 'requests', 'errors', 'busy', 'waits', 'waited')
+
+    def __init__(self):
+        self.second = -1
+        self.counts = [0] * BIN_COUNT
+        self.requests = 0
+        self.errors = 0
+        self.busy = 0.0
+        self.waits = 0
+        self.waited = 0.0
+
+class ReadinessThresholds(NamedTuple):
+    """Limits above which a server reports itself not ready"""
+    max_queue_depth: int = 16
+    max_utilization: float = 0.95
+    max_p95_ms: float = 5000.0
+    # Latency percentiles are ignored until the window holds this many requests
+    min_samples: int = 20
+
+    @classmethod
+    def from_environment(cls) -> 'ReadinessThresholds':
+        """Thresholds overridden by READY_MAX_QUEUE, READY_MAX_UTILIZATION and READY_MAX_P95_MS"""
+        defaults = cls()
+        return cls(
+            max_queue_depth=int(os.environ.get('READY_MAX_QUEUE', defaults.max_queue_depth)),
+            max_utilization=float(os.environ.get('READY_MAX_UTILIZATION', defaults.max_utilization)),
+            max_p95_ms=float(os.environ.get('READY_MAX_P95_MS', defaults.max_p95_ms)),
+        )
+
+class RequestStats:
+    """Thread-safe sliding-window statistics of requests served by a worker pool
+
+    A request is queued() while it waits for a worker and start()ed once it
+    has one, so its latency and the workers' busy time cover only the work,
+    and the wait is recorded on its own. Busy time is spread over the seconds
+    it covered, so a long request finishing now adds only its time inside the
+    window to utilization.
+    """
+
+    def __init__(self, workers: int, window_seconds: int = 60,
+                 clock: Callable[[], float] = time.monotonic):
+        self.workers = max(1, workers)
+        self.window_seconds = window_seconds
+        self.clock = clock
+        self.started = clock()
+        self.lock = threading.Lock()
+
+        self.buckets = [Bucket() for _ in range(window_seconds)]
+        self.second = int(self.started)
+        # Running sums over the buckets in the window
+        self.counts = [0] * BIN_COUNT
+        self.requests = 0
+        self.errors = 0
+        self.busy = 0.0
+        self.waits = 0
+        self.waited = 0.0
+
+        self.waiting: Dict[int, float] = {}
+        self.in_flight: Dict[int, float] = {}
+        self.tokens = itertools.count()
+
+    def advance(self, now: float):
+        """Expire buckets that have left the window; amortized O(1) per second"""
+        second = int(now)
+        if second - self.second >= self.window_seconds:
+            for bucket in self.buckets:
+                bucket.second = -1
+                bucket.counts = [0] * BIN_COUNT
+                bucket.requests = bucket.errors = bucket.waits = 0
+                bucket.busy = bucket.waited = 0.0
+            self.counts = [0] * BIN_COUNT
+            self.requests = self.errors = self.waits = 0
+            self.busy = self.waited = 0.0
+            self.second = second
+            return
+        while self.second < second:
+            self.second += 1
+            bucket = self.buckets[self.second % self.window_seconds]
+            if bucket.requests:
+                for index, count in enumerate(bucket.counts):
+                    if count:
+                        self.counts[index] -= count
+                        bucket.counts[index] = 0
+                self.requests -= bucket.requests
+                self.errors -= bucket.errors
+                bucket.requests = bucket.errors = 0
+            if bucket.busy:
+                self.busy -= bucket.busy
+                bucket.busy = 0.0
+            if bucket.waits:
+                self.waits -= bucket.waits
+                self.waited -= bucket.waited
+                bucket.waits = 0
+                bucket.waited = 0.0
+            bucket.second = self.second
+
+    def queued(self) -> int:
+        """Note a request starting to wait for a worker; returns a token for dequeued()"""
+        token = next(self.tokens)
+        with self.lock:
+            self.waiting[token] = self.clock()
+        return token
+
+    def dequeued(self, token: int):
+        """Record the end of a request's wait, whether it got a worker or gave up"""
+        now = self.clock()
+        with self.lock:
+            started = self.waiting.pop(token, now)
+            self.advance(now)
+            bucket = self.buckets[self.second % self.window_seconds]
+            bucket.waits += 1
+            bucket.waited += now - started
+            self.waits += 1
+            self.waited += now - started
+
+    def add_busy(self, start: float, end: float):
+        """Spread a worker's busy interval over the buckets of the seconds it covers
+
+        Called with the lock held after advance(end); time before the window is dropped.
+        """
+        second = int(start)
+        oldest = self.second - self.window_seconds + 1
+        if second < oldest:
+            second, start = oldest, float(oldest)
+        while start < end:
+            until = min(end, second + 1)
+            self.buckets[second % self.window_seconds].busy += until - start
+            self.busy += until - start
+            second, start = second + 1, until
+
+    def start(self) -> int:
+        """Note a request acquiring a worker; returns a token for finish()"""
+        token = next(self.tokens)
+        with self.lock:
+            self.in_flight[token] = self.clock()
+        return token
+
+    def finish(self, token: int, success: bool = True):
+        """Record a request releasing its worker: busy from start() to now"""
+        now = self.clock()
+        with self.lock:
+            started = self.in_flight.pop(token, now)
+            self.advance(now)
+            latency = now - started
+            index = latency_bin(latency)
+            bucket = self.buckets[self.second % self.window_seconds]
+            bucket.counts[index] += 1
+            bucket.requests += 1
+            self.counts[index] += 1
+            self.requests += 1
+            self.add_busy(started, now)
+            if not success:
+                bucket.errors += 1
+                self.errors += 1
+
+    def percentile(self, fraction: float) -> Optional[float]:
+        """Latency below which `fraction` of the window's requests finished, in seconds"""
+        if self.requests == 0:
+            return None
+        target = fraction * self.requests
+        seen = 0
+        for index, count in enumerate(self.counts):
+            seen += count
+            if seen >= target:
+                return bin_upper_bound(index)
+        return bin_upper_bound(BIN_COUNT - 1)
+
+    def snapshot(self) -> dict:
+        """Current statistics over the window"""
+        now = self.clock()
+        with self.lock:
+            self.advance(now)
+            window = min(self.window_seconds, max(now - self.started, MIN_WINDOW_SECONDS))
+            window_start = now - window
+            # Requests still running count as busy for their time inside the window
+            running = sum(now - max(started, window_start) for started in self.in_flight.values())
+            oldest = max((now - started for started in self.in_flight.values()), default=0.0)
+            oldest_queued = max((now - queued for queued in self.waiting.values()), default=0.0)
+            p50, p95, p99 = (self.percentile(f) for f in (0.5, 0.95, 0.99))
+            return {
+                "window_seconds": round(window, 3),
+                "workers": self.workers,
+                "in_flight": len(self.in_flight),
+                "queue_depth": len(self.waiting),
+                "oldest_in_flight_seconds": round(oldest, 3),
+                "oldest_queued_seconds": round(oldest_queued, 3),
+                "queue_wait_ms": {
+                    "total": round(self.waited * 1000, 3),
+                    "mean": round(self.waited / self.waits * 1000, 3) if self.waits else None,
+                },
+                "utilization": round(min(1.0, (self.busy + running) / (window * self.workers)), 4),
+                "requests": self.requests,
+                "errors": self.errors,
+                "requests_per_second": round(self.requests / window, 3),
+                "latency_ms": {
+                    "p50": None if p50 is None else round(p50 * 1000, 3),
+                    "p95": None if p95 is None else round(p95 * 1000, 3),
+                    "p99": None if p99 is None else round(p99 * 1000, 3),
+                },
+            }
+
+def check_readiness(stats: RequestStats, thresholds: ReadinessThresholds) -> Tuple[int, dict]:
+    """(HTTP status, body) for /ready: 503 with the reasons when any threshold is exceeded"""
+    snapshot = stats.snapshot()
+    reasons = []
+    if snapshot['queue_depth'] > thresholds.max_queue_depth:
+        reasons.append(f"queue depth {snapshot['queue_depth']} > {thresholds.max_queue_depth}")
+    if snapshot['utilization'] > thresholds.max_utilization:
+        reasons.append(f"utilization {snapshot['utilization']:.2f} > {thresholds.max_utilization:.2f}")
+    p95 = snapshot['latency_ms']['p95']
+    if snapshot['requests'] >= thresholds.min_samples and p95 is not None and p95 > thresholds.max_p95_ms:
+        reasons.append(f"p95 latency {p95:.0f} ms > {thresholds.max_p95_ms:.0f} ms")
+    return (503 if reasons else 200), {
+        "ready": not reasons,
+        "reasons": reasons,
+        "thresholds": thresholds._asdict(),
+        "stats": snapshot,
+    }
+
+def main():
+    """Test the readiness statistics with a simulated clock"""
+    now = [1000.0]
+    stats = RequestStats(workers=2, window_seconds=10, clock=lambda: now[0])
+    for i in range(100):
+        token = stats.start()
+        now[0] += 0.01 if i % 10 else 0.5
+        stats.finish(token)
+    print(check_readiness(stats, ReadinessThresholds(max_p95_ms=400)))
+
+    # Two requests stuck in the pool and five more waiting behind them
+    for _ in range(2):
+        stats.start()
+    for _ in range(5):
+        stats.queued()
+    now[0] += 30
+    print(check_readiness(stats, ReadinessThresholds()))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+"""
+Speculative Pre-compilation
+While the user pauses typing, the app submits its buffer with "speculative":
+true. The server compiles and runs the program on an idle worker, and only on
+an idle worker, and keeps the result by the content hash of the source and
+options. When the user then taps Run, the same program is answered from that
+result instead of being compiled again.
+
+Programs in the supported C++ subset have no effects outside their result:
+/compile gives them an empty standard input, they touch no files, clock or
+random source, and their output goes to the result. The result also depends
+only on the source and options, which is why it can be keyed by their hash.
+A half-typed buffer may still never finish, so a speculative compile and run
+is stopped after SPECULATION_TIME_LIMIT_MS and its result is dropped rather
+than stored; a Run of that program compiles it normally.
+
+Responses to speculative requests carry an X-Speculative header: "compiled",
+"cached" when the result was already known, "skipped" (202, with no result)
+when no worker was idle, or "timed-out" (202, with no result).
+"""
+
+import hashlib
+import os
+import threading
+from collections import OrderedDict
+from typing import Callable, Optional, Tuple
+
+from judge import TimeLimitExceeded, time_limit
+
+SPECULATIVE_HEADER = 'X-Speculative'
+COMPILED = 'compiled'
+CACHED = 'cached'
+SKIPPED = 'skipped'
+TIMED_OUT = 'timed-out'
+
+# Longest a speculative compile and run may take
+SPECULATION_TIME_LIMIT_MS = int(os.environ.get('SPECULATION_TIME_LIMIT_MS', 1000))
+
+def is_speculative(data: dict) -> bool:
+    return data.get('speculative') is True
+
+def result_key(source_code: str, context) -> bytes:
+    """Cache key of a program's result: the hash of its source and compilation options"""
+    return (b'result:' + repr(context).encode('utf-8')
+            + hashlib.sha256(source_code.encode('utf-8')).digest())
+
+def skipped_response() -> dict:
+    return {
+        "success": False,
+        "error": "All workers are busy; the program was not pre-compiled",
+        "details": [],
+        "output": "",
+        "execution_output": ""
+    }
+
+def timed_out_response() -> dict:
+    return {
+        "success": False,
+        "error": f"The program ran longer than {SPECULATION_TIME_LIMIT_MS} ms; it was not pre-compiled",
+        "details": [],
+        "output": "",
+        "execution_output": ""
+    }
+
+def run_speculatively(compile_function: Callable[..., dict], source_code: str, context) -> Optional[dict]:
+    """compile_function(source_code, context) under the speculation time limit; None if it ran out"""
+    try:
+        with time_limit(SPECULATION_TIME_LIMIT_MS / 1000):
+            return compile_function(source_code, context)
+    except TimeLimitExceeded:
+        return None
+
+class ResultCache:
+    """Encoded results by result_key, holding at most max_bytes
+
+    Values are the status code's three digits followed by the JSON body. With
+    a SharedCache the results are kept there, so every prefork process can
+    answer a Run for a program another one pre-compiled.
+    """
+
+    def __init__(self, max_bytes: int = 16 * 1024 * 1024, shared=None):
+        self.max_bytes = max_bytes
+        self.shared = shared
+        self.results: 'OrderedDict[bytes, bytes]' = OrderedDict()
+        self.size = 0
+        self.lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+
+    def get(self, key: bytes) -> Optional[Tuple[int, bytes]]:
+        """(status, JSON body) of a stored result, or None"""
+        if self.shared is not None:
+            value = self.shared.get(key)
+        else:
+            with self.lock:
+                value = self.results.get(key)
+                if value is not None:
+                    self.results.move_to_end(key)
+        if value is None:
+            self.misses += 1
+            return None
+        self.hits += 1
+        return int(value[:3]), value[3:]
+
+    def put(self, key: bytes, status: int, body: bytes):
+        value = b'%d' % status + body
+        if self.shared is not None:
+            self.shared.put(key, value)
+            return
+        with self.lock:
+            previous = self.results.pop(key, None)
+            if previous is not None:
+                self.size -= len(previous)
+            self.results[key] = value
+            self.size += len(value)
+            while self.size > self.max_bytes and len(self.results) > 1:
+                _, evicted = self.results.popitem(last=False)
+                self.size -= len(evicted)
+
+    def stats(self) -> dict:
+        return {"results": len(self.results), "bytes": self.size, "hits": self.hits,
+                "misses": self.misses, "shared": self.shared is not None}
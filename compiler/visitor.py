@@ -0,0 +1,53 @@
+"""
+AST Visitor Dispatch
+Passes over the AST subclass Visitor and register their per-node methods with
+@handles(table, NodeType, ...). Each Visitor class gets one DispatchTable per
+table name, as the class attribute <table>_handlers, built once when the class
+is defined. A pass then dispatches with a single dict lookup on type(node)
+instead of a chain of isinstance checks, each of which goes through
+ABCMeta.__instancecheck__ for AST nodes.
+"""
+
+from typing import Callable, Dict, Optional
+
+def handles(table: str, *node_types: type):
+    """Register the decorated method as the handler for node_types in table
+
+    Can be stacked to register one method in several tables.
+    """
+    def register(method: Callable) -> Callable:
+        method.handled = getattr(method, 'handled', ()) + tuple((table, node_type) for node_type in node_types)
+        return method
+    return register
+
+class DispatchTable(dict):
+    """Handler functions by node type, called as handler(visitor, node)
+
+    A type that was not registered resolves to the handler of its nearest
+    registered base class, or None, and is remembered.
+    """
+
+    def __missing__(self, node_type: type) -> Optional[Callable]:
+        handler = None
+        for base in node_type.__mro__[1:]:
+            if dict.__contains__(self, base):
+                handler = dict.__getitem__(self, base)
+                break
+        self[node_type] = handler
+        return handler
+
+class Visitor:
+    """Base class of passes that dispatch on node type through DispatchTables"""
+
+    def __init_subclass__(cls, **kwargs):
+        super().__init_subclass__(**kwargs)
+        # Registrations by method name, so a subclass overriding a handler
+        # (decorated or not) replaces it in the table
+        names: Dict[str, Dict[type, str]] = {}
+        for klass in reversed(cls.__mro__):
+            for name, member in vars(klass).items():
+                for table, node_type in getattr(member, 'handled', ()):
+                    names.setdefault(table, {})[node_type] = name
+        for table, handlers in names.items():
+            setattr(cls, f"{table}_handlers",
+                    DispatchTable({node_type: getattr(cls, name) for node_type, name in handlers.items()}))
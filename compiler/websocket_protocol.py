@@ -0,0 +1,164 @@
+"""
+Minimal WebSocket Support (RFC 6455)
+Server side of the WebSocket protocol on asyncio streams, for the asyncio API
+server's live-compile endpoint: the opening handshake, and text messages in
+both directions with fragmentation, ping/pong and close handled here.
+"""
+
+import asyncio
+import base64
+import hashlib
+import struct
+from typing import Optional
+
+GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+OP_CONTINUATION = 0x0
+OP_TEXT = 0x1
+OP_BINARY = 0x2
+OP_CLOSE = 0x8
+OP_PING = 0x9
+OP_PONG = 0xA
+
+CLOSE_NORMAL = 1000
+CLOSE_PROTOCOL_ERROR = 1002
+CLOSE_TOO_BIG = 1009
+
+class WebSocketError(Exception):
+    """Protocol violation by the peer; close with the given code"""
+
+    def __init__(self, code: int, message: str):
+        super().__init__(message)
+        self.code = code
+
+def is_upgrade(headers: dict) -> bool:
+    """Whether request headers (lowercase names) ask for a WebSocket"""
+    return (headers.get('upgrade', '').lower() == 'websocket'
+            and 'upgrade' in headers.get('connection', '').lower())
+
+def accept_key(key: str) -> str:
+    """Sec-WebSocket-Accept value for a Sec-WebSocket-Key"""
+    return base64.b64encode(hashlib.sha1((key + GUID).encode('ascii')).digest()).decode('ascii')
+
+def handshake_response(headers: dict) -> Optional[bytes]:
+    """101 response completing the handshake, or None if the request is not a valid upgrade"""
+    key = headers.get('sec-websocket-key')
+    if not is_upgrade(headers) or not key or headers.get('sec-websocket-version') != '13':
+        return None
+    return ("HTTP/1.1 101 Switching Protocols\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            f"Sec-WebSocket-Accept: {accept_key(key)}\r\n\r\n").encode('latin-1')
+
+def encode_frame(opcode: int, payload: bytes, mask: Optional[bytes] = None) -> bytes:
+    """One final frame; servers send unmasked frames, clients pass a 4-byte mask"""
+    head = bytearray([0x80 | opcode])
+    mask_bit = 0x80 if mask else 0
+    length = len(payload)
+    if length < 126:
+        head.append(mask_bit | length)
+    elif length < 1 << 16:
+        head.append(mask_bit | 126)
+        head += struct.pack('!H', length)
+    else:
+        head.append(mask_bit | 127)
+        head += struct.pack('!Q', length)
+    if mask:
+        head += mask
+        payload = apply_mask(payload, mask)
+    return bytes(head) + payload
+
+def apply_mask(payload: bytes, mask: bytes) -> bytes:
+    # XOR as one big integer; much faster than a per-byte loop
+    repeated = (mask * (len(payload) // 4 + 1))[:len(payload)]
+    return (int.from_bytes(payload, 'big') ^ int.from_bytes(repeated, 'big')).to_bytes(len(payload), 'big')
+
+async def read_frame(reader: asyncio.StreamReader, max_size: int, masked: bool = True) -> tuple:
+    """(fin, opcode, payload) of the next frame, unmasked
+
+    Client frames must be masked and server frames must not be (RFC 6455
+    section 5.1); masked=False reads the server's frames on the client side.
+    """
+    first, second = await reader.readexactly(2)
+    if bool(second & 0x80) != masked:
+        raise WebSocketError(CLOSE_PROTOCOL_ERROR,
+                             "Client frames must be masked" if masked else "Server frames must not be masked")
+    length = second & 0x7F
+    if length == 126:
+        length, = struct.unpack('!H', await reader.readexactly(2))
+    elif length == 127:
+        length, = struct.unpack('!Q', await reader.readexactly(8))
+    if length > max_size:
+        raise WebSocketError(CLOSE_TOO_BIG, f"Frame of {length} bytes exceeds {max_size}")
+    mask = await reader.readexactly(4) if masked else None
+    payload = await reader.readexactly(length)
+    if mask:
+        payload = apply_mask(payload, mask)
+    return bool(first & 0x80), first & 0x0F, payload
+
+class WebSocket:
+    """Server end of an established WebSocket connection"""
+
+    def __init__(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter, max_size: int):
+        self.reader = reader
+        self.writer = writer
+        self.max_size = max_size
+        self.closed = False
+        # Messages are sent from several tasks; drains must not interleave
+        self.send_lock = asyncio.Lock()
+
+    async def receive(self) -> Optional[str]:
+        """The next text message, or None once the connection is closed"""
+        message = bytearray()
+        opcode = None
+        while True:
+            try:
+                fin, frame_opcode, payload = await read_frame(self.reader, self.max_size)
+            except (asyncio.IncompleteReadError, ConnectionError):
+                self.closed = True
+                return None
+            except WebSocketError as e:
+                await self.close(e.code)
+                return None
+            if frame_opcode == OP_PING:
+                await self.send_frame(OP_PONG, payload)
+                continue
+            if frame_opcode == OP_PONG:
+                continue
+            if frame_opcode == OP_CLOSE:
+                await self.close(CLOSE_NORMAL)
+                return None
+            if frame_opcode != OP_CONTINUATION:
+                opcode = frame_opcode
+            message += payload
+            if len(message) > self.max_size:
+                await self.close(CLOSE_TOO_BIG)
+                return None
+            if fin:
+                break
+        if opcode != OP_TEXT:
+            await self.close(CLOSE_PROTOCOL_ERROR)
+            return None
+        try:
+            return message.decode('utf-8')
+        except UnicodeDecodeError:
+            await self.close(CLOSE_PROTOCOL_ERROR)
+            return None
+
+    async def send(self, text: str):
+        await self.send_frame(OP_TEXT, text.encode('utf-8'))
+
+    async def send_frame(self, opcode: int, payload: bytes):
+        if self.closed:
+            return
+        async with self.send_lock:
+            try:
+                self.writer.write(encode_frame(opcode, payload))
+                await self.writer.drain()
+            except ConnectionError:
+                self.closed = True
+
+    async def close(self, code: int = CLOSE_NORMAL):
+        if not self.closed:
+            await self.send_frame(OP_CLOSE, struct.pack('!H', code))
+            self.closed = True
@@ -1,17 +1,33 @@
 // bloc/compiler_bloc.dart
+import 'dart:async';
 import 'package:flutter_bloc/flutter_bloc.dart';
 import '../../services/compiler_api_service.dart';
+import '../../services/live_compile_service.dart';
 import '../../services/custom_language_service.dart';
 import '../../services/custom_language_parser.dart';
+import '../../services/local_storage_service.dart';
 
 part 'compiler_event.dart';
 part 'compiler_state.dart';
 
 class CompilerBloc extends Bloc<CompilerEvent, CompilerState> {
   late CompilerApiService _apiService;
+  late LiveCompileService _liveService;
+  StreamSubscription<LiveUpdate>? _liveSubscription;
+  bool _liveMode = false;
+  // An explicit run in live mode whose result has not arrived yet
+  bool _runPending = false;
+  // Fires when typing pauses, to pre-compile the code before Run is tapped
+  Timer? _idleTimer;
+  static const Duration _idleDelay = Duration(milliseconds: 1200);
+  
+  /// Whether edits are streamed to the server's live-compile session
+  bool get isLiveMode => _liveMode;
   
   CompilerBloc() : super(CompilerInitial()) {
     _apiService = CompilerApiService();
+    _liveService = LiveCompileService();
+    _liveSubscription = _liveService.updates.listen((update) => add(LiveUpdateReceived(update)));
     
     on<CompileCode>(_onCompileCode);
     on<TestConnection>(_onTestConnection);
@@ -22,42 +38,39 @@ class CompilerBloc extends Bloc<CompilerEvent, CompilerState> {
     on<LoadCode>(_onLoadCode);
     on<ClearCode>(_onClearCode);
     on<ChangeTab>(_onChangeTab);
+    on<ToggleLiveMode>(_onToggleLiveMode);
+    on<CodeEdited>(_onCodeEdited);
+    on<LiveUpdateReceived>(_onLiveUpdateReceived);
     
     // Auto-test connection on startup
     add(TestConnection());
   }
 
   void _onCompileCode(CompileCode event, Emitter<CompilerState> emit) async {
+    _idleTimer?.cancel();
     emit(Compiling(
       isServerConnected: state.isServerConnected,
       serverUrl: state.serverUrl,
     ));
     
     try {
-      String codeToCompile = event.code;
-      
-      // Check if there's an active custom language
       await CustomLanguageService.instance.initialize();
       final activeLanguage = CustomLanguageService.instance.activeLanguage;
       
-      if (activeLanguage != null) {
-        // Parse custom language code to C++
+      // Let the server translate custom-language code when it can; it keeps
+      // each uploaded language's translator
+      String? languageHash;
+      if (activeLanguage != null && !_liveMode) {
+        languageHash = await _apiService.registerLanguage(activeLanguage);
+      }
+      
+      String codeToCompile = event.code;
+      if (languageHash == null) {
         try {
-          final parser = CustomLanguageParser(activeLanguage);
-          codeToCompile = parser.parseToCpp(event.code);
+          codeToCompile = await _toCpp(event.code);
         } catch (e) {
-          String errorMessage = e.toString();
-          
-          // Clean up the error message for better user experience
-          if (errorMessage.contains('CustomLanguageParserException:')) {
-            errorMessage = errorMessage.replaceFirst('CustomLanguageParserException: ', '');
-          }
-          if (errorMessage.contains('Failed to parse custom language:')) {
-            errorMessage = errorMessage.replaceFirst('Failed to parse custom language: ', '');
-          }
-          
           emit(CompilationError(
-            error: '🚫 Custom Language Error:\n\n$errorMessage\n\n💡 Tip: You can switch to "Standard C++" mode from the Language Manager if you want to write regular C++ code.',
+            error: _customLanguageError(e),
             isServerConnected: state.isServerConnected,
             serverUrl: state.serverUrl,
           ));
@@ -65,12 +78,34 @@ class CompilerBloc extends Bloc<CompilerEvent, CompilerState> {
         }
       }
       
-      final result = await _apiService.compileCode(
+      if (_liveMode && _liveService.isConnected) {
+        // The session already holds nearly all of this text
+        _runPending = true;
+        _liveService.sendCode(codeToCompile);
+        _liveService.run();
+        return;
+      }
+      
+      var result = await _apiService.compileCode(
         code: codeToCompile,
         filename: event.filename,
         showGeneratedCode: event.showGeneratedCode,
         verbose: event.verbose,
+        languageHash: languageHash,
       );
+      if (result.unknownLanguage && activeLanguage != null) {
+        // The server restarted since the upload; upload the language again
+        languageHash = await _apiService.registerLanguage(activeLanguage, force: true);
+        if (languageHash != null) {
+          result = await _apiService.compileCode(
+            code: codeToCompile,
+            filename: event.filename,
+            showGeneratedCode: event.showGeneratedCode,
+            verbose: event.verbose,
+            languageHash: languageHash,
+          );
+        }
+      }
       
       if (result.success) {
         emit(CompilationSuccess(
@@ -96,6 +131,160 @@ class CompilerBloc extends Bloc<CompilerEvent, CompilerState> {
     }
   }
 
+  /// The C++ to compile for editor text in the active custom language, if any
+  Future<String> _toCpp(String code) async {
+    // Check if there's an active custom language
+    await CustomLanguageService.instance.initialize();
+    final activeLanguage = CustomLanguageService.instance.activeLanguage;
+    if (activeLanguage == null) {
+      return code;
+    }
+    // Parse custom language code to C++
+    final parser = CustomLanguageParser(activeLanguage);
+    return parser.parseToCpp(code);
+  }
+  
+  String _customLanguageError(Object e) {
+    String errorMessage = e.toString();
+    
+    // Clean up the error message for better user experience
+    if (errorMessage.contains('CustomLanguageParserException:')) {
+      errorMessage = errorMessage.replaceFirst('CustomLanguageParserException: ', '');
+    }
+    if (errorMessage.contains('Failed to parse custom language:')) {
+      errorMessage = errorMessage.replaceFirst('Failed to parse custom language: ', '');
+    }
+    
+    return '🚫 Custom Language Error:\n\n$errorMessage\n\n💡 Tip: You can switch to "Standard C++" mode from the Language Manager if you want to write regular C++ code.';
+  }
+
+  void _onToggleLiveMode(ToggleLiveMode event, Emitter<CompilerState> emit) async {
+    if (!event.enabled) {
+      _liveMode = false;
+      _runPending = false;
+      await _liveService.disconnect();
+      return;
+    }
+    try {
+      await _liveService.connect(_apiService.serverUrl, filename: event.filename);
+      _liveMode = true;
+      add(CodeEdited(event.code));
+    } catch (e) {
+      _liveMode = false;
+      emit(CompilationError(
+        error: 'Live mode is not available on this server (${e.toString()}).\n\n'
+            'Use the run button to compile instead.',
+        activeTab: state.activeTab,
+        isServerConnected: state.isServerConnected,
+        serverUrl: state.serverUrl,
+      ));
+    }
+  }
+
+  void _onCodeEdited(CodeEdited event, Emitter<CompilerState> emit) async {
+    if (!_liveMode) {
+      _idleTimer?.cancel();
+      _idleTimer = Timer(_idleDelay, () => _precompile(event.code));
+      return;
+    }
+    try {
+      _liveService.sendCode(await _toCpp(event.code));
+    } catch (e) {
+      // Half-typed custom language code; report it without leaving the editor
+      emit(CompilationError(
+        error: _customLanguageError(e),
+        activeTab: state.activeTab,
+        isServerConnected: state.isServerConnected,
+        serverUrl: state.serverUrl,
+      ));
+    }
+  }
+
+  /// Submit the code for pre-compilation so a following Run is answered at once
+  Future<void> _precompile(String code) async {
+    if (_liveMode || !state.isServerConnected || state is Compiling || code.trim().isEmpty) return;
+    final settings = await LocalStorageService.instance.loadCompilerSettings();
+    if (!settings.precompileWhileIdle) return;
+    if (!settings.precompileOnMobileData && await NetworkConfig.isOnMobileData()) return;
+    
+    await CustomLanguageService.instance.initialize();
+    final activeLanguage = CustomLanguageService.instance.activeLanguage;
+    String? languageHash;
+    if (activeLanguage != null) {
+      languageHash = await _apiService.registerLanguage(activeLanguage);
+    }
+    String codeToCompile = code;
+    if (languageHash == null) {
+      try {
+        codeToCompile = await _toCpp(code);
+      } catch (e) {
+        // Half-typed custom language code; Run reports it
+        return;
+      }
+    }
+    // Same options as the run button, so its request matches this one
+    _apiService.precompile(code: codeToCompile, languageHash: languageHash);
+  }
+
+  void _onLiveUpdateReceived(LiveUpdateReceived event, Emitter<CompilerState> emit) {
+    final update = event.update;
+    final result = update.result;
+    if (update.type == 'closed') {
+      _liveMode = false;
+      _runPending = false;
+      emit(CompilationError(
+        error: 'Live session closed by the server',
+        activeTab: state.activeTab,
+        isServerConnected: state.isServerConnected,
+        serverUrl: state.serverUrl,
+      ));
+    } else if (result == null) {
+      emit(CompilationError(
+        error: update.error ?? 'Live session error',
+        activeTab: state.activeTab,
+        isServerConnected: state.isServerConnected,
+        serverUrl: state.serverUrl,
+      ));
+    } else if (update.type == 'result' || (_runPending && !result.success)) {
+      // What the user asked to run: show it on the output tab
+      _runPending = false;
+      if (result.success) {
+        emit(CompilationSuccess(
+          output: result.formattedOutput,
+          result: result,
+          isServerConnected: state.isServerConnected,
+          serverUrl: state.serverUrl,
+        ));
+      } else {
+        emit(CompilationError(
+          error: result.formattedOutput,
+          result: result,
+          isServerConnected: state.isServerConnected,
+          serverUrl: state.serverUrl,
+        ));
+      }
+    } else if (!_runPending) {
+      // Diagnostics while typing stay on the current tab
+      if (result.success) {
+        emit(CompilationSuccess(
+          output: result.formattedOutput,
+          result: result,
+          activeTab: state.activeTab,
+          isServerConnected: state.isServerConnected,
+          serverUrl: state.serverUrl,
+        ));
+      } else {
+        emit(CompilationError(
+          error: result.formattedOutput,
+          result: result,
+          activeTab: state.activeTab,
+          isServerConnected: state.isServerConnected,
+          serverUrl: state.serverUrl,
+        ));
+      }
+    }
+  }
+
   void _onTestConnection(TestConnection event, Emitter<CompilerState> emit) async {
     emit(ServerConnecting(
       serverUrl: state.serverUrl,
@@ -219,6 +408,9 @@ class CompilerBloc extends Bloc<CompilerEvent, CompilerState> {
   
   @override
   Future<void> close() {
+    _idleTimer?.cancel();
+    _liveSubscription?.cancel();
+    _liveService.dispose();
     _apiService.dispose();
     return super.close();
   }
@@ -56,4 +56,22 @@ class ClearCode extends CompilerEvent {}
 class ChangeTab extends CompilerEvent {
   final int tabIndex;
   ChangeTab(this.tabIndex);
-}
\ No newline at end of file
+}
+
+class ToggleLiveMode extends CompilerEvent {
+  final bool enabled;
+  final String code;
+  final String? filename;
+  
+  ToggleLiveMode(this.enabled, this.code, {this.filename});
+}
+
+class CodeEdited extends CompilerEvent {
+  final String code;
+  CodeEdited(this.code);
+}
+
+class LiveUpdateReceived extends CompilerEvent {
+  final LiveUpdate update;
+  LiveUpdateReceived(this.update);
+}
@@ -29,6 +29,7 @@ class _CompilerScreenState extends State<CompilerScreen> with SingleTickerProvid
   
   String? _currentFilename;
   bool _hasUnsavedChanges = false;
+  bool _liveMode = false;
   int _originalCodeHash = 0;
 
   @override
@@ -51,6 +52,19 @@ class _CompilerScreenState extends State<CompilerScreen> with SingleTickerProvid
     setState(() {
       _hasUnsavedChanges = currentHash != _originalCodeHash;
     });
+    // Streamed to the live session, or pre-compiled once typing pauses
+    context.read<CompilerBloc>().add(CodeEdited(_codeController.text));
+  }
+  
+  void _toggleLiveMode(BuildContext context) {
+    setState(() {
+      _liveMode = !_liveMode;
+    });
+    context.read<CompilerBloc>().add(ToggleLiveMode(
+      _liveMode,
+      _codeController.text,
+      filename: 'mobile_input.cpp',
+    ));
   }
   
   Future<void> _loadEditorSettings() async {
@@ -86,6 +100,13 @@ class _CompilerScreenState extends State<CompilerScreen> with SingleTickerProvid
           _tabController.animateTo(state.activeTab);
         }
         
+        // The bloc leaves live mode when the server can't offer it
+        if (_liveMode && !context.read<CompilerBloc>().isLiveMode && state is CompilationError) {
+          setState(() {
+            _liveMode = false;
+          });
+        }
+        
         // Initialize code editor when app starts
         if (state is CompilerInitial && _codeController.text.isEmpty) {
           _codeController.text = state.initialCode;
@@ -208,6 +229,11 @@ class _CompilerScreenState extends State<CompilerScreen> with SingleTickerProvid
         );
           },
         ),
+        IconButton(
+          icon: Icon(_liveMode ? Icons.bolt : Icons.bolt_outlined, color: AppColors.primary),
+          onPressed: () => _toggleLiveMode(context),
+          tooltip: _liveMode ? 'Live Compile: On' : 'Live Compile: Off',
+        ),
         IconButton(
           icon: const Icon(Icons.folder_open, color: AppColors.primary),
           onPressed: () => _showLoadDialog(context),
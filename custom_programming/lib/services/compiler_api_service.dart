@@ -2,6 +2,7 @@
 import 'dart:convert';
 import 'dart:io';
 import 'package:http/http.dart' as http;
+import '../models/custom_language.dart';
 
 class CompilerApiService {
   static const String defaultHost = '192.168.100.13'; // Change this to your server IP
@@ -9,6 +10,15 @@ class CompilerApiService {
   
   late String _baseUrl;
   late http.Client _client;
+  // Language version (id@updatedAt) -> hash the server returned for it
+  final Map<String, String> _languageHashes = {};
+  // Set when the server has no /languages endpoint
+  bool _languagesUnsupported = false;
+  // Last program the server stored (X-Source-Hash); later runs send a diff against it
+  String? _baseCode;
+  String? _baseHash;
+  // Pre-compile submitted while the user was idle, for the next run of the same code
+  _Speculation? _speculation;
   
   CompilerApiService({String? host, int? port}) {
     final serverHost = host ?? defaultHost;
@@ -55,38 +65,20 @@ class CompilerApiService {
     String? filename,
     bool showGeneratedCode = false,
     bool verbose = false,
+    String? languageHash,
   }) async {
+    final requestBody = _requestBody(filename, showGeneratedCode, verbose, languageHash);
+    final speculation = _speculation;
+    if (speculation != null && speculation.matches(code, requestBody)) {
+      // Pre-compiled while the user was idle, or still being pre-compiled
+      final result = await speculation.result;
+      if (result != null) return result;
+    }
     try {
-      final requestBody = {
-        'code': code,
-        'filename': filename ?? 'mobile_input.cpp',
-        'show_generated_code': showGeneratedCode,
-        'verbose': verbose,
-      };
-      
-      final response = await _client
-          .post(
-            Uri.parse('$_baseUrl/compile'),
-            headers: {
-              'Content-Type': 'application/json',
-              'Accept': 'application/json',
-            },
-            body: json.encode(requestBody),
-          )
-          .timeout(const Duration(seconds: 30));
-      
+      final response = await _submit(code, requestBody);
       final data = json.decode(response.body);
       
-      return CompilationResult(
-        success: data['success'] ?? false,
-        output: data['execution_output'] ?? '',
-        error: data['error'],
-        details: List<String>.from(data['details'] ?? []),
-        compilationOutput: data['output'] ?? '',
-        generatedCode: data['generated_code'],
-        serverInfo: data['server_info'],
-        compilationPhases: List<String>.from(data['compilation_phases'] ?? []),
-      );
+      return CompilationResult.fromJson(data);
     } catch (e) {
       return CompilationResult(
         success: false,
@@ -97,6 +89,125 @@ class CompilerApiService {
     }
   }
   
+  /// Pre-compile [code] on an idle server worker while the user pauses typing
+  ///
+  /// A later [compileCode] with the same arguments returns this result without
+  /// another request, waiting for it if it is still in flight. The server skips
+  /// the pre-compile when no worker is idle, and the run then compiles as usual.
+  void precompile({
+    required String code,
+    String? filename,
+    bool showGeneratedCode = false,
+    bool verbose = false,
+    String? languageHash,
+  }) {
+    final requestBody = _requestBody(filename, showGeneratedCode, verbose, languageHash);
+    if (_speculation?.matches(code, requestBody) ?? false) return;
+    _speculation = _Speculation(code, requestBody, _precompile(code, requestBody));
+  }
+  
+  Future<CompilationResult?> _precompile(String code, Map<String, dynamic> requestBody) async {
+    try {
+      final response = await _submit(code, {...requestBody, 'speculative': true});
+      final state = response.headers['x-speculative'];
+      if (state != 'compiled' && state != 'cached') return null;
+      return CompilationResult.fromJson(json.decode(response.body));
+    } catch (e) {
+      return null;
+    }
+  }
+  
+  Map<String, dynamic> _requestBody(String? filename, bool showGeneratedCode, bool verbose, String? languageHash) {
+    return <String, dynamic>{
+      'filename': filename ?? 'mobile_input.cpp',
+      'show_generated_code': showGeneratedCode,
+      'verbose': verbose,
+      if (languageHash != null) 'language_hash': languageHash,
+    };
+  }
+  
+  /// POST [code] to /compile, as changed lines when the server has our previous program
+  Future<http.Response> _submit(String code, Map<String, dynamic> requestBody) async {
+    final changes = _baseHash != null ? _lineChanges(_baseCode!, code) : null;
+    var response = await _postCompile(changes != null
+        ? {...requestBody, 'base_hash': _baseHash, 'changes': changes}
+        : {...requestBody, 'code': code});
+    if (changes != null && response.statusCode == 409) {
+      // The server no longer has the base; upload the whole program
+      response = await _postCompile({...requestBody, 'code': code});
+    }
+    
+    final sourceHash = response.headers['x-source-hash'];
+    _baseCode = sourceHash != null ? code : null;
+    _baseHash = sourceHash;
+    return response;
+  }
+  
+  Future<http.Response> _postCompile(Map<String, dynamic> requestBody) {
+    return _client
+        .post(
+          Uri.parse('$_baseUrl/compile'),
+          headers: {
+            'Content-Type': 'application/json',
+            'Accept': 'application/json',
+          },
+          body: json.encode(requestBody),
+        )
+        .timeout(const Duration(seconds: 30));
+  }
+  
+  /// The lines of [code] that differ from [base], as one line-range
+  /// replacement; null when sending the whole program is no larger
+  List<Map<String, dynamic>>? _lineChanges(String base, String code) {
+    final oldLines = base.split('\n');
+    final newLines = code.split('\n');
+    var start = 0;
+    while (start < oldLines.length && start < newLines.length &&
+        oldLines[start] == newLines[start]) {
+      start++;
+    }
+    var oldEnd = oldLines.length;
+    var newEnd = newLines.length;
+    while (oldEnd > start && newEnd > start && oldLines[oldEnd - 1] == newLines[newEnd - 1]) {
+      oldEnd--;
+      newEnd--;
+    }
+    final changes = [
+      {'start': start, 'end': oldEnd, 'lines': newLines.sublist(start, newEnd)},
+    ];
+    return json.encode(changes).length < json.encode(code).length ? changes : null;
+  }
+  
+  /// Upload a custom language definition once; returns the hash /compile
+  /// takes in its place, or null if the server can't translate custom languages
+  Future<String?> registerLanguage(CustomLanguage language, {bool force = false}) async {
+    final version = '${language.id}@${language.updatedAt.toIso8601String()}';
+    if (!force) {
+      final known = _languageHashes[version];
+      if (known != null || _languagesUnsupported) return known;
+    }
+    try {
+      final response = await _client
+          .post(
+            Uri.parse('$_baseUrl/languages'),
+            headers: {'Content-Type': 'application/json'},
+            body: json.encode(language.toJson()),
+          )
+          .timeout(const Duration(seconds: 10));
+      if (response.statusCode == 404 || response.statusCode == 405) {
+        _languagesUnsupported = true;
+        return null;
+      }
+      final data = json.decode(response.body);
+      if (response.statusCode != 200 || data['language_hash'] == null) {
+        return null;
+      }
+      return _languageHashes[version] = data['language_hash'];
+    } catch (e) {
+      return null;
+    }
+  }
+  
   /// Get example programs from the server
   Future<ExamplesResult> getExamples() async {
     try {
@@ -174,6 +285,11 @@ class CompilerApiService {
   /// Update server URL (for connecting to different servers)
   void updateServerUrl({required String host, required int port}) {
     _baseUrl = 'http://$host:$port';
+    _languageHashes.clear();
+    _languagesUnsupported = false;
+    _baseCode = null;
+    _baseHash = null;
+    _speculation = null;
   }
   
   /// Get current server URL
@@ -201,6 +317,21 @@ class ServerConnectionResult {
   });
 }
 
+class _Speculation {
+  final String code;
+  final Map<String, dynamic> requestBody;
+  // Null when the server skipped the pre-compile or the request failed
+  final Future<CompilationResult?> result;
+  
+  _Speculation(this.code, this.requestBody, this.result);
+  
+  bool matches(String code, Map<String, dynamic> requestBody) {
+    return code == this.code &&
+        requestBody.length == this.requestBody.length &&
+        requestBody.entries.every((entry) => this.requestBody[entry.key] == entry.value);
+  }
+}
+
 class CompilationResult {
   final bool success;
   final String output;
@@ -210,6 +341,8 @@ class CompilationResult {
   final String? generatedCode;
   final Map<String, dynamic>? serverInfo;
   final List<String> compilationPhases;
+  // The server did not know the request's language_hash
+  final bool unknownLanguage;
   
   const CompilationResult({
     required this.success,
@@ -220,8 +353,24 @@ class CompilationResult {
     this.generatedCode,
     this.serverInfo,
     this.compilationPhases = const [],
+    this.unknownLanguage = false,
   });
   
+  /// Result from a /compile response or a live-compile message
+  factory CompilationResult.fromJson(Map<String, dynamic> data) {
+    return CompilationResult(
+      success: data['success'] ?? false,
+      output: data['execution_output'] ?? '',
+      error: data['error'],
+      details: List<String>.from(data['details'] ?? []),
+      compilationOutput: data['output'] ?? '',
+      generatedCode: data['generated_code'],
+      serverInfo: data['server_info'],
+      compilationPhases: List<String>.from(data['compilation_phases'] ?? []),
+      unknownLanguage: data['unknown_language'] ?? false,
+    );
+  }
+  
   /// Get formatted output for display
   String get formattedOutput {
     final buffer = StringBuffer();
@@ -301,6 +450,24 @@ class ServerInfoResult {
 
 // Network configuration helper
 class NetworkConfig {
+  /// Whether the device is online only through mobile data
+  ///
+  /// Judged from interface names, since the app has no connectivity plugin:
+  /// rmnet/ccmni (Android) and pdp_ip (iOS) are cellular, wlan/en/eth are
+  /// Wi-Fi or wired. Unknown setups count as not mobile.
+  static Future<bool> isOnMobileData() async {
+    try {
+      final names = (await NetworkInterface.list()).map((interface) => interface.name).toList();
+      final cellular = names.any((name) =>
+          name.contains('rmnet') || name.startsWith('ccmni') || name.startsWith('pdp_ip'));
+      final local = names.any((name) =>
+          name.startsWith('wlan') || name.startsWith('en') || name.startsWith('eth'));
+      return cellular && !local;
+    } catch (e) {
+      return false;
+    }
+  }
+  
   static Future<List<String>> discoverLocalIPs() async {
     final List<String> ips = [];
     
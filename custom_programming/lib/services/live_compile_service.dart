@@ -0,0 +1,138 @@
+// lib/services/live_compile_service.dart
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+import 'compiler_api_service.dart';
+
+/// Live-compile session on the server's /live WebSocket
+///
+/// Each edit is sent as the single range that changed since the last text
+/// the server acknowledged, and the server pushes diagnostics once typing
+/// pauses. Only the asyncio server offers /live; [connect] throws against
+/// servers without it.
+class LiveCompileService {
+  WebSocket? _socket;
+  String _sentCode = '';
+  int _version = 0;
+  final StreamController<LiveUpdate> _updates = StreamController<LiveUpdate>.broadcast();
+
+  /// Diagnostics, run results and errors pushed by the server
+  Stream<LiveUpdate> get updates => _updates.stream;
+
+  bool get isConnected => _socket != null;
+
+  /// Open a session on the server at [serverUrl] (http://host:port)
+  Future<void> connect(String serverUrl, {String? filename, bool autoRun = false}) async {
+    await disconnect();
+    final socket = await WebSocket.connect('${serverUrl.replaceFirst('http', 'ws')}/live')
+        .timeout(const Duration(seconds: 5));
+    _socket = socket;
+    _sentCode = '';
+    _version = 0;
+    socket.listen(
+      (data) => _onMessage(data as String),
+      onDone: () {
+        if (identical(_socket, socket)) {
+          _socket = null;
+          _updates.add(const LiveUpdate(type: 'closed'));
+        }
+      },
+      onError: (Object e) => _updates.add(LiveUpdate(type: 'error', error: e.toString())),
+    );
+    _send({
+      'type': 'open',
+      'filename': filename ?? 'mobile_input.cpp',
+      'auto_run': autoRun,
+    });
+  }
+
+  /// Send the editor's current text, as a range edit when possible
+  void sendCode(String code) {
+    if (_socket == null || code == _sentCode) return;
+    final base = _version;
+    _version++;
+    // The server indexes text by code point, Dart by UTF-16 unit; they
+    // only agree when neither text has surrogate pairs
+    final simple = _sentCode.runes.length == _sentCode.length && code.runes.length == code.length;
+    if (base == 0 || !simple) {
+      _send({'type': 'edit', 'version': _version, 'code': code});
+    } else {
+      var start = 0;
+      final shorter = code.length < _sentCode.length ? code.length : _sentCode.length;
+      while (start < shorter && code.codeUnitAt(start) == _sentCode.codeUnitAt(start)) {
+        start++;
+      }
+      var oldEnd = _sentCode.length;
+      var newEnd = code.length;
+      while (oldEnd > start && newEnd > start &&
+          _sentCode.codeUnitAt(oldEnd - 1) == code.codeUnitAt(newEnd - 1)) {
+        oldEnd--;
+        newEnd--;
+      }
+      _send({
+        'type': 'edit',
+        'version': _version,
+        'base': base,
+        'changes': [
+          {'start': start, 'end': oldEnd, 'text': code.substring(start, newEnd)},
+        ],
+      });
+    }
+    _sentCode = code;
+  }
+
+  /// Build and run the latest text; the result arrives as a 'result' update
+  void run() {
+    _send({'type': 'run', 'version': _version});
+  }
+
+  Future<void> disconnect() async {
+    final socket = _socket;
+    _socket = null;
+    await socket?.close();
+  }
+
+  void dispose() {
+    disconnect();
+    _updates.close();
+  }
+
+  void _send(Map<String, dynamic> message) {
+    _socket?.add(json.encode(message));
+  }
+
+  void _onMessage(String data) {
+    final message = json.decode(data) as Map<String, dynamic>;
+    switch (message['type']) {
+      case 'resync':
+        // The server lost track of our text; send all of it
+        _version++;
+        _send({'type': 'edit', 'version': _version, 'code': _sentCode});
+        break;
+      case 'diagnostics':
+      case 'result':
+        _updates.add(LiveUpdate(
+          type: message['type'],
+          version: message['version'] ?? 0,
+          result: CompilationResult.fromJson(message),
+        ));
+        break;
+      default:
+        _updates.add(LiveUpdate(type: 'error', error: message['error']?.toString()));
+    }
+  }
+}
+
+class LiveUpdate {
+  final String type; // 'diagnostics', 'result', 'error' or 'closed'
+  final int version;
+  final CompilationResult? result;
+  final String? error;
+
+  const LiveUpdate({
+    required this.type,
+    this.version = 0,
+    this.result,
+    this.error,
+  });
+}
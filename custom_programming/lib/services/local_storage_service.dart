@@ -400,11 +400,20 @@ class CompilerSettings extends HiveObject {
   @HiveField(3)
   final int compilerTimeout;
   
+  // Compile the code in the background when typing pauses, so Run is instant
+  @HiveField(4)
+  final bool precompileWhileIdle;
+  
+  @HiveField(5)
+  final bool precompileOnMobileData;
+  
   CompilerSettings({
     required this.showGeneratedCode,
     required this.verboseOutput,
     required this.autoCompile,
     required this.compilerTimeout,
+    this.precompileWhileIdle = true,
+    this.precompileOnMobileData = false,
   });
   
   factory CompilerSettings.defaultSettings() => CompilerSettings(
@@ -412,6 +421,8 @@ class CompilerSettings extends HiveObject {
     verboseOutput: false,
     autoCompile: false,
     compilerTimeout: 30,
+    precompileWhileIdle: true,
+    precompileOnMobileData: false,
   );
 }
 
@@ -584,13 +595,16 @@ class CompilerSettingsAdapter extends TypeAdapter<CompilerSettings> {
       verboseOutput: fields[1] as bool,
       autoCompile: fields[2] as bool,
       compilerTimeout: fields[3] as int,
+      // Absent in settings saved by older versions
+      precompileWhileIdle: fields[4] as bool? ?? true,
+      precompileOnMobileData: fields[5] as bool? ?? false,
     );
   }
 
   @override
   void write(BinaryWriter writer, CompilerSettings obj) {
     writer
-      ..writeByte(4)
+      ..writeByte(6)
       ..writeByte(0)
       ..write(obj.showGeneratedCode)
       ..writeByte(1)
@@ -598,7 +612,11 @@ class CompilerSettingsAdapter extends TypeAdapter<CompilerSettings> {
       ..writeByte(2)
       ..write(obj.autoCompile)
       ..writeByte(3)
-      ..write(obj.compilerTimeout);
+      ..write(obj.compilerTimeout)
+      ..writeByte(4)
+      ..write(obj.precompileWhileIdle)
+      ..writeByte(5)
+      ..write(obj.precompileOnMobileData);
   }
 
   @override
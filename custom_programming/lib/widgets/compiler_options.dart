@@ -19,6 +19,8 @@ class _CompilerOptionsWidgetState extends State<CompilerOptionsWidget> {
   bool _verboseOutput = false;
   bool _autoCompile = false;
   int _compilerTimeout = 30;
+  bool _precompileWhileIdle = true;
+  bool _precompileOnMobileData = false;
   
   // Editor Settings
   double _fontSize = 14.0;
@@ -58,6 +60,8 @@ class _CompilerOptionsWidgetState extends State<CompilerOptionsWidget> {
         _verboseOutput = compilerSettings.verboseOutput;
         _autoCompile = compilerSettings.autoCompile;
         _compilerTimeout = compilerSettings.compilerTimeout;
+        _precompileWhileIdle = compilerSettings.precompileWhileIdle;
+        _precompileOnMobileData = compilerSettings.precompileOnMobileData;
         
         // Editor settings
         _fontSize = editorSettings.fontSize;
@@ -87,6 +91,8 @@ class _CompilerOptionsWidgetState extends State<CompilerOptionsWidget> {
       verboseOutput: _verboseOutput,
       autoCompile: _autoCompile,
       compilerTimeout: _compilerTimeout,
+      precompileWhileIdle: _precompileWhileIdle,
+      precompileOnMobileData: _precompileOnMobileData,
     );
     await LocalStorageService.instance.saveCompilerSettings(settings);
   }
@@ -286,6 +292,14 @@ class _CompilerOptionsWidgetState extends State<CompilerOptionsWidget> {
             setState(() => _autoCompile = value);
             await _saveCompilerSettings();
           }),
+          _buildSwitchOption('Pre-compile While Idle', _precompileWhileIdle, (value) async {
+            setState(() => _precompileWhileIdle = value);
+            await _saveCompilerSettings();
+          }),
+          _buildSwitchOption('Pre-compile on Mobile Data', _precompileOnMobileData, (value) async {
+            setState(() => _precompileOnMobileData = value);
+            await _saveCompilerSettings();
+          }),
           _buildSliderOption(
             'Compilation Timeout',
             _compilerTimeout.toDouble(),
@@ -0,0 +1,743 @@
+"""
+C++ Compiler Asyncio API Server
+An event-loop HTTP/1.1 server for the same endpoints as the Flask API. Connections
+are coroutines, so idle keep-alive clients cost no threads, and compilation and
+execution run in a pool of pre-started worker processes instead of contending
+for the GIL.
+
+With --processes N the server preforks N copies that all listen on the same
+port (SO_REUSEPORT) and compile in-process, sharing generated code and results
+through a SharedCache created before the fork.
+
+GET /live upgrades to a WebSocket live-compile session (see live_session.py).
+/compile with "speculative": true pre-compiles on idle workers (see speculation.py).
+/judge compiles a submission once and runs each of its tests as a job (see judge.py).
+
+Usage:
+    python async_server.py [--host HOST] [--port PORT] [--workers N]
+    python async_server.py --processes N [--workers M]
+"""
+
+import asyncio
+import json
+import os
+import platform
+import signal
+import socket
+import sys
+import time
+import traceback
+from concurrent.futures import ProcessPoolExecutor, ThreadPoolExecutor
+from http import HTTPStatus
+from typing import Optional, Tuple, Union
+
+from compilation_context import CompilationContext
+from custom_language import LanguageStore, register_response, translate_request
+from examples_store import ExampleStore
+from judge import JudgeLimits, compile_failure, judgement, parse_judge_request
+from live_session import LiveSession
+from rate_limit import (AdmissionLimits, RateLimiter, client_key, known_token, retry_after,
+                        too_large, too_many_requests)
+from readiness import ReadinessThresholds, RequestStats, check_readiness
+from scheduler import BATCH, INTERACTIVE, SPECULATIVE, FairScheduler, request_class
+from shared_cache import SharedCache
+from source_deltas import SOURCE_HASH_HEADER, SourceStore, resolve_source
+from speculation import (CACHED, COMPILED, SKIPPED, SPECULATIVE_HEADER, TIMED_OUT, ResultCache,
+                         is_speculative, result_key, run_speculatively, skipped_response,
+                         timed_out_response)
+import warm_up
+from websocket_protocol import WebSocket, handshake_response, is_upgrade
+
+SERVER_NAME = "C++ Compiler Async API Server"
+VERSION = "2.0.0"
+
+# Keep-alive connections idle for longer than this are closed
+IDLE_TIMEOUT = 75.0
+MAX_HEADER_BYTES = 64 * 1024
+
+CORS_HEADERS = {
+    'Access-Control-Allow-Origin': '*',
+    'Access-Control-Allow-Headers': 'Content-Type,Authorization',
+    'Access-Control-Allow-Methods': 'GET,POST,OPTIONS',
+    'Access-Control-Expose-Headers': f'{SOURCE_HASH_HEADER},{SPECULATIVE_HEADER}',
+}
+
+# Whether this process has imported and exercised the compiler
+worker_warm = False
+# Cache shared by all processes; set before forking so children inherit it
+shared_cache: Optional[SharedCache] = None
+
+def warm_worker():
+    """Pool initializer: import the compiler and run the example corpus through it"""
+    global worker_warm
+    if worker_warm:
+        return  # inherited warm from the parent
+    warm_up.warm_up(compile_function=compile_job)
+    worker_warm = True
+
+def code_key(source_code: str, context: CompilationContext) -> bytes:
+    """SharedCache key of a program's generated code
+
+    The code depends on the options that change translation, such as
+    fast_analysis, and on the filename, which appears in its header; the
+    display-only options are left out so they share one entry.
+    """
+    options = context.with_options(verbose=False, show_tokens=False, show_ast=False,
+                                   show_generated_code=False)
+    return b'code:' + repr(options).encode('utf-8') + b'\0' + source_code.encode('utf-8')
+
+def compile_job(source_code: str, context: CompilationContext) -> dict:
+    """Compile and run one request in a worker process"""
+    from main import compile_source_api, translate_api, execute_api
+    if shared_cache is None or context.engine != 'exec':
+        # Closure-built programs have no generated code to share
+        return compile_source_api(source_code, context)
+
+    key = code_key(source_code, context)
+    cached = shared_cache.get(key)
+    if cached is not None:
+        generated_code, output = cached.decode('utf-8'), ""
+        if context.verbose:
+            output = "Phase 1-4: reused generated code\n"
+        return execute_api(generated_code, context, output)
+    generated_code, output, error = translate_api(source_code, context)
+    if error is not None:
+        return error
+    shared_cache.put(key, generated_code.encode('utf-8'))
+    return execute_api(generated_code, context, output)
+
+def compile_example(source_code: str, context: CompilationContext) -> dict:
+    """Compile an example program in this process, for the ExampleStore"""
+    from main import compile_source_api
+    return compile_source_api(source_code, context)
+
+def speculative_job(source_code: str, context: CompilationContext) -> Optional[dict]:
+    """compile_job for a speculative request: None when it runs past the speculation time limit"""
+    return run_speculatively(compile_job, source_code, context)
+
+def translate_job(source_code: str, context: CompilationContext) -> tuple:
+    """Compile a /judge submission in a worker process: translate_api's (generated code, log, error)"""
+    from main import translate_api
+    return translate_api(source_code, context)
+
+def judge_job(generated_code: str, filename: str, test, limits: JudgeLimits, comparison: str) -> dict:
+    """Run a compiled /judge submission on one test in a worker process"""
+    from main import judge_test
+    return judge_test(generated_code, filename, test, limits, comparison)
+
+def worker_ready() -> dict:
+    """Job used to start every pool process up front; returns its warm-up report"""
+    return dict(warm_up.last_report or {}, pid=os.getpid())
+
+class HttpError(Exception):
+    """A request that is answered with an error status and closes the connection"""
+    def __init__(self, status: int, message: str):
+        super().__init__(message)
+        self.status = status
+
+class AsyncCompilerServer:
+    """Asyncio API server that hands compilation to a process pool
+
+    With workers=0 compilation runs in a single thread of this process, which
+    is how each prefork worker runs.
+    """
+
+    def __init__(self, workers: Optional[int] = None, examples_dir: str = './examples',
+                 examples: Optional[ExampleStore] = None,
+                 thresholds: Optional[ReadinessThresholds] = None, scheduler_policy: str = 'drr',
+                 limits: Optional[AdmissionLimits] = None):
+        self.workers = (os.cpu_count() or 1) if workers is None else workers
+        self.examples = examples or ExampleStore(examples_dir, compile_example)
+        # workers=0 still compiles one request at a time
+        self.stats = RequestStats(max(1, self.workers))
+        # Shares the workers between interactive, examples and batch requests
+        self.scheduler = FairScheduler(max(1, self.workers), policy=scheduler_policy)
+        self.limits = limits or AdmissionLimits.from_environment()
+        self.rate_limiter = RateLimiter(self.limits.rate, self.limits.burst)
+        self.judge_limits = JudgeLimits.from_environment()
+        self.thresholds = thresholds or ReadinessThresholds.from_environment()
+        self.languages = LanguageStore()
+        # Programs clients submitted, the bases of their delta uploads
+        self.sources = SourceStore(shared=shared_cache)
+        # Results by program hash; /compile programs read an empty input, so a
+        # result depends only on the source and options
+        self.results = ResultCache(shared=shared_cache)
+        # Pre-compiles in progress by result key, so a Run can wait for one
+        self.speculating = {}
+        self.speculation = {COMPILED: 0, CACHED: 0, SKIPPED: 0, TIMED_OUT: 0}
+        self.pool: Optional[Union[ProcessPoolExecutor, ThreadPoolExecutor]] = None
+        self.server: Optional[asyncio.AbstractServer] = None
+        self.started = time.time()
+        self.warm_up_reports = []
+        self.open_connections = 0
+        self.requests_served = 0
+        self.live_sessions = set()
+        self.live_builds = 0
+        self.live_cancelled = 0
+
+        self.routes = {
+            ('GET', '/'): self.home,
+            ('GET', '/health'): self.health,
+            ('GET', '/ready'): self.ready,
+            ('POST', '/compile'): self.compile_code,
+            ('POST', '/judge'): self.judge_code,
+            ('POST', '/languages'): self.upload_language,
+            ('GET', '/examples'): self.get_examples,
+            ('GET', '/server-info'): self.server_info,
+        }
+
+    async def start(self, host: str = '0.0.0.0', port: int = 5000, reuse_port: bool = False):
+        """Start the worker pool and begin accepting connections"""
+        loop = asyncio.get_running_loop()
+        if self.workers > 0:
+            self.pool = ProcessPoolExecutor(max_workers=self.workers, initializer=warm_worker)
+            # Start and warm every worker before the first request arrives
+            self.warm_up_reports = await asyncio.gather(*(loop.run_in_executor(self.pool, worker_ready)
+                                                          for _ in range(self.workers)))
+        else:
+            self.pool = ThreadPoolExecutor(max_workers=1, initializer=warm_worker)
+            self.warm_up_reports = [await loop.run_in_executor(self.pool, worker_ready)]
+        # Load and precompile the examples before accepting connections
+        await loop.run_in_executor(None, self.examples.load)
+        self.examples.watch()
+        self.server = await asyncio.start_server(self.handle_connection, host, port, backlog=4096,
+                                                 limit=MAX_HEADER_BYTES, reuse_port=reuse_port)
+
+    async def close(self):
+        """Stop accepting connections and shut the worker pool down"""
+        if self.server is not None:
+            self.server.close()
+            await self.server.wait_closed()
+        if self.pool is not None:
+            self.pool.shutdown(cancel_futures=True)
+
+    async def serve_forever(self, host: str = '0.0.0.0', port: int = 5000, reuse_port: bool = False):
+        """Run until cancelled"""
+        await self.start(host, port, reuse_port)
+        slowest = max((report.get('seconds', 0) for report in self.warm_up_reports), default=0)
+        print(f"[{os.getpid()}] Ready on {host}:{port}; workers warmed up in {slowest * 1000:.0f} ms")
+        try:
+            await self.server.serve_forever()
+        finally:
+            await self.close()
+
+    async def handle_connection(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        """Serve requests on one connection until the client closes it or goes idle"""
+        self.open_connections += 1
+        peer = writer.get_extra_info('peername')
+        remote_addr = peer[0] if peer else None
+        try:
+            keep_alive = True
+            while keep_alive:
+                try:
+                    request = await asyncio.wait_for(self.read_request(reader), IDLE_TIMEOUT)
+                except (asyncio.TimeoutError, asyncio.IncompleteReadError, ConnectionError):
+                    break
+                except HttpError as e:
+                    await self.send(writer, e.status, {"success": False, "error": str(e)}, False)
+                    break
+                if request is None:
+                    break
+                method, path, headers, length, keep_alive = request
+                if method == 'GET' and path == '/live' and is_upgrade(headers):
+                    await self.live(reader, writer, headers, remote_addr)
+                    break
+                rejection = self.admit(method, path, headers, remote_addr)
+                if rejection is not None:
+                    status, payload, *extra_headers = rejection
+                    # The body is never read, so the connection can't carry another request
+                    keep_alive = keep_alive and length == 0
+                else:
+                    body = b''
+                    try:
+                        if length:
+                            body = await asyncio.wait_for(reader.readexactly(length), IDLE_TIMEOUT)
+                    except (asyncio.TimeoutError, asyncio.IncompleteReadError, ConnectionError):
+                        break
+                    status, payload, *extra_headers = await self.dispatch(method, path, headers, body)
+                await self.send(writer, status, payload, keep_alive, *extra_headers)
+                self.requests_served += 1
+        except ConnectionError:
+            pass
+        finally:
+            self.open_connections -= 1
+            writer.close()
+
+    async def read_request(self, reader: asyncio.StreamReader) -> Optional[tuple]:
+        """Read one request's head: (method, path, headers, body length, keep-alive)
+
+        The body is left unread so a request can be turned away first. None
+        when the client closed the connection cleanly.
+        """
+        try:
+            head = await reader.readuntil(b'\r\n\r\n')
+        except asyncio.IncompleteReadError as e:
+            if e.partial.strip():
+                raise HttpError(HTTPStatus.BAD_REQUEST, "Incomplete request")
+            return None
+        except asyncio.LimitOverrunError:
+            raise HttpError(HTTPStatus.REQUEST_HEADER_FIELDS_TOO_LARGE, "Request headers too large")
+
+        lines = head.decode('latin-1').split('\r\n')
+        try:
+            method, target, version = lines[0].split(' ')
+        except ValueError:
+            raise HttpError(HTTPStatus.BAD_REQUEST, "Malformed request line")
+        headers = {}
+        for line in lines[1:]:
+            if line:
+                name, _, value = line.partition(':')
+                headers[name.strip().lower()] = value.strip()
+
+        try:
+            length = int(headers.get('content-length', 0))
+        except ValueError:
+            raise HttpError(HTTPStatus.BAD_REQUEST, "Invalid Content-Length")
+        if length > self.limits.max_body_bytes:
+            # Refuse before reading; the connection is closed rather than drained
+            raise HttpError(HTTPStatus.REQUEST_ENTITY_TOO_LARGE,
+                            f"Request body too large (limit {self.limits.max_body_bytes} bytes)")
+        if length < 0:
+            raise HttpError(HTTPStatus.BAD_REQUEST, "Invalid Content-Length")
+
+        connection = headers.get('connection', '').lower()
+        keep_alive = connection != 'close' if version == 'HTTP/1.1' else connection == 'keep-alive'
+        return method.upper(), target.split('?', 1)[0], headers, length, keep_alive
+
+    async def live(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter, headers: dict,
+                   remote_addr: Optional[str]):
+        """Run a WebSocket live-compile session on this connection until either side closes it
+
+        Every message is admitted like a /compile request: it takes a token
+        from the client's rate-limit bucket, and its source is held to
+        max_code_bytes.
+        """
+        response = handshake_response(headers)
+        if response is None:
+            await self.send(writer, HTTPStatus.BAD_REQUEST,
+                            {"success": False, "error": "Invalid WebSocket handshake"}, False)
+            return
+        writer.write(response)
+        await writer.drain()
+        websocket = WebSocket(reader, writer, self.limits.max_body_bytes)
+        session = LiveSession(lambda function, *args: self.run_job(INTERACTIVE, function, *args),
+                              lambda message: websocket.send(json.dumps(message)),
+                              max_code_bytes=self.limits.max_code_bytes,
+                              time_limit_ms=self.judge_limits.time_limit_ms)
+        key = client_key(self.limits, remote_addr, headers.get('authorization'))
+        self.live_sessions.add(session)
+        try:
+            while True:
+                text = await websocket.receive()
+                if text is None:
+                    break
+                allowed, wait = self.rate_limiter.allow(key)
+                if not allowed:
+                    await session.send(dict(too_many_requests(wait), type="error",
+                                            retry_after=retry_after(wait)))
+                    continue
+                await session.handle(text)
+        finally:
+            session.close()
+            self.live_sessions.discard(session)
+            self.live_builds += session.builds
+            self.live_cancelled += session.cancelled
+
+    async def run_job(self, job_class: str, function, *args):
+        """Run function(*args) in the worker pool once the scheduler grants job_class a worker"""
+        waiting = self.stats.queued()
+        try:
+            ticket = await self.scheduler.acquire_async(job_class)
+        finally:
+            self.stats.dequeued(waiting)
+        return await self.start_job(ticket, self.stats.start(), function, *args)
+
+    async def start_job(self, ticket, token, function, *args):
+        """Run function(*args) in the worker pool on a granted scheduler ticket
+
+        A caller cancelled while the job runs stops waiting for it, but the
+        worker stays counted as busy until the job actually finishes.
+        """
+        loop = asyncio.get_running_loop()
+        try:
+            future = loop.run_in_executor(self.pool, function, *args)
+        except BaseException:
+            self.scheduler.release(ticket, False)
+            self.stats.finish(token, False)
+            raise
+
+        def finished(future: asyncio.Future):
+            success = not future.cancelled() and future.exception() is None
+            self.scheduler.release(ticket, success)
+            self.stats.finish(token, success)
+
+        future.add_done_callback(finished)
+        return await asyncio.shield(future)
+
+    def admit(self, method: str, path: str, headers: dict, remote_addr: Optional[str]) -> Optional[tuple]:
+        """A 429 response when the client is over its /compile and /judge rate, else None
+
+        Called with only the request's head read; the Content-Length cap has
+        been checked by then, so a turned-away body is never read.
+        """
+        if method != 'POST' or path not in ('/compile', '/judge') or not self.rate_limiter.enabled:
+            return None
+        allowed, wait = self.rate_limiter.allow(client_key(self.limits, remote_addr,
+                                                           headers.get('authorization')))
+        if allowed:
+            return None
+        return HTTPStatus.TOO_MANY_REQUESTS, too_many_requests(wait), {'Retry-After': retry_after(wait)}
+
+    async def dispatch(self, method: str, path: str, headers: dict, body: bytes) -> tuple:
+        """Route a request to its handler: (status, payload[, response headers])"""
+        if method == 'OPTIONS':
+            return HTTPStatus.OK, {}
+        handler = self.routes.get((method, path))
+        if handler is None:
+            if any(route_path == path for _, route_path in self.routes):
+                return HTTPStatus.METHOD_NOT_ALLOWED, {"success": False, "error": "Method not allowed"}
+            return HTTPStatus.NOT_FOUND, {"success": False, "error": f"Unknown endpoint {path}"}
+        try:
+            return await handler(body, headers)
+        except Exception as e:
+            return HTTPStatus.INTERNAL_SERVER_ERROR, {
+                "success": False,
+                "error": f"Server Error: {str(e)}",
+                "details": [traceback.format_exc()],
+                "output": "",
+                "execution_output": ""
+            }
+
+    async def send(self, writer: asyncio.StreamWriter, status: int, payload: Union[dict, bytes],
+                   keep_alive: bool, headers: Optional[dict] = None):
+        """Write a JSON response; bytes payloads are already encoded"""
+        body = payload if isinstance(payload, bytes) else json.dumps(payload).encode('utf-8')
+        status = HTTPStatus(status)
+        head = [f"HTTP/1.1 {status.value} {status.phrase}"]
+        if status != HTTPStatus.NOT_MODIFIED:
+            head.append("Content-Type: application/json")
+        head += [f"Content-Length: {len(body)}",
+                 f"Connection: {'keep-alive' if keep_alive else 'close'}"]
+        head.extend(f"{name}: {value}" for name, value in CORS_HEADERS.items())
+        if headers:
+            head.extend(f"{name}: {value}" for name, value in headers.items() if name != 'Content-Type')
+        writer.write(("\r\n".join(head) + "\r\n\r\n").encode('latin-1') + body)
+        await writer.drain()
+
+    async def home(self, body: bytes, headers: dict) -> Tuple[int, dict]:
+        """Root endpoint with API information"""
+        return HTTPStatus.OK, {
+            "message": SERVER_NAME,
+            "version": VERSION,
+            "status": "running",
+            "endpoints": {
+                "/": "GET - API information",
+                "/health": "GET - Health check",
+                "/ready": "GET - Readiness for load balancers (503 when overloaded)",
+                "/compile": "POST - Compile C++ code",
+                "/judge": "POST - Compile once and judge on many tests",
+                "/languages": "POST - Upload a custom language definition",
+                "/examples": "GET - Get example programs",
+                "/server-info": "GET - Server information",
+                "/live": "GET (WebSocket) - Live-compile session"
+            }
+        }
+
+    async def health(self, body: bytes, headers: dict) -> Tuple[int, dict]:
+        """Health check endpoint"""
+        return HTTPStatus.OK, {
+            "status": "healthy",
+            "message": "C++ Compiler API is running",
+            "timestamp": time.time(),
+            "server": "asyncio"
+        }
+
+    async def ready(self, body: bytes, headers: dict) -> Tuple[int, dict]:
+        """Readiness check: 503 when the queue, the workers or latency are over their thresholds"""
+        status, payload = check_readiness(self.stats, self.thresholds)
+        payload["pid"] = os.getpid()
+        payload["scheduler"] = self.scheduler.snapshot()
+        return HTTPStatus(status), payload
+
+    async def compile_code(self, body: bytes, headers: dict) -> tuple:
+        """Compile C++ code in a worker process"""
+        try:
+            data = json.loads(body) if body else None
+        except (json.JSONDecodeError, UnicodeDecodeError) as e:
+            return HTTPStatus.BAD_REQUEST, {
+                "success": False,
+                "error": f"Invalid JSON: {str(e)}",
+                "details": ["Request body must be valid JSON"],
+                "output": "",
+                "execution_output": ""
+            }
+        if not isinstance(data, dict) or not data:
+            return HTTPStatus.BAD_REQUEST, {
+                "success": False,
+                "error": "No JSON data provided",
+                "details": ["Request must contain JSON data"]
+            }
+
+        submitted, rejection = resolve_source(self.sources, data)
+        if rejection is not None:
+            return HTTPStatus(rejection[0]), rejection[1]
+        source_code = submitted.strip()
+        if not source_code:
+            return HTTPStatus.BAD_REQUEST, {
+                "success": False,
+                "error": "No source code provided",
+                "details": ["The 'code' field is required and cannot be empty"]
+            }
+        if len(source_code.encode('utf-8')) > self.limits.max_code_bytes:
+            return HTTPStatus.REQUEST_ENTITY_TOO_LARGE, too_large(self.limits.max_code_bytes, "Source code")
+        # The client's next request may send only its changes against this program
+        response_headers = {SOURCE_HASH_HEADER: self.sources.put(submitted)}
+        source_code, rejection = translate_request(self.languages, data, source_code)
+        if rejection is not None:
+            return HTTPStatus(rejection[0]), rejection[1], response_headers
+
+        context = CompilationContext.from_request(data)
+        speculative = is_speculative(data)
+        example_result = self.examples.cached_result(source_code, context)
+        if example_result is not None:
+            if speculative:
+                response_headers[SPECULATIVE_HEADER] = CACHED
+            status = HTTPStatus.OK if example_result['success'] else HTTPStatus.BAD_REQUEST
+            return status, example_result, response_headers
+
+        key = result_key(source_code, context)
+        stored = self.results.get(key)
+        if stored is None and key in self.speculating:
+            # Run tapped while this program is being pre-compiled
+            stored = await asyncio.shield(self.speculating[key])
+        if stored is not None:
+            if speculative:
+                self.speculation[CACHED] += 1
+                response_headers[SPECULATIVE_HEADER] = CACHED
+            return HTTPStatus(stored[0]), stored[1], response_headers
+
+        if not speculative:
+            api_client = known_token(self.limits, headers.get('authorization')) is not None
+            result = await self.run_job(request_class(data, headers, api_client=api_client),
+                                        compile_job, source_code, context)
+            status, body = self.store_result(key, result)
+            return HTTPStatus(status), body, response_headers
+
+        ticket = self.scheduler.try_acquire(SPECULATIVE)
+        if ticket is None:
+            self.speculation[SKIPPED] += 1
+            response_headers[SPECULATIVE_HEADER] = SKIPPED
+            return HTTPStatus.ACCEPTED, skipped_response(), response_headers
+        task = asyncio.ensure_future(self.speculate(ticket, key, source_code, context))
+        self.speculating[key] = task
+        task.add_done_callback(lambda _: self.speculating.pop(key, None))
+        stored = await asyncio.shield(task)
+        if stored is None:
+            self.speculation[TIMED_OUT] += 1
+            response_headers[SPECULATIVE_HEADER] = TIMED_OUT
+            return HTTPStatus.ACCEPTED, timed_out_response(), response_headers
+        self.speculation[COMPILED] += 1
+        response_headers[SPECULATIVE_HEADER] = COMPILED
+        return HTTPStatus(stored[0]), stored[1], response_headers
+
+    async def speculate(self, ticket, key: bytes, source_code: str, context: CompilationContext) -> Optional[tuple]:
+        """Pre-compile on the idle worker ticket holds; (status, body) of the stored result
+
+        None when the program ran past the speculation time limit; that
+        result is not stored.
+        """
+        result = await self.start_job(ticket, self.stats.start(), speculative_job, source_code, context)
+        if result is None:
+            return None
+        return self.store_result(key, result)
+
+    def store_result(self, key: bytes, result: dict) -> Tuple[int, bytes]:
+        """Encode a compile result and keep it for later requests with the same program"""
+        status = HTTPStatus.OK if result['success'] else HTTPStatus.BAD_REQUEST
+        body = json.dumps(result).encode('utf-8')
+        self.results.put(key, status, body)
+        return status, body
+
+    async def judge_code(self, body: bytes, headers: dict) -> Tuple[int, dict]:
+        """Compile a submission once in a worker, then run its tests across all the workers"""
+        try:
+            data = json.loads(body) if body else None
+        except (json.JSONDecodeError, UnicodeDecodeError) as e:
+            return HTTPStatus.BAD_REQUEST, {"success": False, "error": f"Invalid JSON: {str(e)}"}
+        if not isinstance(data, dict) or not data:
+            return HTTPStatus.BAD_REQUEST, {
+                "success": False,
+                "error": "No JSON data provided",
+                "details": ["Request must contain JSON data"]
+            }
+        source_code = str(data.get('code') or '').strip()
+        if not source_code:
+            return HTTPStatus.BAD_REQUEST, {
+                "success": False,
+                "error": "No source code provided",
+                "details": ["The 'code' field is required and cannot be empty"]
+            }
+        if len(source_code.encode('utf-8')) > self.limits.max_code_bytes:
+            return HTTPStatus.REQUEST_ENTITY_TOO_LARGE, too_large(self.limits.max_code_bytes, "Source code")
+        tests, comparison, limits, rejection = parse_judge_request(data, self.judge_limits)
+        if rejection is not None:
+            return HTTPStatus(rejection[0]), rejection[1]
+
+        context = CompilationContext.from_request(data)
+        # Grading is always batch work
+        job_class = request_class(data, headers, BATCH)
+        start = time.perf_counter()
+        generated_code, _, error = await self.run_job(job_class, translate_job, source_code, context)
+        if error is not None:
+            return HTTPStatus.BAD_REQUEST, compile_failure(error, len(tests))
+        compiled = time.perf_counter()
+        # Each test is its own job, so the scheduler shares the workers between
+        # this submission's tests and other requests
+        results = await asyncio.gather(*(self.run_job(job_class, judge_job, generated_code, context.filename,
+                                                      test, limits, comparison) for test in tests))
+        return HTTPStatus.OK, judgement(list(results), (compiled - start) * 1000,
+                                        (time.perf_counter() - start) * 1000)
+
+    async def upload_language(self, body: bytes, headers: dict) -> Tuple[int, dict]:
+        """Store a custom language definition; /compile then takes its language_hash"""
+        try:
+            data = json.loads(body) if body else None
+        except (json.JSONDecodeError, UnicodeDecodeError) as e:
+            return HTTPStatus.BAD_REQUEST, {"success": False, "error": f"Invalid JSON: {str(e)}"}
+        status, payload = register_response(self.languages, data)
+        return HTTPStatus(status), payload
+
+    async def get_examples(self, body: bytes, headers: dict) -> tuple:
+        """Get example C++ programs, with ETag revalidation and gzip"""
+        status, payload, response_headers = self.examples.response(headers.get('if-none-match'),
+                                                                   headers.get('accept-encoding'))
+        return status, payload, response_headers
+
+    async def server_info(self, body: bytes, headers: dict) -> Tuple[int, dict]:
+        """Get detailed server information"""
+        return HTTPStatus.OK, {
+            "server": {
+                "name": SERVER_NAME,
+                "version": VERSION,
+                "status": "running",
+                "python_version": platform.python_version(),
+                "platform": platform.platform(),
+                "hostname": socket.gethostname(),
+                "uptime": time.time() - self.started
+            },
+            "pid": os.getpid(),
+            "workers": self.workers,
+            "warm_up": self.warm_up_reports,
+            "cache": shared_cache.stats() if shared_cache is not None else None,
+            "open_connections": self.open_connections,
+            "requests_served": self.requests_served,
+            "load": self.stats.snapshot(),
+            "scheduler": self.scheduler.snapshot(),
+            "rate_limit": self.rate_limiter.stats(),
+            "languages": self.languages.stats(),
+            "sources": self.sources.stats(),
+            "results": self.results.stats(),
+            "speculation": dict(self.speculation, in_progress=len(self.speculating)),
+            "live": {"sessions": len(self.live_sessions),
+                     "builds": self.live_builds + sum(session.builds for session in self.live_sessions),
+                     "cancelled": self.live_cancelled + sum(session.cancelled for session in self.live_sessions)},
+            "examples": {"count": len(self.examples.ensure_loaded().examples),
+                         "etag": self.examples.snapshot.etag, "reloads": self.examples.reloads},
+            "endpoints": len(self.routes),
+            "cors_enabled": True
+        }
+
+def start_async_server(host: str = '0.0.0.0', port: int = 5000, workers: Optional[int] = None,
+                       scheduler_policy: str = 'drr'):
+    """Run the asyncio API server until interrupted"""
+    server = AsyncCompilerServer(workers, scheduler_policy=scheduler_policy)
+    print(f"Starting {SERVER_NAME} on {host}:{port} with {server.workers} worker processes")
+    print("Press Ctrl+C to stop the server")
+    # Exit through the normal shutdown path so pool processes don't outlive the server
+    signal.signal(signal.SIGTERM, lambda signum, frame: sys.exit(0))
+    try:
+        asyncio.run(server.serve_forever(host, port))
+    except KeyboardInterrupt:
+        print("\nServer stopped by user")
+
+def run_prefork_worker(server: AsyncCompilerServer, host: str, port: int):
+    """Body of one forked worker process"""
+    signal.signal(signal.SIGINT, signal.SIG_IGN)
+    signal.signal(signal.SIGTERM, signal.SIG_DFL)
+    try:
+        asyncio.run(server.serve_forever(host, port, reuse_port=True))
+    finally:
+        os._exit(0)
+
+def start_prefork_server(host: str = '0.0.0.0', port: int = 5000, processes: int = 0,
+                         workers: int = 0, cache_bytes: int = 64 * 1024 * 1024,
+                         scheduler_policy: str = 'drr'):
+    """Fork processes that share one port and one SharedCache, restarting any that die"""
+    global shared_cache
+    processes = processes or os.cpu_count() or 1
+    shared_cache = SharedCache(arena_bytes=cache_bytes)
+    # Import the compiler and precompile the examples once so forked workers share them
+    warm_worker()
+    examples = ExampleStore('./examples', compile_example)
+    examples.load()
+
+    print(f"Starting {SERVER_NAME} on {host}:{port} with {processes} prefork processes "
+          f"and a {cache_bytes // (1024 * 1024)} MB shared cache")
+    print("Press Ctrl+C to stop the server")
+
+    def spawn() -> int:
+        pid = os.fork()
+        if pid == 0:
+            run_prefork_worker(AsyncCompilerServer(workers, examples=examples,
+                                                   scheduler_policy=scheduler_policy), host, port)
+        return pid
+
+    children = {spawn() for _ in range(processes)}
+    stopping = False
+
+    def stop(signum, frame):
+        nonlocal stopping
+        stopping = True
+        for pid in children:
+            try:
+                os.kill(pid, signal.SIGTERM)
+            except ProcessLookupError:
+                pass
+
+    signal.signal(signal.SIGINT, stop)
+    signal.signal(signal.SIGTERM, stop)
+    while children:
+        try:
+            pid, _ = os.wait()
+        except ChildProcessError:
+            break
+        children.discard(pid)
+        if not stopping:
+            print(f"Worker {pid} exited, restarting it")
+            children.add(spawn())
+    print("\nServer stopped")
+
+def main():
+    """Main entry point for the asyncio server"""
+    import argparse
+
+    parser = argparse.ArgumentParser(description=SERVER_NAME)
+    parser.add_argument('--host', default='0.0.0.0', help='Host address (default: 0.0.0.0)')
+    parser.add_argument('--port', type=int, default=int(os.environ.get('PORT', 5000)),
+                        help='Port number (default: $PORT or 5000)')
+    parser.add_argument('--workers', type=int, default=None,
+                        help='Compiler worker processes (default: CPU count; 0 with --processes)')
+    parser.add_argument('--processes', type=int, default=None,
+                        help='Prefork this many servers on one port with a shared cache (0: CPU count)')
+    parser.add_argument('--cache-mb', type=int, default=64, help='Shared cache size with --processes')
+    parser.add_argument('--scheduler', choices=['drr', 'fifo'], default=os.environ.get('SCHEDULER', 'drr'),
+                        help='Order of queued compiles: fair share between request classes, or arrival order')
+    args = parser.parse_args()
+    if args.processes is not None:
+        start_prefork_server(args.host, args.port, args.processes, args.workers or 0,
+                             args.cache_mb * 1024 * 1024, args.scheduler)
+    else:
+        start_async_server(args.host, args.port, args.workers, args.scheduler)
+
+if __name__ == "__main__":
+    main()
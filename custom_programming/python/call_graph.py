@@ -0,0 +1,90 @@
+"""
+Call Graph
+Finds the free functions a program can call, starting from main, from the AST
+alone, so it can run before semantic analysis. The code generator emits only
+reachable functions. With fast_analysis the semantic analyzer also skips the
+bodies of unreachable ones.
+
+Code outside free functions is always kept and its calls are roots: global
+initializers, and the constructors and methods of every class. Any use of a
+function's name counts as a call, whether or not the call is valid. Without a
+main function nothing is pruned.
+"""
+
+from typing import Dict, List, Set
+
+from parser import *
+
+class CallGraph:
+    """Free functions of one program and which of them are reachable from main"""
+
+    def __init__(self, program: Program):
+        self.functions: Dict[str, FunctionDeclaration] = {}
+        roots: Set[str] = set()
+        for declaration in program.declarations:
+            if type(declaration) is FunctionDeclaration:
+                self.functions.setdefault(declaration.name, declaration)
+        self.calls: Dict[str, Set[str]] = {}
+        for declaration in program.declarations:
+            if type(declaration) is FunctionDeclaration:
+                self.calls.setdefault(declaration.name, set()).update(self.referenced(declaration.body))
+            else:
+                roots |= self.referenced(declaration)
+
+        self.reachable: Set[str] = set()
+        if 'main' not in self.functions:
+            self.reachable.update(self.functions)
+            return
+        pending = ['main', *roots]
+        while pending:
+            name = pending.pop()
+            if name in self.reachable or name not in self.functions:
+                continue
+            self.reachable.add(name)
+            pending.extend(self.calls.get(name, ()))
+
+    def referenced(self, node: ASTNode) -> Set[str]:
+        """Names of free functions used anywhere under node"""
+        names = set()
+        for child in walk(node):
+            if type(child) is FunctionCall or type(child) is Identifier:
+                if child.name in self.functions:
+                    names.add(child.name)
+        return names
+
+    def is_reachable(self, name: str) -> bool:
+        return name in self.reachable
+
+    def unreachable(self) -> List[str]:
+        """Names of the functions that are never called, in declaration order"""
+        return [name for name in self.functions if name not in self.reachable]
+
+    def report(self, analysis_skipped: bool = False) -> str:
+        """One line of verbose compiler output on what was pruned"""
+        pruned = self.unreachable()
+        line = f"Call graph: {len(self.functions) - len(pruned)} of {len(self.functions)} functions reachable from main"
+        if pruned:
+            line += f", pruned {len(pruned)}"
+            if analysis_skipped:
+                line += " (not analyzed)"
+            line += ": " + ", ".join(pruned)
+        return line
+
+def main():
+    """Print the functions a sample program can and cannot reach"""
+    from lexer import Lexer
+
+    source_code = """
+int square(int x) { return x * x; }
+int cube(int x) { return x * square(x); }
+int unused(int x) { return cube(x) + 1; }
+int main() {
+    cout << cube(3) << endl;
+    return 0;
+}
+"""
+    graph = CallGraph(Parser(Lexer(source_code).tokenize()).parse())
+    print(graph.report())
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,322 @@
+"""
+Custom Language Translation
+Server-side port of the Flutter app's CustomLanguageParser. It translates code
+written with a custom language's keywords, such as the app's Urdu and Hindi
+samples, to C++ before compilation. A client uploads a language definition
+once to /languages and then sends its hash with each /compile request. Every
+language's replacement patterns are compiled once and cached by that hash.
+"""
+
+import hashlib
+import json
+import re
+import threading
+import unicodedata
+from collections import OrderedDict
+from typing import Dict, List, Optional, Tuple
+
+# The translation passes, in the app's order: (section, field, C++ text, whole word).
+# Whole-word passes only replace text that is not part of a longer word.
+PASSES = [
+    # Control structures
+    ('controlStructures', 'ifStatement', 'if', True),
+    ('controlStructures', 'elseStatement', 'else', True),
+    ('controlStructures', 'elseIfStatement', 'else if', True),
+    ('controlStructures', 'forLoop', 'for', True),
+    ('controlStructures', 'whileLoop', 'while', True),
+    ('controlStructures', 'doWhileLoop', 'do', True),
+    ('controlStructures', 'switchStatement', 'switch', True),
+    ('controlStructures', 'caseStatement', 'case', True),
+    ('controlStructures', 'defaultCase', 'default', True),
+    ('controlStructures', 'breakStatement', 'break', True),
+    ('controlStructures', 'continueStatement', 'continue', True),
+    ('controlStructures', 'returnStatement', 'return', True),
+    # Data types
+    ('dataTypes', 'integerType', 'int', True),
+    ('dataTypes', 'stringType', 'string', True),
+    ('dataTypes', 'booleanType', 'bool', True),
+    ('dataTypes', 'floatType', 'float', True),
+    ('dataTypes', 'doubleType', 'double', True),
+    ('dataTypes', 'characterType', 'char', True),
+    ('dataTypes', 'voidType', 'void', True),
+    # Operators, longest first
+    ('operators', 'greaterThanOrEqual', '>=', False),
+    ('operators', 'lessThanOrEqual', '<=', False),
+    ('operators', 'equality', '==', False),
+    ('operators', 'notEqual', '!=', False),
+    ('operators', 'logicalAnd', '&&', False),
+    ('operators', 'logicalOr', '||', False),
+    ('operators', 'addition', '+', False),
+    ('operators', 'subtraction', '-', False),
+    ('operators', 'multiplication', '*', False),
+    ('operators', 'division', '/', False),
+    ('operators', 'modulo', '%', False),
+    ('operators', 'assignment', '=', False),
+    ('operators', 'lessThan', '<', False),
+    ('operators', 'greaterThan', '>', False),
+    ('operators', 'logicalNot', '!', False),
+    # Functions; a custom function declaration keyword has no C++ equivalent and is removed
+    ('functions', 'mainFunction', 'main', True),
+    ('functions', 'functionDeclaration', '', True),
+    # Keywords
+    ('keywords', 'include', '#include', False),
+    ('keywords', 'namespace', 'namespace', True),
+    ('keywords', 'using', 'using', True),
+    ('keywords', 'struct', 'struct', True),
+    ('keywords', 'class', 'class', True),
+    ('keywords', 'public', 'public', True),
+    ('keywords', 'private', 'private', True),
+    ('keywords', 'protected', 'protected', True),
+    # Comments
+    ('comments', 'singleLineComment', '//', False),
+    ('comments', 'multiLineCommentStart', '/*', False),
+    ('comments', 'multiLineCommentEnd', '*/', False),
+]
+
+# Spelling of each element when a definition leaves it out
+DEFAULT_SPELLINGS = {(section, field): cpp for section, field, cpp, _ in PASSES}
+DEFAULT_SPELLINGS['functions', 'functionDeclaration'] = 'function'
+
+# Elements whose custom spelling replaces the C++ keyword, for validation
+CUSTOM_SYNTAX_FIELDS = [
+    ('controlStructures', field) for field in (
+        'ifStatement', 'elseStatement', 'elseIfStatement', 'forLoop', 'whileLoop', 'doWhileLoop',
+        'switchStatement', 'caseStatement', 'defaultCase', 'breakStatement', 'continueStatement',
+        'returnStatement')
+] + [
+    ('dataTypes', field) for field in (
+        'integerType', 'stringType', 'booleanType', 'floatType', 'doubleType', 'characterType',
+        'voidType')
+] + [('functions', 'mainFunction')] + [
+    ('keywords', field) for field in ('namespace', 'using', 'struct', 'class', 'public',
+                                      'private', 'protected')
+]
+
+FORBIDDEN_CPP_KEYWORDS = {
+    'if', 'else', 'for', 'while', 'do', 'switch', 'case', 'default',
+    'break', 'continue', 'return', 'int', 'string', 'bool', 'float',
+    'double', 'char', 'void', 'main', 'namespace', 'using', 'struct',
+    'class', 'public', 'private', 'protected'
+}
+
+COMMON_USER_NAMES = {
+    'x', 'y', 'z', 'i', 'j', 'k', 'n', 'm', 'count', 'index', 'temp',
+    'value', 'result', 'data', 'item', 'element', 'node', 'size', 'length',
+    'width', 'height', 'name', 'id', 'key', 'val', 'num', 'number',
+    'str', 'text', 'message', 'info', 'flag', 'status', 'type', 'mode',
+    'cout', 'cin', 'endl', 'std', 'iostream'
+}
+
+LITERALS_AND_COMMENTS = re.compile(r'"[^"]*"|\'[^\']*\'|//.*|/\*[\s\S]*?\*/')
+ASCII_WORD = re.compile(r'\b[a-zA-Z_][a-zA-Z0-9_]*\b', re.ASCII)
+USER_IDENTIFIER = re.compile(r'[a-z][a-zA-Z0-9]*|[A-Z][a-zA-Z0-9]*|[a-z_]+[a-z0-9_]*|\d+')
+CPP_LOOKING = [re.compile(pattern) for pattern in
+               (r'\bif\s*\(', r'\bfor\s*\(', r'\bwhile\s*\(', r'\bint\s+\w+', r'\bstring\s+\w+')]
+
+class LanguageError(Exception):
+    """Code that does not follow its custom language, or an unusable definition"""
+
+def is_word_character(character: str) -> bool:
+    # Combining marks count, so a Devanagari word ending in a vowel sign is one word
+    return character.isalnum() or character == '_' or unicodedata.category(character)[0] == 'M'
+
+def definition_hash(definition: dict) -> str:
+    """Content hash of the parts of a definition that affect translation"""
+    canonical = json.dumps({'name': definition.get('name', ''), 'syntax': definition.get('syntax', {})},
+                           sort_keys=True, ensure_ascii=False, separators=(',', ':'))
+    return hashlib.sha256(canonical.encode('utf-8')).hexdigest()[:32]
+
+class Translator:
+    """One language's compiled translation passes
+
+    Word boundaries are Unicode-aware, so Urdu and Hindi keywords are matched
+    as whole words. The app's Dart \\b only treats ASCII letters as word
+    characters, so it never matches them.
+    """
+
+    def __init__(self, definition: dict):
+        syntax = definition.get('syntax')
+        if not isinstance(syntax, dict):
+            raise LanguageError("Language definition has no 'syntax'")
+        self.name = str(definition.get('name', 'custom'))
+
+        def spelling(section: str, field: str) -> str:
+            value = (syntax.get(section) or {}).get(field)
+            return DEFAULT_SPELLINGS[section, field] if value is None else str(value)
+
+        # Elements spelled as in C++ would replace themselves and are skipped
+        self.passes: List[Tuple['re.Pattern', str, bool]] = []
+        for section, field, cpp, whole_word in PASSES:
+            custom = spelling(section, field)
+            if custom and custom != DEFAULT_SPELLINGS[section, field]:
+                self.passes.append((re.compile(re.escape(custom)), cpp, whole_word))
+
+        self.custom_syntax = {spelling(section, field) for section, field in CUSTOM_SYNTAX_FIELDS}
+        self.if_example = spelling('controlStructures', 'ifStatement')
+        self.int_example = spelling('dataTypes', 'integerType')
+        self.main_example = spelling('functions', 'mainFunction')
+
+    def translate(self, code: str) -> str:
+        """C++ for code in this language; raises LanguageError like the app's parser"""
+        self.validate(code)
+        code = code.replace('\r\n', '\n').replace('\r', '\n').strip()
+        for pattern, cpp, whole_word in self.passes:
+            if whole_word:
+                code = pattern.sub(lambda match: cpp if self.at_word_boundaries(match) else match.group(0),
+                                   code)
+            else:
+                code = pattern.sub(lambda match: cpp, code)
+        return self.add_standard_headers(code)
+
+    @staticmethod
+    def at_word_boundaries(match: 're.Match') -> bool:
+        text, start, end = match.string, match.start(), match.end()
+        return ((start == 0 or not is_word_character(text[start - 1]))
+                and (end == len(text) or not is_word_character(text[end])))
+
+    def validate(self, code: str):
+        """Reject standard C++ keywords the language renames, and plain C++"""
+        words = ASCII_WORD.findall(LITERALS_AND_COMMENTS.sub('', code))
+        violating = sorted({word for word in words
+                            if word in FORBIDDEN_CPP_KEYWORDS and word not in self.custom_syntax
+                            and not self.likely_user_identifier(word)})
+        if violating:
+            raise LanguageError(
+                f"Standard C++ keywords found: {', '.join(violating)}. When using custom language "
+                f"\"{self.name}\", you must use only the custom syntax you defined. For example, "
+                f"use \"{self.if_example}\" instead of \"if\".")
+        if code.strip() and not any(keyword in code for keyword in self.custom_syntax):
+            if any(pattern.search(code) for pattern in CPP_LOOKING):
+                raise LanguageError(
+                    f"This appears to be standard C++ code. When using custom language \"{self.name}\", "
+                    f"you must write code using your custom syntax.\n\nFor example, use:\n"
+                    f"• \"{self.if_example}\" instead of \"if\"\n"
+                    f"• \"{self.int_example}\" instead of \"int\"\n"
+                    f"• \"{self.main_example}\" instead of \"main\"\n\n"
+                    f"Switch to \"Standard C++\" mode if you want to write regular C++ code.")
+
+    @staticmethod
+    def likely_user_identifier(word: str) -> bool:
+        return word.lower() in COMMON_USER_NAMES or USER_IDENTIFIER.fullmatch(word) is not None
+
+    @staticmethod
+    def add_standard_headers(code: str) -> str:
+        """Add <iostream> and using namespace std for code that uses cout, cin or endl"""
+        uses_io = 'cout' in code or 'cin' in code or 'endl' in code
+        header = ''
+        if uses_io and '#include <iostream>' not in code and '#include<iostream>' not in code:
+            header += '#include <iostream>\n'
+        if uses_io and 'using namespace std' not in code and 'std::' not in code:
+            header += 'using namespace std;\n'
+        return header + '\n' + code if header else code
+
+class LanguageStore:
+    """Uploaded language definitions and their translators, by hash
+
+    Holds the max_languages most recently used languages. A language can also
+    be looked up by the id the app gave it, which maps to its latest upload.
+    """
+
+    def __init__(self, max_languages: int = 256):
+        self.max_languages = max_languages
+        self.translators: 'OrderedDict[str, Translator]' = OrderedDict()
+        self.ids: Dict[str, str] = {}
+        self.lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+
+    def register(self, definition: dict) -> str:
+        """Store a definition, compiling its translator if it is new; returns its hash"""
+        language_hash = definition_hash(definition)
+        with self.lock:
+            if language_hash in self.translators:
+                self.translators.move_to_end(language_hash)
+            else:
+                translator = Translator(definition)
+                self.translators[language_hash] = translator
+                if len(self.translators) > self.max_languages:
+                    evicted, _ = self.translators.popitem(last=False)
+                    self.ids = {key: value for key, value in self.ids.items() if value != evicted}
+            if definition.get('id'):
+                self.ids[str(definition['id'])] = language_hash
+        return language_hash
+
+    def get(self, language_hash: Optional[str] = None, language_id: Optional[str] = None) -> Optional[Translator]:
+        with self.lock:
+            if language_hash is None and language_id is not None:
+                language_hash = self.ids.get(str(language_id))
+            translator = self.translators.get(language_hash) if language_hash else None
+            if translator is None:
+                self.misses += 1
+                return None
+            self.translators.move_to_end(language_hash)
+            self.hits += 1
+            return translator
+
+    def stats(self) -> dict:
+        return {"languages": len(self.translators), "hits": self.hits, "misses": self.misses}
+
+def register_response(store: LanguageStore, data) -> Tuple[int, dict]:
+    """(status, payload) for POST /languages with a language definition as the body"""
+    if not isinstance(data, dict) or not data:
+        return 400, {"success": False, "error": "No language definition provided",
+                     "details": ["The body must be a language definition as the app exports it"]}
+    try:
+        language_hash = store.register(data)
+    except LanguageError as e:
+        return 400, {"success": False, "error": "Invalid language definition", "details": [str(e)]}
+    return 200, {"success": True, "language_hash": language_hash, "id": data.get('id')}
+
+def translate_request(store: LanguageStore, data: dict, source_code: str) -> Tuple[Optional[str], Optional[tuple]]:
+    """The C++ to compile for a /compile request: (source, None) or (None, (status, error payload))
+
+    Requests without language_hash or language_id are C++ already.
+    """
+    language_hash, language_id = data.get('language_hash'), data.get('language_id')
+    if not language_hash and not language_id:
+        return source_code, None
+    translator = store.get(language_hash, language_id)
+    if translator is None:
+        return None, (404, {
+            "success": False,
+            "error": "Unknown language",
+            "details": ["Upload the language definition to /languages, then retry"],
+            "unknown_language": True,
+            "output": "",
+            "execution_output": ""
+        })
+    try:
+        return translator.translate(source_code), None
+    except LanguageError as e:
+        return None, (400, {
+            "success": False,
+            "error": "Custom Language Error",
+            "details": [str(e)],
+            "output": "",
+            "execution_output": ""
+        })
+
+def main():
+    """Translate a program in a small Urdu-keyword language"""
+    definition = {
+        "id": "urdu-demo",
+        "name": "اردو",
+        "syntax": {
+            "controlStructures": {"ifStatement": "اگر", "elseStatement": "ورنہ", "forLoop": "لوپ",
+                                  "returnStatement": "واپس"},
+            "dataTypes": {"integerType": "عدد"},
+        },
+    }
+    store = LanguageStore()
+    language_hash = store.register(definition)
+    code = """عدد main() {
+    لوپ (عدد i = 0; i < 3; i++) {
+        اگر (i == 1) { cout << "ایک" << endl; } ورنہ { cout << i << endl; }
+    }
+    واپس 0;
+}"""
+    print(language_hash)
+    print(store.get(language_hash).translate(code))
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,182 @@
+"""
+C++ Example Program Store
+Loads the example programs once, compiles and runs each of them, and keeps the
+encoded /examples response (plain and gzipped) with its ETag, so requests are
+served from memory and clients that already have the list get a 304. A polling
+watcher reloads the store when the examples directory changes.
+"""
+
+import gzip
+import hashlib
+import json
+import threading
+import time
+from pathlib import Path
+from typing import Callable, Dict, List, NamedTuple, Optional, Tuple
+
+from compilation_context import CompilationContext
+
+class ExampleSnapshot(NamedTuple):
+    """Everything served for one version of the examples directory"""
+    signature: tuple
+    examples: List[dict]
+    results: Dict[str, dict]   # source digest -> /compile result of the example
+    body: bytes
+    gzipped: bytes
+    etag: str
+
+def source_digest(source_code: str) -> str:
+    return hashlib.sha256(source_code.strip().encode('utf-8')).hexdigest()
+
+class ExampleStore:
+    """Preloaded, precompiled example programs
+
+    compile_function is main.compile_source_api or anything with its
+    signature and result format.
+    """
+
+    def __init__(self, directory: str, compile_function: Callable[[str, CompilationContext], dict],
+                 fallback: Optional[List[dict]] = None, category: Optional[str] = None):
+        self.directory = Path(directory)
+        self.compile_function = compile_function
+        # Examples served when the directory is missing or empty
+        self.fallback = fallback or []
+        # Category reported for examples read from the directory, if any
+        self.category = category
+        self.snapshot: Optional[ExampleSnapshot] = None
+        self.lock = threading.Lock()
+        self.watcher: Optional[threading.Thread] = None
+        self.reloads = 0
+
+    def signature(self) -> tuple:
+        """Names, sizes and modification times of the example files"""
+        if not self.directory.is_dir():
+            return ()
+        entries = []
+        for path in sorted(self.directory.glob('*.cpp')):
+            try:
+                stat = path.stat()
+            except OSError:
+                continue
+            entries.append((path.name, stat.st_mtime_ns, stat.st_size))
+        return tuple(entries)
+
+    def ensure_loaded(self) -> ExampleSnapshot:
+        """The current snapshot, loading it on first use"""
+        snapshot = self.snapshot
+        if snapshot is None:
+            snapshot = self.load()
+        return snapshot
+
+    def load(self) -> ExampleSnapshot:
+        """Read, compile and encode the examples; reuses results of unchanged programs"""
+        with self.lock:
+            signature = self.signature()
+            if self.snapshot is not None and self.snapshot.signature == signature:
+                return self.snapshot
+            previous = self.snapshot.results if self.snapshot is not None else {}
+
+            examples = []
+            for name, _, _ in signature:
+                try:
+                    code = (self.directory / name).read_text(encoding='utf-8')
+                except (OSError, UnicodeDecodeError):
+                    continue
+                example = {
+                    "filename": name,
+                    "code": code,
+                    "description": f"Example: {Path(name).stem}"
+                }
+                if self.category:
+                    example["category"] = self.category
+                examples.append(example)
+            if not examples:
+                examples = [dict(example) for example in self.fallback]
+
+            results = {}
+            for example in examples:
+                digest = source_digest(example['code'])
+                result = previous.get(digest)
+                if result is None:
+                    context = CompilationContext(filename=example['filename'], show_generated_code=True)
+                    result = self.compile_function(example['code'], context)
+                results[digest] = result
+                example['output'] = result.get('execution_output', '')
+
+            body = json.dumps({"success": True, "examples": examples, "count": len(examples)}).encode('utf-8')
+            self.snapshot = ExampleSnapshot(
+                signature=signature,
+                examples=examples,
+                results=results,
+                body=body,
+                gzipped=gzip.compress(body, mtime=0),
+                etag='"' + hashlib.sha256(body).hexdigest()[:32] + '"'
+            )
+            self.reloads += 1
+            return self.snapshot
+
+    def response(self, if_none_match: Optional[str], accept_encoding: Optional[str]) -> Tuple[int, bytes, dict]:
+        """(status, body, headers) of GET /examples for the given request headers"""
+        snapshot = self.ensure_loaded()
+        headers = {
+            'ETag': snapshot.etag,
+            'Cache-Control': 'no-cache',  # revalidate with If-None-Match every time
+            'Vary': 'Accept-Encoding',
+        }
+        if if_none_match and (if_none_match.strip() == '*' or snapshot.etag in
+                              [tag.strip().removeprefix('W/') for tag in if_none_match.split(',')]):
+            return 304, b'', headers
+        headers['Content-Type'] = 'application/json'
+        if accept_encoding and 'gzip' in accept_encoding.lower():
+            headers['Content-Encoding'] = 'gzip'
+            return 200, snapshot.gzipped, headers
+        return 200, snapshot.body, headers
+
+    def cached_result(self, source_code: str, context: CompilationContext) -> Optional[dict]:
+        """The precomputed /compile result for an unmodified example, if it matches context"""
+        snapshot = self.snapshot
+        if snapshot is None or context.verbose:
+            return None
+        result = snapshot.results.get(source_digest(source_code))
+        if result is None:
+            return None
+        generated_code = result.get('generated_code')
+        if context.show_generated_code and generated_code and f"# Source: {context.filename!r}" not in generated_code:
+            return None  # the stored code names the example's own file
+        result = dict(result)
+        if 'generated_code' in result and not context.show_generated_code:
+            result['generated_code'] = None
+        return result
+
+    def watch(self, interval: float = 1.0):
+        """Reload in a background thread whenever the directory changes"""
+        if self.watcher is not None and self.watcher.is_alive():
+            return
+
+        def poll():
+            while True:
+                time.sleep(interval)
+                if self.snapshot is None or self.signature() != self.snapshot.signature:
+                    try:
+                        self.load()
+                    except Exception as e:
+                        print(f"Reloading examples failed: {e}")
+
+        self.watcher = threading.Thread(target=poll, name="examples-watcher", daemon=True)
+        self.watcher.start()
+
+def main():
+    """Test the example store"""
+    from main import compile_source_api
+
+    store = ExampleStore('./examples', compile_source_api)
+    snapshot = store.load()
+    print(f"Loaded {len(snapshot.examples)} examples, ETag {snapshot.etag}")
+    print(f"Body {len(snapshot.body)} bytes, gzipped {len(snapshot.gzipped)} bytes")
+    status, _, _ = store.response(snapshot.etag, None)
+    print(f"Conditional GET with current ETag: {status}")
+    for example in snapshot.examples:
+        print(f"  {example['filename']}: {example['output'][:40]!r}")
+
+if __name__ == "__main__":
+    main()
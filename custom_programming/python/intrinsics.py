@@ -0,0 +1,146 @@
+"""
+<cmath> Intrinsics
+The math library functions the compiler knows without a declaration. Each
+entry gives the function's arity, how its result type follows from its
+argument types, whether it is pure, and the Python expression a call is
+lowered to, so a call costs a math module call or an operator instead of a
+runtime wrapper.
+
+Lowerings are templates over the argument code {0}, {1}. Where Python raises
+for inputs C++ accepts (sqrt(-1), log(0), asin(2), fmod(x, 0)), a guard
+selects the direct form on the inputs Python handles and a fallback gives the
+C++ result on the rest. An argument read more than once is evaluated once:
+its first occurrence in the guard, or in the lowering when there is no guard,
+binds it to a temporary. sin, cos and tan of an infinity raise a runtime error
+instead of returning nan.
+
+A user-defined function of the same name takes precedence over an intrinsic.
+"""
+
+import math
+from dataclasses import dataclass
+from typing import Dict, List, Optional
+
+INTEGRAL_TYPES = ('bool', 'int', 'long')
+FLOATING_TYPES = ('float', 'double')
+
+# Every double at least this large in magnitude is an integer
+INTEGRAL_DOUBLE_BOUND = '4503599627370496.0'
+
+@dataclass(frozen=True)
+class Intrinsic:
+    """One <cmath> function and how calls to it are typed and lowered"""
+    name: str
+    arity: int
+    lowering: str
+    guard: Optional[str] = None
+    fallback: Optional[str] = None
+    # abs of an integer is an integer; everything else is floating
+    keeps_integers: bool = False
+    # The float overload's result needs no rounding to single precision
+    float_exact: bool = False
+    # No side effects, so calls with constant arguments are folded
+    pure: bool = True
+    header: str = '<cmath>'
+
+    def result_type(self, argument_types: List[str]) -> Optional[str]:
+        """The C++ result type for these argument types, or None if no overload matches
+
+        Integral arguments convert to double; the result is float only when
+        every argument is float.
+        """
+        if any(arg_type not in INTEGRAL_TYPES + FLOATING_TYPES for arg_type in argument_types):
+            return None
+        if self.keeps_integers and argument_types[0] in INTEGRAL_TYPES:
+            return 'int' if argument_types[0] == 'bool' else argument_types[0]
+        return 'float' if all(arg_type == 'float' for arg_type in argument_types) else 'double'
+
+    def templates(self) -> List[str]:
+        """The guard, lowering and fallback templates, in evaluation order"""
+        if self.guard is None:
+            return [self.lowering]
+        return [self.guard, self.lowering, self.fallback]
+
+def _integral_valued(name: str, lowering: str) -> Intrinsic:
+    """floor and friends: doubles too large to have a fraction, infinities and nan are returned as is"""
+    bound = INTEGRAL_DOUBLE_BOUND
+    return Intrinsic(name, 1, lowering, guard=f"-{bound} < {{0}} < {bound}", fallback="{0}",
+                     float_exact=True)
+
+def _logarithm(name: str, function: str) -> Intrinsic:
+    return Intrinsic(name, 1, f"{function}({{0}})", guard="{0} > 0.0",
+                     fallback="(-math.inf if {0} == 0.0 else math.nan)")
+
+INTRINSICS: Dict[str, Intrinsic] = {intrinsic.name: intrinsic for intrinsic in (
+    Intrinsic('sqrt', 1, "math.sqrt({0})", guard="{0} >= 0.0", fallback="math.nan"),
+    Intrinsic('exp', 1, "math.exp({0})", guard="{0} <= 709.0", fallback="cpp_exp({0})"),
+    _logarithm('log', 'math.log'),
+    _logarithm('log10', 'math.log10'),
+    _logarithm('log2', 'math.log2'),
+    Intrinsic('pow', 2, "cpp_pow({0}, {1})"),
+    Intrinsic('sin', 1, "math.sin({0})"),
+    Intrinsic('cos', 1, "math.cos({0})"),
+    Intrinsic('tan', 1, "math.tan({0})"),
+    Intrinsic('asin', 1, "math.asin({0})", guard="-1.0 <= {0} <= 1.0", fallback="math.nan"),
+    Intrinsic('acos', 1, "math.acos({0})", guard="-1.0 <= {0} <= 1.0", fallback="math.nan"),
+    Intrinsic('atan', 1, "math.atan({0})"),
+    Intrinsic('atan2', 2, "math.atan2({0}, {1})"),
+    Intrinsic('tanh', 1, "math.tanh({0})"),
+    Intrinsic('hypot', 2, "math.hypot({0}, {1})"),
+    Intrinsic('fmod', 2, "math.fmod({0}, {1})", guard="{1} != 0.0", fallback="math.nan", float_exact=True),
+    _integral_valued('floor', "({0} // 1.0)"),
+    _integral_valued('ceil', "(-(-{0} // 1.0))"),
+    _integral_valued('trunc', "math.copysign(abs({0}) // 1.0, {0})"),
+    Intrinsic('round', 1, "cpp_round({0})", float_exact=True),
+    Intrinsic('fabs', 1, "abs({0})", float_exact=True),
+    Intrinsic('abs', 1, "abs({0})", keeps_integers=True, float_exact=True),
+    # A nan argument loses to the other one
+    Intrinsic('fmin', 2, "{0}", guard="{0} <= {1} or {1} != {1}", fallback="{1}", float_exact=True),
+    Intrinsic('fmax', 2, "{0}", guard="{0} >= {1} or {1} != {1}", fallback="{1}", float_exact=True),
+)}
+
+def lookup_intrinsic(name: str) -> Optional[Intrinsic]:
+    """The intrinsic called name, qualified with std:: or not"""
+    if name.startswith('std::'):
+        name = name[len('std::'):]
+    return INTRINSICS.get(name)
+
+# Runtime helpers for the lowerings that need statements. Emitted into every
+# generated program, and executed here so the compiler can fold constant calls.
+RUNTIME_SUPPORT = '''\
+def cpp_exp(x):
+    try:
+        return math.exp(x)
+    except OverflowError:
+        return math.inf
+
+def cpp_pow(x, y):
+    try:
+        return math.pow(x, y)
+    except (OverflowError, ValueError):
+        # A negative base to a fractional power, or a pole or overflow,
+        # which is negative only for a negative base and an odd exponent
+        if x != 0.0 and y % 1.0 != 0.0:
+            return math.nan
+        return math.copysign(math.inf, x if y % 2.0 == 1.0 else 1.0)
+
+def cpp_round(x):
+    # Halfway cases round away from zero
+    if not math.isfinite(x):
+        return x
+    whole = abs(x) // 1.0
+    if abs(x) - whole >= 0.5:
+        whole += 1.0
+    return math.copysign(whole, x)
+'''
+
+FOLDING_NAMESPACE = {'math': math}
+exec(RUNTIME_SUPPORT, FOLDING_NAMESPACE)
+
+def fold(code: str) -> Optional[float]:
+    """The value of a lowered call on constant arguments, or None if it raises"""
+    try:
+        value = eval(code, FOLDING_NAMESPACE)
+    except (ArithmeticError, ValueError):
+        return None
+    return value if isinstance(value, (int, float)) else None
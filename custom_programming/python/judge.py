@@ -0,0 +1,195 @@
+"""
+Judge Mode
+Grading runs one submission against many tests. The submission is compiled
+once; each test then runs the compiled program with its own input as
+cpp_stdin, under a time limit and an output limit, and compares what it
+printed with the expected output. Tests are independent, so hosts fan them
+out across their worker pools and only the generated code travels to the
+workers.
+
+Verdicts per test: AC (accepted), WA (wrong answer), RE (runtime error or a
+nonzero exit status), TLE (time limit exceeded) and OLE (output limit
+exceeded). The submission's verdict is AC when every test is, else the
+verdict of the first test that is not; CE when it does not compile.
+"""
+
+import ctypes
+import os
+import signal
+import threading
+from contextlib import contextmanager
+from typing import Iterator, List, NamedTuple, Optional, Tuple
+
+ACCEPTED = 'AC'
+WRONG_ANSWER = 'WA'
+RUNTIME_ERROR = 'RE'
+TIME_LIMIT_EXCEEDED = 'TLE'
+OUTPUT_LIMIT_EXCEEDED = 'OLE'
+COMPILE_ERROR = 'CE'
+
+# 'exact' compares outputs character for character; 'tokens' compares their
+# whitespace-separated tokens, so spacing and line breaks don't matter
+COMPARISONS = ('tokens', 'exact')
+
+# Characters of each test's output returned in the response
+OUTPUT_PREVIEW_CHARS = 256
+
+class JudgeLimits(NamedTuple):
+    """Per-test limits of a judge request, and the most a request may ask for"""
+    time_limit_ms: int = 2000
+    output_limit_bytes: int = 1024 * 1024
+    max_tests: int = 200
+
+    @classmethod
+    def from_environment(cls) -> 'JudgeLimits':
+        """Limits overridden by JUDGE_TIME_LIMIT_MS, JUDGE_OUTPUT_LIMIT_BYTES and JUDGE_MAX_TESTS"""
+        defaults = cls()
+        return cls(
+            time_limit_ms=int(os.environ.get('JUDGE_TIME_LIMIT_MS', defaults.time_limit_ms)),
+            output_limit_bytes=int(os.environ.get('JUDGE_OUTPUT_LIMIT_BYTES', defaults.output_limit_bytes)),
+            max_tests=int(os.environ.get('JUDGE_MAX_TESTS', defaults.max_tests)),
+        )
+
+    def for_request(self, data: dict) -> 'JudgeLimits':
+        """The limits a request asks for with "time_limit_ms" and "output_limit_bytes", capped at these"""
+        return self._replace(
+            time_limit_ms=capped(data.get('time_limit_ms'), self.time_limit_ms),
+            output_limit_bytes=capped(data.get('output_limit_bytes'), self.output_limit_bytes),
+        )
+
+def capped(requested, cap: int) -> int:
+    """A requested positive limit no greater than cap; cap when absent or invalid"""
+    if isinstance(requested, bool) or not isinstance(requested, (int, float)) or requested <= 0:
+        return cap
+    return min(int(requested), cap)
+
+class JudgeTest(NamedTuple):
+    """One test: the program's standard input and the output it must print"""
+    name: str
+    input: str
+    expected: str
+
+def rejection(message: str, detail: str) -> Tuple[int, dict]:
+    """400 response for a malformed judge request"""
+    return 400, {"success": False, "error": message, "details": [detail],
+                 "output": "", "execution_output": ""}
+
+def parse_judge_request(data: dict, limits: JudgeLimits) -> tuple:
+    """The tests, comparison and limits of a /judge request body
+
+    Returns (tests, comparison, limits, None), or (None, None, None,
+    (status, payload)) for a request to turn away.
+    """
+    tests = data.get('tests')
+    if not isinstance(tests, list) or not tests:
+        return None, None, None, rejection("No tests provided",
+                                           "The 'tests' field must be a non-empty list")
+    if len(tests) > limits.max_tests:
+        return None, None, None, rejection("Too many tests",
+                                           f"A submission is judged on at most {limits.max_tests} tests")
+    parsed: List[JudgeTest] = []
+    for number, test in enumerate(tests, 1):
+        if not isinstance(test, dict):
+            return None, None, None, rejection("Invalid test", f"Test {number} must be an object")
+        test_input = test.get('input', '')
+        expected = test.get('expected')
+        if not isinstance(test_input, str) or not isinstance(expected, str):
+            return None, None, None, rejection(
+                "Invalid test", f"Test {number} needs a string 'expected' and an optional string 'input'")
+        parsed.append(JudgeTest(str(test.get('name') or number), test_input, expected))
+    comparison = data.get('comparison', 'tokens')
+    if comparison not in COMPARISONS:
+        return None, None, None, rejection("Invalid comparison",
+                                           f"'comparison' must be one of {', '.join(COMPARISONS)}")
+    return parsed, comparison, limits.for_request(data), None
+
+def outputs_match(actual: str, expected: str, comparison: str) -> bool:
+    """Whether a program's output is the expected output under comparison"""
+    if comparison == 'exact':
+        return actual == expected
+    return actual.split() == expected.split()
+
+# The limits raise BaseException subclasses so no handler in a program can
+# catch them
+class TimeLimitExceeded(BaseException):
+    pass
+
+class OutputLimitExceeded(BaseException):
+    pass
+
+class CappedOutput(list):
+    """Program output buffer (cpp_output_buffer) that stops the program past limit characters"""
+
+    def __init__(self, limit: int):
+        super().__init__()
+        self.limit = limit
+        self.size = 0
+
+    def append(self, text: str):
+        self.size += len(text)
+        if self.size > self.limit:
+            raise OutputLimitExceeded()
+        super().append(text)
+
+    def clear(self):
+        super().clear()
+        self.size = 0
+
+@contextmanager
+def time_limit(seconds: float) -> Iterator[None]:
+    """Raise TimeLimitExceeded in this thread if the block runs longer than seconds
+
+    The main thread (a worker process's) uses an interval timer and SIGALRM.
+    Other threads get the exception from a timer thread, which takes effect at
+    the thread's next bytecode.
+    """
+    if threading.current_thread() is threading.main_thread():
+        def expire(signum, frame):
+            raise TimeLimitExceeded()
+        previous = signal.signal(signal.SIGALRM, expire)
+        signal.setitimer(signal.ITIMER_REAL, seconds)
+        try:
+            yield
+        finally:
+            signal.setitimer(signal.ITIMER_REAL, 0)
+            signal.signal(signal.SIGALRM, previous)
+        return
+    thread_id = ctypes.c_ulong(threading.get_ident())
+    timer = threading.Timer(seconds, ctypes.pythonapi.PyThreadState_SetAsyncExc,
+                            (thread_id, ctypes.py_object(TimeLimitExceeded)))
+    timer.start()
+    try:
+        yield
+    finally:
+        timer.cancel()
+        # The timer may have fired just as the block finished
+        timer.join()
+        ctypes.pythonapi.PyThreadState_SetAsyncExc(thread_id, None)
+
+def test_result(test: JudgeTest, verdict: str, seconds: float, output: str,
+                error: Optional[str] = None) -> dict:
+    """One test's entry in a judge response"""
+    return {
+        "name": test.name,
+        "verdict": verdict,
+        "time_ms": round(seconds * 1000, 3),
+        "output": output[:OUTPUT_PREVIEW_CHARS],
+        "error": error,
+    }
+
+def judgement(results: List[dict], compile_ms: float, judge_ms: float) -> dict:
+    """The judge response for a submission that compiled, from its tests' results"""
+    failed = next((result for result in results if result['verdict'] != ACCEPTED), None)
+    return {
+        "success": True,
+        "verdict": ACCEPTED if failed is None else failed['verdict'],
+        "passed": sum(result['verdict'] == ACCEPTED for result in results),
+        "total": len(results),
+        "compile_ms": round(compile_ms, 3),
+        "judge_ms": round(judge_ms, 3),
+        "tests": results,
+    }
+
+def compile_failure(error: dict, total: int) -> dict:
+    """The judge response for a submission of total tests that does not compile"""
+    return dict(error, verdict=COMPILE_ERROR, passed=0, total=total, tests=[])
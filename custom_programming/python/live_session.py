@@ -0,0 +1,207 @@
+"""
+Live Compile Sessions
+State and build scheduling for one WebSocket live-compile connection. The
+client streams edits (whole text or range replacements against its previous
+version); the session keeps the current source, debounces builds while the
+user is typing, drops builds made stale by newer edits, and pushes
+diagnostics and, on request, run results back as they become ready.
+
+Messages from the client (JSON text frames):
+    {"type": "open", "filename": ..., "show_generated_code": ..., "verbose": ..., "auto_run": ...}
+    {"type": "edit", "version": n, "code": "..."}
+    {"type": "edit", "version": n, "base": m, "changes": [{"start": s, "end": e, "text": "..."}]}
+    {"type": "run", "version": n}
+Messages to the client:
+    {"type": "diagnostics", "version": n, "success": ..., "error": ..., "details": [...], ...}
+    {"type": "result", "version": n, ...the /compile result...}
+    {"type": "resync", "version": m}   the edit's base is unknown; send the whole text
+    {"type": "error", "error": "...", ...}
+
+A session runs one job at a time in the server's pool: an edit replaces the
+build it makes stale and a run replaces an earlier run, and a job already in a
+worker holds the session's slot until it finishes. Programs run under the
+judge time limit.
+"""
+
+import asyncio
+import hashlib
+import json
+import os
+import time
+from collections import OrderedDict
+from typing import Awaitable, Callable, Optional
+
+from compilation_context import CompilationContext
+from judge import JudgeLimits, TimeLimitExceeded, time_limit
+from rate_limit import AdmissionLimits, too_large
+
+# Quiet time after the last edit before a build starts
+DEBOUNCE_SECONDS = float(os.environ.get('LIVE_DEBOUNCE_MS', 150)) / 1000
+# Front-end results kept per session, so undo and redo don't rebuild
+CACHE_ENTRIES = 32
+
+def diagnose_job(source_code: str, context: CompilationContext) -> tuple:
+    """Front end only: (generated code or None, diagnostics payload)"""
+    from main import translate_api
+    generated_code, output, error = translate_api(source_code, context)
+    if error is not None:
+        return None, {"success": False, "error": error["error"], "details": error["details"],
+                      "output": output}
+    return generated_code, {"success": True, "error": None, "details": [], "output": output}
+
+def execute_job(generated_code: str, context: CompilationContext, time_limit_ms: int) -> dict:
+    """Run code generated by diagnose_job, stopping it after time_limit_ms"""
+    from main import execute_api
+    try:
+        with time_limit(time_limit_ms / 1000):
+            return execute_api(generated_code, context)
+    except TimeLimitExceeded:
+        return {"success": False, "error": "Time limit exceeded",
+                "details": [f"The program ran longer than {time_limit_ms} ms"],
+                "output": "", "execution_output": ""}
+
+def apply_changes(source: str, changes: list) -> str:
+    """Apply range replacements, each against the text left by the ones before it"""
+    for change in changes:
+        start, end = int(change['start']), int(change['end'])
+        if not 0 <= start <= end <= len(source):
+            raise ValueError(f"change {start}..{end} is outside the text")
+        source = source[:start] + str(change.get('text', '')) + source[end:]
+    return source
+
+class LiveSession:
+    """One client's live-compile session
+
+    run_job(function, *args) runs a job in the server's worker pool and send
+    delivers a message to the client; both are supplied by the server.
+    max_code_bytes caps the text an edit may leave, and time_limit_ms a run.
+    """
+
+    def __init__(self, run_job: Callable[..., Awaitable], send: Callable[[dict], Awaitable],
+                 debounce: float = DEBOUNCE_SECONDS,
+                 max_code_bytes: int = AdmissionLimits().max_code_bytes,
+                 time_limit_ms: int = JudgeLimits().time_limit_ms):
+        self.run_job = run_job
+        self.send = send
+        self.debounce = debounce
+        self.max_code_bytes = max_code_bytes
+        self.time_limit_ms = time_limit_ms
+        self.context = CompilationContext(filename="live_input.cpp")
+        self.auto_run = False
+        self.source = ""
+        self.version = 0
+        self.build_task: Optional[asyncio.Task] = None
+        self.run_task: Optional[asyncio.Task] = None
+        self.run_version = 0
+        # Held while a job of this session is queued or running in the pool
+        self.job_lock = asyncio.Lock()
+        # source digest -> (generated code, diagnostics)
+        self.cache: 'OrderedDict[bytes, tuple]' = OrderedDict()
+        self.builds = 0
+        self.cancelled = 0
+
+    async def handle(self, text: str):
+        """Process one message from the client"""
+        try:
+            message = json.loads(text)
+            kind = message.get('type')
+            if kind == 'open':
+                self.open(message)
+            elif kind == 'edit':
+                await self.edit(message)
+            elif kind == 'run':
+                self.start_build(run=True, delay=0.0, requested=True)
+            else:
+                await self.send({"type": "error", "error": f"Unknown message type {kind!r}"})
+        except (ValueError, KeyError, TypeError, AttributeError) as e:
+            await self.send({"type": "error", "error": f"Invalid message: {e}"})
+
+    def open(self, message: dict):
+        self.context = CompilationContext.from_request(message, "live_input.cpp")
+        self.auto_run = bool(message.get('auto_run', False))
+
+    async def edit(self, message: dict):
+        if 'code' in message:
+            source = str(message['code'])
+        elif message.get('base') == self.version:
+            source = apply_changes(self.source, message.get('changes', []))
+        else:
+            await self.send({"type": "resync", "version": self.version})
+            return
+        if len(source.encode('utf-8')) > self.max_code_bytes:
+            # The text stays at the last accepted version
+            await self.send(dict(too_large(self.max_code_bytes, "Source code"), type="error",
+                                 version=self.version))
+            return
+        self.source = source
+        self.version = int(message.get('version', self.version + 1))
+        self.start_build(run=self.auto_run, delay=self.debounce)
+
+    def start_build(self, run: bool, delay: float, requested: bool = False):
+        """Start a build of the current source, replacing the build or run it supersedes
+
+        Edits replace builds and runs replace runs, so later edits never
+        cancel a run the user requested, and its result is delivered even if
+        the text has changed since. A run of the version already being run is
+        coalesced with it.
+        """
+        previous = self.run_task if requested else self.build_task
+        if previous is not None and not previous.done():
+            if requested and self.run_version == self.version:
+                return
+            previous.cancel()
+            self.cancelled += 1
+        task = asyncio.ensure_future(self.build(self.version, self.source, run, delay, requested))
+        if requested:
+            self.run_task = task
+            self.run_version = self.version
+        else:
+            self.build_task = task
+
+    async def job(self, function, *args):
+        """run_job(function, *args), one job of this session at a time
+
+        A job cancelled once it has reached the pool still runs to the end in
+        its worker, so the session's slot is held until it does.
+        """
+        async with self.job_lock:
+            job = asyncio.ensure_future(self.run_job(function, *args))
+            try:
+                return await asyncio.shield(job)
+            except asyncio.CancelledError:
+                while not job.done():
+                    try:
+                        await asyncio.wait([job])
+                    except asyncio.CancelledError:
+                        pass
+                raise
+
+    async def build(self, version: int, source: str, run: bool, delay: float, requested: bool = False):
+        if delay:
+            await asyncio.sleep(delay)
+        started = time.perf_counter()
+        key = hashlib.sha256(repr(self.context).encode('utf-8') + source.encode('utf-8')).digest()
+        cached = self.cache.get(key)
+        if cached is not None:
+            self.cache.move_to_end(key)
+            generated_code, diagnostics = cached
+        else:
+            generated_code, diagnostics = await self.job(diagnose_job, source, self.context)
+            self.builds += 1
+            self.cache[key] = (generated_code, diagnostics)
+            if len(self.cache) > CACHE_ENTRIES:
+                self.cache.popitem(last=False)
+        if version != self.version and not requested:
+            return  # superseded while building
+        await self.send(dict(diagnostics, type="diagnostics", version=version,
+                             elapsed_ms=round((time.perf_counter() - started) * 1000, 3)))
+        if run and generated_code is not None:
+            result = await self.job(execute_job, generated_code, self.context, self.time_limit_ms)
+            if version == self.version or requested:
+                await self.send(dict(result, type="result", version=version))
+
+    def close(self):
+        """Cancel outstanding work when the connection ends"""
+        for task in (self.build_task, self.run_task):
+            if task is not None and not task.done():
+                task.cancel()
@@ -0,0 +1,97 @@
+"""
+Bounded Program Output Capture
+A sink for a program's cout output that keeps the first OUTPUT_HEAD_BYTES and
+the last OUTPUT_TAIL_BYTES characters and counts what it drops in between, so
+the memory used by a print-heavy program stays constant. The generated runtime
+support uses it in place of its output list when the host passes it in as
+cpp_output_buffer.
+"""
+
+import os
+from collections import deque
+from typing import Deque, Iterator, List
+
+OUTPUT_HEAD_BYTES = int(os.environ.get('OUTPUT_HEAD_BYTES', 64 * 1024))
+OUTPUT_TAIL_BYTES = int(os.environ.get('OUTPUT_TAIL_BYTES', 64 * 1024))
+
+class HeadTailBuffer:
+    """List-like output buffer keeping a head and a tail of everything appended
+
+    Supports the parts of list the runtime uses (append, clear and iteration
+    by ''.join) and write(), so print(file=...) can write to it too.
+    """
+
+    def __init__(self, head_limit: int = OUTPUT_HEAD_BYTES, tail_limit: int = OUTPUT_TAIL_BYTES):
+        self.head_limit = head_limit
+        self.tail_limit = tail_limit
+        self.clear()
+
+    def clear(self):
+        self.head: List[str] = []
+        self.head_room = self.head_limit
+        self.tail: Deque[str] = deque()
+        self.tail_size = 0
+        self.dropped = 0
+
+    def append(self, text: str):
+        if self.head_room > 0:
+            if len(text) <= self.head_room:
+                self.head.append(text)
+                self.head_room -= len(text)
+                return
+            self.head.append(text[:self.head_room])
+            text = text[self.head_room:]
+            self.head_room = 0
+        self.tail.append(text)
+        self.tail_size += len(text)
+        # Trimming in batches keeps append O(1) amortized; the tail holds at
+        # most twice its limit between trims
+        if self.tail_size > 2 * self.tail_limit:
+            self.trim()
+
+    def write(self, text: str) -> int:
+        self.append(text)
+        return len(text)
+
+    def flush(self):
+        pass
+
+    def trim(self):
+        """Drop the oldest tail output beyond tail_limit"""
+        tail = self.tail
+        while tail and self.tail_size - len(tail[0]) >= self.tail_limit:
+            removed = len(tail.popleft())
+            self.tail_size -= removed
+            self.dropped += removed
+        excess = self.tail_size - self.tail_limit
+        if excess > 0:
+            tail[0] = tail[0][excess:]
+            self.tail_size -= excess
+            self.dropped += excess
+
+    def __iter__(self) -> Iterator[str]:
+        self.trim()
+        yield from self.head
+        if self.dropped:
+            yield f"\n... [{self.dropped} characters of output truncated] ...\n"
+        yield from self.tail
+
+    def getvalue(self) -> str:
+        return ''.join(self)
+
+def output_dropped(exec_globals: dict) -> int:
+    """Characters of output a program run with cpp_output_buffer dropped"""
+    runtime = exec_globals.get('cpp_runtime')
+    buffer = getattr(runtime, 'output_buffer', None)
+    return buffer.dropped if isinstance(buffer, HeadTailBuffer) else 0
+
+def main():
+    """Test the buffer with a small head and tail"""
+    buffer = HeadTailBuffer(head_limit=20, tail_limit=20)
+    for i in range(1000):
+        buffer.append(f"line {i}\n")
+    print(buffer.getvalue())
+    print(f"dropped {buffer.dropped}, kept {len(buffer.getvalue())}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,133 @@
+#include <iostream>
+using namespace std;
+
+// Control flow and object handling that the closure engine implements
+// without generated code: globals written by functions, switch fallthrough
+// with continue and return, methods calling later methods, copies
+
+int calls = 0;
+long checksum = 7;
+
+int classify(int n) {
+    calls++;
+    switch (n % 5) {
+        case 0:
+            return 100;
+        case 1:
+        case 2:
+            n = n * 2;
+        case 3:
+            n = n + 1;
+            break;
+        default:
+            n = -n;
+    }
+    return n;
+}
+
+struct Account {
+    int id;
+    long balance = 50;
+    int history;
+
+    Account() {
+        id = 0;
+        history = 0;
+    }
+    Account(int number) {
+        id = number;
+        history = 0;
+    }
+    Account(int number, long opening) {
+        id = number;
+        balance = opening;
+        history = 1;
+    }
+    void deposit(long amount) {
+        balance = balance + amount;
+        record();
+    }
+    void record() {
+        history++;
+    }
+    long projected(int years) {
+        long value = balance;
+        for (int y = 0; y < years; y++) {
+            value = value + value / 10;
+        }
+        return value;
+    }
+};
+
+struct Pair {
+    Account first;
+    int tag;
+};
+
+Account richer(Account a, Account b) {
+    if (a.balance >= b.balance) {
+        return a;
+    }
+    return b;
+}
+
+int main() {
+    int total = 0;
+    for (int i = 0; i < 30; i++) {
+        if (i % 7 == 6) {
+            continue;
+        }
+        switch (i % 4) {
+            case 0:
+                total = total + classify(i);
+                continue;
+            case 1:
+                total = total - 1;
+            case 2:
+                total = total + 2;
+                break;
+            default:
+                if (i > 25) {
+                    break;
+                }
+                total = total + i;
+        }
+        checksum = checksum * 31 + total;
+    }
+    cout << "total " << total << " calls " << calls << " checksum " << checksum << endl;
+
+    Account a(1);
+    Account b(2, 400);
+    a.deposit(25);
+    a.deposit(5);
+    Account c = richer(a, b);
+    c.deposit(1000);
+    cout << a.id << " " << a.balance << " " << a.history << endl;
+    cout << b.id << " " << b.balance << " " << b.history << endl;
+    cout << c.id << " " << c.balance << " " << c.history << endl;
+    cout << "projected " << b.projected(5) << endl;
+
+    Pair p;
+    p.tag = 3;
+    p.first.deposit(10);
+    Pair q = p;
+    q.first.deposit(90);
+    cout << p.first.balance << " " << q.first.balance << " " << q.tag << endl;
+
+    int k = 10;
+    int post = k++;
+    k++;
+    int pre = k;
+    a.history++;
+    cout << post << " " << pre << " " << k << " " << a.history << endl;
+
+    int countdown = 3;
+    while (true) {
+        countdown--;
+        if (countdown == 0) {
+            break;
+        }
+    }
+    cout << "countdown " << countdown << endl;
+    return total % 256;
+}
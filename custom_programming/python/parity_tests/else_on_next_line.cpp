@@ -0,0 +1,49 @@
+#include <iostream>
+using namespace std;
+
+// else keywords starting their own line, with and without braces
+int sign(int n) {
+    if (n < 0)
+        return -1;
+    else if (n == 0)
+        return 0;
+    else
+        return 1;
+}
+
+int countBig(int limit) {
+    int big = 0;
+    for (int i = 0; i < limit; i++)
+        if (i % 3 == 0)
+            if (i > 4)
+                big++;
+            else
+                big--;
+    return big;
+}
+
+int main() {
+    int x = 7;
+    if (x > 5)
+    {
+        cout << "big" << endl;
+    }
+    else
+    {
+        cout << "small" << endl;
+    }
+
+    if (x % 2 == 0)
+        cout << "even" << endl;
+
+    else
+        cout << "odd" << endl;
+
+    if (x > 100)
+        cout << "huge" << endl;
+    cout << "after" << endl;
+
+    cout << sign(-3) << " " << sign(0) << " " << sign(9) << endl;
+    cout << countBig(13) << endl;
+    return 0;
+}
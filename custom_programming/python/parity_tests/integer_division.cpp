@@ -0,0 +1,43 @@
+#include <iostream>
+using namespace std;
+
+int divide(int a, int b) {
+    return a / b;
+}
+
+int remainder(int a, int b) {
+    return a % b;
+}
+
+int main() {
+    cout << "7 / 2 = " << (7 / 2) << endl;
+    cout << "7 % 2 = " << (7 % 2) << endl;
+    cout << "-7 / 2 = " << divide(-7, 2) << endl;
+    cout << "-7 % 2 = " << remainder(-7, 2) << endl;
+    cout << "7 / -2 = " << divide(7, -2) << endl;
+    cout << "7 % -2 = " << remainder(7, -2) << endl;
+    cout << "-7 / -2 = " << divide(-7, -2) << endl;
+    cout << "-7 % -2 = " << remainder(-7, -2) << endl;
+    
+    int total = 0;
+    for (int i = -10; i <= 10; i++) {
+        int q = i / 3;
+        int r = i % 3;
+        total = total + q * 100 + r;
+    }
+    cout << "Checksum: " << total << endl;
+    
+    // Digits of a number, most significant last
+    int n = 90210;
+    while (n > 0) {
+        cout << (n % 10);
+        n = n / 10;
+    }
+    cout << endl;
+    
+    double half = 7 / 2;
+    double exact = 7.0 / 2;
+    cout << "double from int division: " << half << endl;
+    cout << "double division: " << exact << endl;
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+using namespace std;
+
+long long factorial(int n) {
+    long long result = 1;
+    for (int i = 2; i <= n; i++) {
+        result = result * i;
+    }
+    return result;
+}
+
+int main() {
+    for (int n = 18; n <= 22; n++) {
+        cout << n << "! = " << factorial(n) << endl;
+    }
+    
+    int a = 100000;
+    int b = 100000;
+    long product = a * b;
+    long widened = a;
+    long exact = widened * b;
+    cout << "int product: " << product << endl;
+    cout << "long product: " << exact << endl;
+    
+    long big = 9223372036854775807L;
+    long wrapped = big + 1;
+    cout << "LONG_MAX + 1 = " << wrapped << endl;
+    
+    long large = 4294967298L;
+    int narrowed = large;
+    cout << "narrowed: " << narrowed << endl;
+    
+    long long fib = 0;
+    long long next = 1;
+    for (int i = 0; i < 90; i++) {
+        long long sum = fib + next;
+        fib = next;
+        next = sum;
+    }
+    cout << "fib(90) = " << fib << endl;
+    cout << "-7L / 2 = " << (-7L / 2) << ", -7L % 2 = " << (-7L % 2) << endl;
+    return 0;
+}
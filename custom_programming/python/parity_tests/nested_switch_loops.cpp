@@ -0,0 +1,66 @@
+#include <iostream>
+using namespace std;
+
+// A continue or return in a switch inside a loop inside a case of another
+// switch: the continue stays in the loop, the return leaves the function
+
+int continues(int rounds) {
+    int total = 0;
+    for (int a = 0; a < rounds; a++) {
+        switch (a) {
+            case 0:
+                for (int j = 0; j < 4; j++) {
+                    switch (j) {
+                        case 1: continue;
+                        default: total = total + 10;
+                    }
+                    total = total + 1;
+                }
+                break;
+            default:
+                total = total + 100;
+        }
+    }
+    return total;
+}
+
+int firstMatch(int mode, int target) {
+    switch (mode) {
+        case 1:
+            for (int i = 0; i < 10; i++) {
+                switch (i % 3) {
+                    case 0: continue;
+                    case 1:
+                        if (i == target) {
+                            return i * 100;
+                        }
+                        break;
+                    default: break;
+                }
+            }
+            return -1;
+        default:
+            return -2;
+    }
+}
+
+int main() {
+    cout << "continues: " << continues(2) << " " << continues(1) << endl;
+    cout << "first match: " << firstMatch(1, 4) << " " << firstMatch(1, 5) << " " << firstMatch(2, 4) << endl;
+
+    int mode = 1;
+    int total = 0;
+    switch (mode) {
+        case 1:
+            for (int i = 0; i < 5; i++) {
+                switch (i) {
+                    case 2: continue;
+                    default: total = total + 1;
+                }
+                total = total + 10;
+            }
+            break;
+    }
+    cout << "in main: " << total << endl;
+    return 0;
+}
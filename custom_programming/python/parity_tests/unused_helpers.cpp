@@ -0,0 +1,50 @@
+#include <iostream>
+using namespace std;
+
+// Only some of these functions are reachable from main; the rest are
+// left out of the generated code
+
+int seed() {
+    return 42;
+}
+
+int base = seed();
+
+int square(int x) {
+    return x * x;
+}
+
+int fib(int n) {
+    if (n < 2) {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+int neverCalled(int x) {
+    return fib(x) + square(x);
+}
+
+int alsoUnused() {
+    return neverCalled(3);
+}
+
+int scaled(int x) {
+    return x * 10;
+}
+
+struct Meter {
+    int value;
+    int reading() {
+        return scaled(value);
+    }
+};
+
+int main() {
+    Meter meter;
+    meter.value = 7;
+    cout << "Base: " << base << endl;
+    cout << "Fib(15): " << fib(15) << endl;
+    cout << "Reading: " << meter.reading() << endl;
+    return 0;
+}
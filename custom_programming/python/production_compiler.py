@@ -0,0 +1,311 @@
+"""
+Production C++ Compiler
+A simple wrapper for the C++ compiler components for production use
+"""
+
+import sys
+import os
+import tempfile
+import subprocess
+from pathlib import Path
+from typing import Tuple, Optional, List, NamedTuple
+
+# Import existing compiler modules
+from lexer import Lexer, Token, TokenType
+from parser import Parser
+from semantic_analyzer import SemanticAnalyzer
+from code_generator import CodeGenerator
+from intrinsics import lookup_intrinsic
+
+# Engines, cheapest first: the in-process pipeline has no compile/link step
+ENGINE_CUSTOM = "custom"
+ENGINE_GPP = "g++"
+
+# Headers whose facilities the custom pipeline implements
+CUSTOM_HEADERS = {'iostream', 'cmath'}
+
+# Keyword tokens for features the custom pipeline doesn't implement
+UNSUPPORTED_KEYWORDS = {
+    TokenType.NEW: 'new',
+    TokenType.DELETE: 'delete',
+    TokenType.AUTO: 'auto',
+    TokenType.ENUM: 'enum',
+    TokenType.DO: 'do-while',
+    TokenType.NULLPTR: 'nullptr',
+    TokenType.SHORT: 'short',
+    TokenType.UNSIGNED: 'unsigned',
+    TokenType.SIGNED: 'signed',
+    TokenType.STD_STRING: 'std::string',
+}
+
+# C++ keywords and library names the lexer reads as plain identifiers
+UNSUPPORTED_IDENTIFIERS = {
+    'template', 'typename', 'try', 'catch', 'throw', 'operator', 'virtual',
+    'static', 'typedef', 'goto', 'sizeof', 'friend', 'static_cast',
+    'dynamic_cast', 'reinterpret_cast', 'const_cast', 'string', 'vector',
+}
+
+# Standard library names the custom pipeline provides under std::, besides the
+# <cmath> functions in intrinsics.py
+CUSTOM_STD_NAMES = {'std::cout', 'std::endl', 'std::cin'}
+
+# Error prefixes of the custom pipeline's compile phases (as opposed to runtime errors)
+CUSTOM_COMPILE_ERRORS = ("Compilation failed", "Semantic errors")
+
+COMPOUND_OPERATORS = {TokenType.PLUS, TokenType.MINUS, TokenType.MULTIPLY,
+                      TokenType.DIVIDE, TokenType.MODULO}
+
+class RoutingDecision(NamedTuple):
+    engine: str
+    reason: str
+    features: List[str]  # constructs that rule out the custom pipeline
+
+def scan_features(tokens: List[Token]) -> List[str]:
+    """Single pass over the token stream listing constructs the custom pipeline lacks"""
+    features = []
+    
+    def note(feature: str):
+        if feature not in features:
+            features.append(feature)
+    
+    previous = None
+    for i, token in enumerate(tokens):
+        kind = token.type
+        if kind == TokenType.HASH:
+            directive = tokens[i + 1] if i + 1 < len(tokens) else token
+            if directive.type != TokenType.INCLUDE:
+                note(f"#{directive.value}")
+            else:
+                header = []
+                for t in tokens[i + 2:]:
+                    if t.type in (TokenType.NEWLINE, TokenType.EOF) or t.type == TokenType.GREATER_THAN:
+                        break
+                    if t.type != TokenType.LESS_THAN:
+                        header.append(t.value)
+                name = ''.join(header).strip('"')
+                if name and name.split('.')[0] not in CUSTOM_HEADERS:
+                    note(f"#include <{name}>")
+        elif kind in UNSUPPORTED_KEYWORDS:
+            note(UNSUPPORTED_KEYWORDS[kind])
+        elif kind == TokenType.IDENTIFIER:
+            if token.value in UNSUPPORTED_IDENTIFIERS:
+                note(token.value)
+            elif (token.value.startswith('std::') and token.value not in CUSTOM_STD_NAMES
+                  and lookup_intrinsic(token.value) is None):
+                note(token.value)
+        elif kind == TokenType.NAMESPACE and (previous is None or previous.type != TokenType.USING):
+            note('namespace')
+        elif kind == TokenType.LEFT_BRACKET:
+            note('arrays')
+        elif kind == TokenType.SCOPE_RESOLUTION:
+            note('::')
+        elif kind == TokenType.UNKNOWN and token.value != '~':
+            note(f"operator {token.value}")
+        elif (kind == TokenType.ASSIGN and previous is not None and previous.type in COMPOUND_OPERATORS
+              and previous.line == token.line and previous.column + 1 == token.column):
+            note(f"{previous.value}=")
+        previous = token
+    return features
+
+class ProductionCppCompiler:
+    """Production C++ Compiler wrapper"""
+    
+    def __init__(self):
+        self.cpp_standard = "c++17"
+        self.optimization = "-O2"
+        self.flags = ["-Wall", "-Wextra"]
+        self.gpp_available = False
+        self.gpp_path = self.find_gpp()
+    
+    def find_gpp(self) -> str:
+        """Find g++ compiler path"""
+        # Try common paths for g++
+        paths = ["g++", "c++", "/usr/bin/g++", "/usr/local/bin/g++"]
+        
+        for path in paths:
+            try:
+                result = subprocess.run([path, "--version"], 
+                                      capture_output=True, text=True, timeout=5)
+                if result.returncode == 0:
+                    self.gpp_available = True
+                    return path
+            except:
+                continue
+        
+        # If no g++ found, we'll simulate compilation
+        return "g++"
+    
+    def set_cpp_standard(self, standard: str):
+        """Set C++ standard"""
+        self.cpp_standard = standard
+    
+    def set_optimization(self, optimization: str):
+        """Set optimization level"""
+        self.optimization = optimization
+    
+    def add_compiler_flag(self, flag: str):
+        """Add compiler flag"""
+        if flag not in self.flags:
+            self.flags.append(flag)
+    
+    def compile_source_string(self, source_code: str, filename: str = "main.cpp", 
+                            run_after_compile: bool = True) -> Tuple[bool, str, str]:
+        """
+        Compile C++ source code string
+        
+        Returns:
+            Tuple of (success, output, error)
+        """
+        result = self.compile_program(source_code, filename, run_after_compile)
+        return result["success"], result["output"], result["error"]
+    
+    def compile_program(self, source_code: str, filename: str = "main.cpp",
+                        run_after_compile: bool = True) -> dict:
+        """
+        Compile (and run) a program on the cheapest engine that supports it
+        
+        Returns:
+            Dict with success, output, error, and the engine that ran the
+            program with the reason it was chosen
+        """
+        try:
+            tokens = Lexer(source_code).tokenize()
+            decision = self.route(tokens)
+            if decision.engine == ENGINE_CUSTOM:
+                success, output, error = self._compile_with_custom_compiler(
+                    source_code, filename, run_after_compile, tokens)
+                if not success and error.startswith(CUSTOM_COMPILE_ERRORS) and self.gpp_available:
+                    # The prescan can't see every unsupported construct
+                    decision = RoutingDecision(ENGINE_GPP, f"custom pipeline rejected the program ({error})",
+                                               decision.features)
+            if decision.engine == ENGINE_GPP:
+                success, output, error = self._compile_with_real_gpp(source_code, filename, run_after_compile)
+        except Exception as e:
+            return self.response(False, "", f"Compilation error: {str(e)}", None)
+        return self.response(success, output, error, decision)
+    
+    def response(self, success: bool, output: str, error: str, decision: Optional[RoutingDecision]) -> dict:
+        """Build the result of compile_program"""
+        return {
+            "success": success,
+            "output": output,
+            "error": error,
+            "engine": decision.engine if decision else None,
+            "routing_reason": decision.reason if decision else None,
+            "detected_features": decision.features if decision else [],
+        }
+    
+    def route(self, tokens: List[Token]) -> RoutingDecision:
+        """Pick an engine from the features the program uses"""
+        features = scan_features(tokens)
+        if not features:
+            return RoutingDecision(ENGINE_CUSTOM, "only uses features the custom pipeline implements", [])
+        listed = ", ".join(features[:5]) + (", ..." if len(features) > 5 else "")
+        if not self.gpp_available:
+            return RoutingDecision(ENGINE_CUSTOM, f"g++ is unavailable; program uses {listed}", features)
+        return RoutingDecision(ENGINE_GPP, f"uses {listed}", features)
+    
+    def _compile_with_custom_compiler(self, source_code: str, filename: str, 
+                                    run_after_compile: bool,
+                                    tokens: Optional[List[Token]] = None) -> Tuple[bool, str, str]:
+        """Compile using our custom compiler pipeline (tokens: already lexed source)"""
+        try:
+            # Phase 1: Lexical Analysis
+            if tokens is None:
+                lexer = Lexer(source_code)
+                tokens = lexer.tokenize()
+            
+            # Phase 2: Syntax Analysis
+            parser = Parser(tokens)
+            ast = parser.parse()
+            
+            # Phase 3: Semantic Analysis
+            analyzer = SemanticAnalyzer()
+            if not analyzer.analyze(ast):
+                error_msg = "Semantic errors:\n" + "\n".join(analyzer.errors)
+                return False, "", error_msg
+            
+            # Phase 4: Code Generation
+            generator = CodeGenerator(analyzer)
+            generated_code = compile(generator.generate(ast), filename, 'exec')
+        except Exception as e:
+            return False, "", f"Compilation failed: {str(e)}"
+        
+        try:
+            # Phase 5: Execution (if requested)
+            output = ""
+            if run_after_compile:
+                # Capture output by redirecting stdout
+                import io
+                from contextlib import redirect_stdout, redirect_stderr
+                
+                stdout_capture = io.StringIO()
+                stderr_capture = io.StringIO()
+                
+                try:
+                    with redirect_stdout(stdout_capture), redirect_stderr(stderr_capture):
+                        exec_globals = {
+                            '__name__': '__main__',
+                            '__builtins__': __builtins__,
+                        }
+                        exec(generated_code, exec_globals)
+                except SystemExit:
+                    # This is expected - programs call sys.exit()
+                    pass
+                except Exception as e:
+                    return False, "", f"Runtime error: {str(e)}"
+                
+                output = stdout_capture.getvalue()
+                stderr_output = stderr_capture.getvalue()
+                
+                if stderr_output:
+                    output += f"\nStderr: {stderr_output}"
+            
+            return True, output, ""
+            
+        except Exception as e:
+            return False, "", f"Runtime error: {str(e)}"
+    
+    def _compile_with_real_gpp(self, source_code: str, filename: str, 
+                             run_after_compile: bool) -> Tuple[bool, str, str]:
+        """Fallback: compile with real g++ if available"""
+        try:
+            # Create temporary files
+            with tempfile.TemporaryDirectory() as temp_dir:
+                source_file = Path(temp_dir) / filename
+                exe_file = Path(temp_dir) / "program"
+                
+                # Write source code to file
+                source_file.write_text(source_code, encoding='utf-8')
+                
+                # Build compile command
+                cmd = [
+                    self.gpp_path,
+                    f"-std={self.cpp_standard}",
+                    self.optimization,
+                    *self.flags,
+                    str(source_file),
+                    "-o", str(exe_file)
+                ]
+                
+                # Compile
+                result = subprocess.run(cmd, capture_output=True, text=True, timeout=30)
+                
+                if result.returncode != 0:
+                    return False, "", result.stderr
+                
+                # Run if requested
+                output = ""
+                if run_after_compile and exe_file.exists():
+                    run_result = subprocess.run([str(exe_file)], 
+                                              capture_output=True, text=True, timeout=10)
+                    output = run_result.stdout
+                    if run_result.stderr:
+                        output += f"\nStderr: {run_result.stderr}"
+                
+                return True, output, ""
+                
+        except subprocess.TimeoutExpired:
+            return False, "", "Compilation or execution timed out"
+        except Exception as e:
+            return False, "", f"Error: {str(e)}"
\ No newline at end of file
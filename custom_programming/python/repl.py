@@ -0,0 +1,246 @@
+"""
+C++ Interactive Session
+This module implements the incremental REPL: each entry is lexed, parsed, analyzed
+and generated on its own against one persistent symbol table and execution
+namespace, so functions, classes and globals carry over between entries.
+"""
+
+import re
+from typing import List, Optional, Tuple
+from lexer import Lexer, Token, TokenType
+from parser import *
+from semantic_analyzer import SemanticAnalyzer, SemanticError
+from code_generator import CodeGenerator
+
+class ReplError(Exception):
+    """An entry that failed; output holds anything it printed before failing"""
+    def __init__(self, message: str, details: Optional[List[str]] = None, output: str = ""):
+        super().__init__(message)
+        self.details = details or []
+        self.output = output
+
+OPENERS = (TokenType.LEFT_PAREN, TokenType.LEFT_BRACKET, TokenType.LEFT_BRACE)
+CLOSERS = (TokenType.RIGHT_PAREN, TokenType.RIGHT_BRACKET, TokenType.RIGHT_BRACE)
+# Tokens after a closing brace that continue the same declaration: struct S {...} s;
+DECLARATION_TAIL = (TokenType.SEMICOLON, TokenType.COMMA, TokenType.IDENTIFIER)
+ELSE_LINE = re.compile(r'\s*else\b')
+
+def past_brackets(tokens: List[Token], i: int) -> int:
+    """Index past the bracketed group opening at tokens[i]; i if no group opens there"""
+    if i >= len(tokens) or tokens[i].type not in OPENERS:
+        return i
+    depth = 0
+    while i < len(tokens):
+        if tokens[i].type in OPENERS:
+            depth += 1
+        elif tokens[i].type in CLOSERS:
+            depth -= 1
+            if depth == 0:
+                return i + 1
+        i += 1
+    return i
+
+def statement_end(tokens: List[Token], i: int) -> Tuple[int, bool]:
+    """Index past the statement at tokens[i], and whether it ends with an if that has no else"""
+    if i >= len(tokens):
+        return i, False
+    kind = tokens[i].type
+    if kind == TokenType.IF:
+        i, _ = statement_end(tokens, past_brackets(tokens, i + 1))
+        if i < len(tokens) and tokens[i].type == TokenType.ELSE:
+            return statement_end(tokens, i + 1)
+        return i, True
+    if kind in (TokenType.FOR, TokenType.WHILE):
+        # An else after the body belongs to an if ending it
+        return statement_end(tokens, past_brackets(tokens, i + 1))
+    if kind == TokenType.LEFT_BRACE:
+        return past_brackets(tokens, i), False
+    if kind == TokenType.DO:
+        i, _ = statement_end(tokens, i + 1)
+    # Declarations and expressions end at a ; or, like function definitions, at their body
+    depth = 0
+    while i < len(tokens):
+        kind = tokens[i].type
+        i += 1
+        if kind in OPENERS:
+            depth += 1
+        elif kind in CLOSERS:
+            depth -= 1
+            if (depth == 0 and kind == TokenType.RIGHT_BRACE
+                    and (i == len(tokens) or tokens[i].type not in DECLARATION_TAIL)):
+                return i, False
+        elif kind == TokenType.SEMICOLON and depth == 0:
+            return i, False
+    return i, False
+
+def ends_with_open_if(source_code: str) -> bool:
+    """Whether the last statement of source_code ends with an if statement that has no else"""
+    tokens = []
+    directive = False
+    for token in Lexer(source_code).tokenize():
+        if token.type == TokenType.HASH:
+            directive = True
+        elif token.type == TokenType.NEWLINE:
+            directive = False
+        elif not directive and token.type != TokenType.EOF:
+            tokens.append(token)
+    i, open_if = 0, False
+    while i < len(tokens):
+        i, open_if = statement_end(tokens, i)
+    return open_if
+
+class ReplSession:
+    """Persistent compiler state for a sequence of interactive entries"""
+
+    def __init__(self):
+        self.analyzer = SemanticAnalyzer()
+        self.generator = CodeGenerator(self.analyzer)
+        # Class/struct names declared so far, seeded into each entry's parser
+        self.user_types = set()
+        self.entry_count = 0
+
+        # Artifacts of the last entry, for TOKENS/AST/CODE display
+        self.last_tokens = []
+        self.last_items = []
+        self.last_code = ""
+
+        # cin reads an empty input; the session's own input is the entries
+        self.namespace = {'__name__': '__cpp_repl__', '__builtins__': __builtins__, 'cpp_stdin': ''}
+        exec(self.generator.generate_runtime(), self.namespace)
+        self.runtime = self.namespace['cpp_runtime']
+
+    def is_complete(self, source_code: str) -> bool:
+        """Check whether an entry is ready to run: closed, and not waiting for an else"""
+        return self.is_closed(source_code) and not ends_with_open_if(source_code)
+
+    def awaits_else(self, source_code: str) -> bool:
+        """Whether an entry is closed but ends with an if that an else on the next line would continue"""
+        return self.is_closed(source_code) and ends_with_open_if(source_code)
+
+    def continues_if(self, line: str) -> bool:
+        """Whether a line continues an entry that awaits_else"""
+        return ELSE_LINE.match(line) is not None
+
+    def is_closed(self, source_code: str) -> bool:
+        """Check whether brackets are balanced and the entry ends with a ; or }"""
+        depth = 0
+        last = ''
+        quote = None
+        i = 0
+        while i < len(source_code):
+            char = source_code[i]
+            if quote:
+                if char == '\\':
+                    i += 1
+                elif char == quote:
+                    quote = None
+            elif char in '"\'':
+                quote = char
+            elif source_code.startswith('//', i):
+                newline = source_code.find('\n', i)
+                i = len(source_code) if newline < 0 else newline
+                continue
+            elif source_code.startswith('/*', i):
+                end = source_code.find('*/', i + 2)
+                if end < 0:
+                    return False  # still inside the comment
+                i = end + 2
+                continue
+            elif char in '({':
+                depth += 1
+            elif char in ')}':
+                depth -= 1
+            if not char.isspace():
+                last = char
+            i += 1
+        lines = source_code.strip().splitlines()
+        if lines and lines[-1].lstrip().startswith('#'):
+            return depth <= 0
+        return depth <= 0 and quote is None and last in (';', '}')
+
+    def execute(self, source_code: str) -> str:
+        """Compile and run one entry, returning what it printed"""
+        self.last_tokens = Lexer(source_code).tokenize()
+        parser = Parser(self.last_tokens)
+        parser.user_types |= self.user_types
+        try:
+            items = parser.parse_entry()
+        except SyntaxError as e:
+            raise ReplError(f"Syntax Error: {e}")
+        self.last_items = items
+
+        self.analyze(items)
+        self.user_types |= parser.user_types
+        self.last_code = self.generator.generate_entry(items)
+
+        self.entry_count += 1
+        try:
+            exec(compile(self.last_code, f"<entry {self.entry_count}>", "exec"), self.namespace)
+            # A complete program typed in one go runs as soon as main is defined
+            if any(isinstance(item, FunctionDeclaration) and item.name == 'main' for item in items):
+                self.namespace['main']()
+        except SystemExit:
+            pass  # main returned
+        except Exception as e:
+            raise ReplError(f"Runtime Error: {e}", output=self.flush_output())
+        return self.flush_output()
+
+    def analyze(self, items: List[Statement]):
+        """Check an entry in the global scope; on error, undo everything it declared"""
+        analyzer = self.analyzer
+        scope = analyzer.global_scope
+        saved_symbols = dict(scope.symbols)
+        saved_types = (set(analyzer.user_types), dict(analyzer.classes), dict(analyzer.class_scopes))
+        error_count = len(analyzer.errors)
+
+        try:
+            for item in items:
+                if isinstance(item, FunctionDeclaration):
+                    # Entering a function again replaces the old definition
+                    existing = scope.symbols.get(item.name)
+                    if existing and existing.symbol_type == 'function':
+                        del scope.symbols[item.name]
+                    analyzer.visit_declaration(item)
+                elif isinstance(item, (IncludeDirective, UsingNamespace, ClassDeclaration)):
+                    analyzer.visit_declaration(item)
+                else:
+                    analyzer.visit_statement(item)
+        except SemanticError as e:
+            analyzer.error(str(e))
+
+        errors = analyzer.errors[error_count:]
+        if errors:
+            del analyzer.errors[error_count:]
+            scope.symbols = saved_symbols
+            analyzer.user_types, analyzer.classes, analyzer.class_scopes = saved_types
+            analyzer.current_scope = scope
+            analyzer.scope_stack = [scope]
+            analyzer.current_function = None
+            analyzer.loop_depth = analyzer.switch_depth = 0
+            raise ReplError("Compilation failed with semantic errors:", errors)
+
+    def flush_output(self) -> str:
+        """Take the program output buffered since the last entry"""
+        output = self.runtime.get_output()
+        self.runtime.output_buffer.clear()
+        return output
+
+def main():
+    """Test the interactive session"""
+    session = ReplSession()
+    entries = [
+        "#include <iostream>",
+        "using namespace std;",
+        "int total = 0;",
+        "int square(int x) { return x * x; }",
+        "for (int i = 1; i <= 4; i++) { total = total + square(i); }",
+        'cout << "total = " << total << endl;',
+        "int square(int x) { return x * x * x; }",
+        'cout << "cubed: " << square(3) << endl;',
+    ]
+    for entry in entries:
+        print(f"cpp> {entry}")
+        print(session.execute(entry), end='')
+
+if __name__ == "__main__":
+    main()
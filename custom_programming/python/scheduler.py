@@ -0,0 +1,268 @@
+"""
+Fair-Share Compile Scheduler
+Decides which waiting compile request gets the next free worker. Requests
+belong to a class (interactive, examples or batch); each class has its own
+queue, a weight and a concurrency limit. A deficit round robin over the class
+queues hands out free slots in proportion to the weights, and the limits keep
+a batch flood from occupying every worker, so interactive users wait behind at
+most a few batch jobs instead of the whole flood. Speculative pre-compiles never
+queue at all: they take a slot only when one is idle and nothing is waiting.
+
+The scheduler only grants slots; callers run the work themselves, from threads
+(acquire) or from an event loop (acquire_async), and release the slot after.
+"""
+
+import asyncio
+import itertools
+import math
+import os
+import threading
+import time
+from collections import deque
+from typing import Callable, Deque, Dict, NamedTuple, Optional
+
+from readiness import RequestStats
+
+INTERACTIVE = 'interactive'
+EXAMPLES = 'examples'
+BATCH = 'batch'
+REQUEST_CLASSES = (INTERACTIVE, EXAMPLES, BATCH)
+# Pre-compiles while the user is idle; granted only through try_acquire
+SPECULATIVE = 'speculative'
+
+class ClassPolicy(NamedTuple):
+    """Scheduling parameters of a request class"""
+    weight: int            # slots granted per round while the class has waiting requests
+    max_concurrency: int   # most requests of the class running at once
+
+def default_policies(capacity: int) -> Dict[str, ClassPolicy]:
+    """Class policies for a pool of `capacity` workers
+
+    Interactive requests may use every worker; examples and batch requests at
+    most half of them, and speculative pre-compiles a quarter. SCHEDULER_LIMITS
+    (e.g. "batch=1,examples=2") overrides the limits.
+    """
+    half = max(1, math.ceil(capacity / 2))
+    policies = {
+        INTERACTIVE: ClassPolicy(weight=4, max_concurrency=capacity),
+        EXAMPLES: ClassPolicy(weight=2, max_concurrency=half),
+        BATCH: ClassPolicy(weight=1, max_concurrency=half),
+        SPECULATIVE: ClassPolicy(weight=1, max_concurrency=max(1, capacity // 4)),
+    }
+    for item in filter(None, os.environ.get('SCHEDULER_LIMITS', '').split(',')):
+        name, _, limit = item.partition('=')
+        name = name.strip()
+        if name in policies:
+            policies[name] = policies[name]._replace(max_concurrency=max(1, int(limit)))
+    return policies
+
+def request_class(data: dict, headers, assigned: str = INTERACTIVE, api_client: bool = False) -> str:
+    """Class of a request as decided by the server
+
+    The endpoint assigns the class (batch for /judge) and clients with a known
+    API token always run as batch. The client's "request_class" field or
+    X-Request-Class header is honoured only when it lowers the priority, so no
+    client can move itself ahead of interactive users.
+    """
+    assigned = BATCH if api_client else assigned
+    name = data.get('request_class') or headers.get('X-Request-Class') or headers.get('x-request-class')
+    name = str(name).strip().lower() if name else assigned
+    # REQUEST_CLASSES is ordered from highest to lowest priority
+    if name in REQUEST_CLASSES and REQUEST_CLASSES.index(name) > REQUEST_CLASSES.index(assigned):
+        return name
+    return assigned
+
+class Ticket:
+    """One request's place in the scheduler"""
+    __slots__ = ('request_class', 'sequence', 'wake', 'granted', 'token', 'submitted')
+
+    def __init__(self, request_class: str, sequence: int, wake: Callable[[], None]):
+        self.request_class = request_class
+        self.sequence = sequence
+        self.wake = wake
+        self.granted = False
+        self.token = None
+        self.submitted = time.monotonic()
+
+class ClassState:
+    """Queue, counters and latency statistics of one request class"""
+
+    def __init__(self, policy: ClassPolicy):
+        self.policy = policy
+        self.queue: Deque[Ticket] = deque()
+        self.running = 0
+        self.deficit = 0
+        self.granted = 0
+        # Queue wait from submission to grant, latency and busy time from grant to release
+        self.stats = RequestStats(policy.max_concurrency)
+        self.wait_total = 0.0
+
+    def can_run(self) -> bool:
+        return bool(self.queue) and self.running < self.policy.max_concurrency
+
+class FairScheduler:
+    """Deficit-round-robin scheduler over request classes for `capacity` workers
+
+    policy='fifo' ignores weights and class limits and grants slots in arrival
+    order, for comparison with a plain shared queue.
+    """
+
+    def __init__(self, capacity: int, policies: Optional[Dict[str, ClassPolicy]] = None,
+                 policy: str = 'drr'):
+        self.capacity = max(1, capacity)
+        self.policy = policy
+        self.classes = {name: ClassState(class_policy) for name, class_policy in
+                        (policies or default_policies(self.capacity)).items()}
+        self.order = list(self.classes)
+        self.turn = 0
+        self.running = 0
+        self.lock = threading.Lock()
+        self.sequence = itertools.count()
+
+    def submit(self, request_class: str, wake: Callable[[], None]) -> Ticket:
+        """Queue a request; wake() is called, outside the lock, once it holds a slot"""
+        state = self.classes.get(request_class) or self.classes[INTERACTIVE]
+        ticket = Ticket(request_class if request_class in self.classes else INTERACTIVE,
+                        next(self.sequence), wake)
+        ticket.token = state.stats.queued()
+        with self.lock:
+            state.queue.append(ticket)
+            granted = self.dispatch()
+        self.notify(granted)
+        return ticket
+
+    def try_acquire(self, request_class: str) -> Optional[Ticket]:
+        """A granted ticket if a slot is free and no request is waiting, else None
+
+        For work nobody is waiting on yet: it runs only on otherwise idle workers.
+        """
+        state = self.classes[request_class]
+        with self.lock:
+            if (self.running >= self.capacity or state.running >= state.policy.max_concurrency
+                    or any(other.queue for other in self.classes.values())):
+                return None
+            ticket = Ticket(request_class, next(self.sequence), lambda: None)
+            ticket.granted = True
+            state.running += 1
+            state.granted += 1
+            self.running += 1
+        ticket.token = state.stats.start()
+        return ticket
+
+    def release(self, ticket: Ticket, success: bool = True):
+        """Give back a granted slot, or withdraw a request that is still queued"""
+        state = self.classes[ticket.request_class]
+        with self.lock:
+            if ticket.granted:
+                state.running -= 1
+                self.running -= 1
+            else:
+                try:
+                    state.queue.remove(ticket)
+                except ValueError:
+                    pass
+            granted = self.dispatch()
+        if ticket.granted:
+            state.stats.finish(ticket.token, success)
+        else:
+            state.stats.dequeued(ticket.token)
+        self.notify(granted)
+
+    def dispatch(self) -> list:
+        """Grant free slots to waiting requests; called with the lock held"""
+        granted = []
+        now = time.monotonic()
+        while self.running < self.capacity:
+            if self.policy == 'fifo':
+                waiting = [state for state in self.classes.values() if state.queue]
+                if not waiting:
+                    break
+                state = min(waiting, key=lambda s: s.queue[0].sequence)
+            else:
+                if not any(state.can_run() for state in self.classes.values()):
+                    break
+                state = self.classes[self.order[self.turn]]
+                if not state.can_run():
+                    # Classes don't bank credit while idle or at their limit
+                    state.deficit = 0
+                    self.turn = (self.turn + 1) % len(self.order)
+                    continue
+                if state.deficit < 1:
+                    state.deficit += state.policy.weight
+                state.deficit -= 1
+                if state.deficit < 1:
+                    self.turn = (self.turn + 1) % len(self.order)
+            ticket = state.queue.popleft()
+            ticket.granted = True
+            state.running += 1
+            state.granted += 1
+            state.wait_total += now - ticket.submitted
+            state.stats.dequeued(ticket.token)
+            ticket.token = state.stats.start()
+            self.running += 1
+            granted.append(ticket)
+        return granted
+
+    def notify(self, granted: list):
+        for ticket in granted:
+            ticket.wake()
+
+    def acquire(self, request_class: str) -> Ticket:
+        """Block the calling thread until the request holds a slot"""
+        event = threading.Event()
+        ticket = self.submit(request_class, event.set)
+        event.wait()
+        return ticket
+
+    async def acquire_async(self, request_class: str) -> Ticket:
+        """Wait in the event loop until the request holds a slot"""
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+
+        def wake():
+            loop.call_soon_threadsafe(lambda: future.done() or future.set_result(None))
+
+        ticket = self.submit(request_class, wake)
+        try:
+            await future
+        except asyncio.CancelledError:
+            self.release(ticket, success=False)
+            raise
+        return ticket
+
+    def snapshot(self) -> dict:
+        """Per-class queue lengths, running requests and latency over the window"""
+        classes = {}
+        for name, state in self.classes.items():
+            stats = state.stats.snapshot()
+            classes[name] = {
+                "weight": state.policy.weight,
+                "max_concurrency": state.policy.max_concurrency,
+                "queued": len(state.queue),
+                "running": state.running,
+                "granted": state.granted,
+                "mean_wait_ms": round(state.wait_total / state.granted * 1000, 3) if state.granted else None,
+                "requests": stats["requests"],
+                "latency_ms": stats["latency_ms"],
+            }
+        return {"policy": self.policy, "capacity": self.capacity, "running": self.running,
+                "classes": classes}
+
+def main():
+    """Test the scheduler: one worker, a batch flood and a few interactive requests"""
+    scheduler = FairScheduler(capacity=1)
+    order = []
+    tickets = []
+    for i in range(6):
+        tickets.append(scheduler.submit(BATCH, lambda i=i: order.append(f"batch{i}")))
+    for i in range(3):
+        tickets.append(scheduler.submit(INTERACTIVE, lambda i=i: order.append(f"interactive{i}")))
+    while scheduler.running:
+        running = next(t for t in tickets if t.granted)
+        tickets.remove(running)
+        scheduler.release(running)
+    print(" -> ".join(order))
+    print(scheduler.snapshot())
+
+if __name__ == "__main__":
+    main()
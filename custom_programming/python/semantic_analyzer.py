@@ -6,6 +6,10 @@ and scope resolution.
 
 from typing import Dict, List, Optional, Any, Union
 from parser import *
+from compilation_context import CompilationContext, DEFAULT_CONTEXT
+from visitor import Visitor, handles
+from call_graph import CallGraph
+from intrinsics import Intrinsic, lookup_intrinsic
 
 class Symbol:
     """Represents a symbol in the symbol table"""
@@ -48,28 +52,58 @@ class SemanticError(Exception):
     """Exception raised for semantic errors"""
     pass
 
-class SemanticAnalyzer:
+class SemanticAnalyzer(Visitor):
     """Performs semantic analysis on the AST"""
     
-    def __init__(self):
+    arithmetic_types = ('int', 'long', 'float', 'double')
+    # Types a condition accepts: cin >> x tests whether the read succeeded
+    condition_types = ('bool', 'int', 'long', 'istream')
+    # Types cin >> reads
+    extractable_types = ('bool', 'int', 'long', 'float', 'double')
+    
+    def __init__(self, context: Optional[CompilationContext] = None):
+        self.context = context or DEFAULT_CONTEXT
         self.global_scope = Scope("global")
         self.current_scope = self.global_scope
         self.scope_stack = [self.global_scope]
         self.current_function = None
         self.errors = []
         
+        # Enclosing loops/switches, for validating break and continue
+        self.loop_depth = 0
+        self.switch_depth = 0
+        
         # Built-in types
         self.built_in_types = {
-            'int', 'float', 'double', 'char', 'bool', 'void', 'string'
+            'int', 'long', 'float', 'double', 'char', 'bool', 'void', 'string'
         }
         # Track user-defined class/struct types
         self.user_types = set()
+        self.classes: Dict[str, ClassDeclaration] = {}
+        self.class_scopes: Dict[str, Scope] = {}
+        
+        # Class-typed lvalue expressions that must be copied where they are
+        # used (C++ value semantics); read by the code generator
+        self.value_copies = set()
+        
+        # With fast_analysis, the functions main can't reach and whose
+        # bodies were therefore not analyzed
+        self.call_graph: Optional[CallGraph] = None
+        self.skipped_functions: List[str] = []
+        
+        # Expression types are recorded on the nodes themselves (static_type
+        # and converted_type), in the same pass that checks them; the code
+        # generator reads them to lower arithmetic the way C++ evaluates it
         
         # Type compatibility rules
         self.type_compatibility = {
             ('int', 'int'): 'int',
             ('int', 'float'): 'float',
             ('int', 'double'): 'double',
+            ('int', 'long'): 'long',
+            ('long', 'long'): 'long',
+            ('long', 'float'): 'float',
+            ('long', 'double'): 'double',
             ('float', 'int'): 'float',
             ('float', 'float'): 'float',
             ('float', 'double'): 'double',
@@ -105,6 +139,12 @@ class SemanticAnalyzer:
         std_endl_symbol = Symbol('std::endl', 'variable', 'string', '\n')
         std_endl_symbol.is_initialized = True
         self.global_scope.define_symbol(std_endl_symbol)
+        
+        # cin and std::cin
+        for name in INPUT_STREAMS:
+            cin_symbol = Symbol(name, 'variable', 'istream')
+            cin_symbol.is_initialized = True
+            self.global_scope.define_symbol(cin_symbol)
     
     def error(self, message: str):
         """Add an error to the error list"""
@@ -136,55 +176,105 @@ class SemanticAnalyzer:
     
     def visit_program(self, node: Program):
         """Visit a program node"""
+        if self.context.fast_analysis:
+            self.call_graph = CallGraph(node)
         for declaration in node.declarations:
             self.visit_declaration(declaration)
     
     def visit_declaration(self, node: Statement):
         """Visit a declaration"""
-        if isinstance(node, IncludeDirective):
-            self.visit_include_directive(node)
-        elif isinstance(node, UsingNamespace):
-            self.visit_using_namespace(node)
-        elif isinstance(node, FunctionDeclaration):
-            self.visit_function_declaration(node)
-        elif isinstance(node, VariableDeclaration):
-            self.visit_variable_declaration(node)
-        elif isinstance(node, ClassDeclaration):
-            self.visit_class_declaration(node)
-        else:
+        handler = self.declaration_handlers[type(node)]
+        if handler is None:
             self.error(f"Unknown declaration type: {type(node)}")
+        else:
+            handler(self, node)
 
+    @handles('declaration', ClassDeclaration)
     def visit_class_declaration(self, node: ClassDeclaration):
-        """Register class/struct type and its members (simplified)"""
+        """Register class/struct type, its members and member functions"""
         if node.name in self.built_in_types or node.name in self.user_types:
             self.error(f"Type '{node.name}' already defined")
             return
         self.user_types.add(node.name)
-        # Create a scope for class members (not used in further analysis yet)
+        self.classes[node.name] = node
+        # Member and method symbols live in the class scope, which encloses method bodies
         class_scope = Scope(f"class_{node.name}", self.current_scope)
+        self.class_scopes[node.name] = class_scope
         for member in node.members:
             if isinstance(member, VariableDeclaration):
+                if not self.is_known_type(member.var_type.name):
+                    self.error(f"Unknown type: {member.var_type.name}")
+                elif member.var_type.name == node.name:
+                    self.error(f"Member '{member.name}' has incomplete type {node.name}")
+                if member.name in class_scope.symbols:
+                    self.error(f"Member '{member.name}' already defined in {node.name}")
+                    continue
                 # Register member symbol inside class scope
-                class_scope.define_symbol(Symbol(member.name, 'member', member.var_type.name))
+                member_symbol = Symbol(member.name, 'member', member.var_type.name)
+                member_symbol.is_initialized = True
+                class_scope.define_symbol(member_symbol)
+        for method in node.methods:
+            if method.name in class_scope.symbols:
+                self.error(f"Member '{method.name}' already defined in {node.name} (overloading is not supported)")
+                continue
+            method_symbol = Symbol(method.name, 'method', method.return_type.name)
+            method_symbol.parameters = method.parameters
+            class_scope.define_symbol(method_symbol)
+        arities = [len(ctor.parameters) for ctor in node.constructors]
+        if len(set(arities)) != len(arities):
+            self.error(f"Constructors of '{node.name}' must differ in parameter count")
         self.current_scope.children.append(class_scope)
+        
+        # Analyze member initializers and bodies with the members in scope
+        self.scope_stack.append(class_scope)
+        self.current_scope = class_scope
+        for member in node.members:
+            if member.initializer:
+                init_type = self.visit_expression(member.initializer)
+                if init_type != member.var_type.name and not self.get_type_compatibility(member.var_type.name, init_type):
+                    self.error(f"Cannot assign {init_type} to {member.var_type.name}")
+        for ctor in node.constructors:
+            self.visit_function_body(ctor, this_type=node.name)
+        for method in node.methods:
+            if not self.is_known_type(method.return_type.name):
+                self.error(f"Unknown return type: {method.return_type.name}")
+            self.visit_function_body(method, this_type=node.name)
+        self.exit_scope()
+    
+    def is_known_type(self, type_name: str) -> bool:
+        """Check whether a type name is built in or a declared class/struct"""
+        return type_name in self.built_in_types or type_name in self.user_types
     
+    def note_value_copy(self, node: Expression, value_type: str):
+        """Record that a class-typed lvalue is copied (not aliased) at this use"""
+        if value_type in self.classes and isinstance(node, (Identifier, MemberAccess)):
+            self.value_copies.add(node)
+    
+    def note_conversion(self, node: Expression, value_type: str, target_type: str):
+        """Record an implicit arithmetic conversion of node's value to target_type"""
+        if value_type != target_type and value_type in self.arithmetic_types and target_type in self.arithmetic_types:
+            node.converted_type = target_type
+    
+    @handles('declaration', IncludeDirective)
     def visit_include_directive(self, node: IncludeDirective):
         """Visit an include directive"""
         # For now, just validate that it's a known header
-        known_headers = ['<iostream>', '"iostream"']
+        known_headers = ['<iostream>', '"iostream"', '<cmath>']
         if node.header not in known_headers:
             pass  # Just warn, don't error
     
+    @handles('declaration', UsingNamespace)
     def visit_using_namespace(self, node: UsingNamespace):
         """Visit a using namespace directive"""
         # For now, just validate that it's std
         if node.namespace != 'std':
             self.error(f"Unknown namespace: {node.namespace}")
     
+    @handles('declaration', FunctionDeclaration)
     def visit_function_declaration(self, node: FunctionDeclaration):
         """Visit a function declaration"""
         # Check return type
-        if node.return_type.name not in self.built_in_types:
+        if not self.is_known_type(node.return_type.name):
             self.error(f"Unknown return type: {node.return_type.name}")
         
         # Check if function already exists
@@ -199,74 +289,50 @@ class SemanticAnalyzer:
         func_symbol.parameters = node.parameters
         self.current_scope.define_symbol(func_symbol)
         
+        if self.call_graph is not None and not self.call_graph.is_reachable(node.name):
+            # Never generated, so only its signature matters to callers
+            self.skipped_functions.append(node.name)
+            return
+        self.visit_function_body(node)
+    
+    def visit_function_body(self, node: FunctionDeclaration, this_type: Optional[str] = None):
+        """Analyze a function or member function body in its own scope"""
         # Enter function scope
         self.current_function = node
         func_scope = self.enter_scope(f"function_{node.name}")
         
+        if this_type:
+            this_symbol = Symbol('this', 'parameter', this_type)
+            this_symbol.is_initialized = True
+            func_scope.define_symbol(this_symbol)
+        
         # Add parameters to function scope
         for param_type, param_name in node.parameters:
-            if param_type.name not in self.built_in_types:
+            if not self.is_known_type(param_type.name):
                 self.error(f"Unknown parameter type: {param_type.name}")
             
             param_symbol = Symbol(param_name, 'parameter', param_type.name)
             param_symbol.is_initialized = True  # Parameters are always initialized
+            param_symbol.is_reference = param_type.is_reference
             func_scope.define_symbol(param_symbol)
         
-        # Analyze function body
+        # Analyze function body; return statements are checked as they are visited
         self.visit_statement(node.body)
         
-        # Check return statements
-        self.check_return_statements(node.body, node.return_type.name)
-        
         # Exit function scope
         self.exit_scope()
         self.current_function = None
     
-    def check_return_statements(self, body: Statement, expected_type: str):
-        """Check that all return statements match the expected type"""
-        def check_returns(stmt: Statement):
-            if isinstance(stmt, ReturnStatement):
-                if stmt.expression is None:
-                    if expected_type != 'void':
-                        self.error(f"Function should return {expected_type}, but return statement has no value")
-                else:
-                    expr_type = self.visit_expression(stmt.expression)
-                    if expr_type != expected_type:
-                        if not self.get_type_compatibility(expr_type, expected_type):
-                            self.error(f"Return type mismatch: expected {expected_type}, got {expr_type}")
-            elif isinstance(stmt, Block):
-                for s in stmt.statements:
-                    check_returns(s)
-            elif isinstance(stmt, IfStatement):
-                check_returns(stmt.then_stmt)
-                if stmt.else_stmt:
-                    check_returns(stmt.else_stmt)
-            elif isinstance(stmt, WhileStatement):
-                check_returns(stmt.body)
-            elif isinstance(stmt, ForStatement):
-                check_returns(stmt.body)
-        
-        check_returns(body)
-    
     def visit_statement(self, node: Statement):
         """Visit a statement"""
-        if isinstance(node, VariableDeclaration):
-            self.visit_variable_declaration(node)
-        elif isinstance(node, ExpressionStatement):
-            self.visit_expression_statement(node)
-        elif isinstance(node, Block):
-            self.visit_block(node)
-        elif isinstance(node, IfStatement):
-            self.visit_if_statement(node)
-        elif isinstance(node, WhileStatement):
-            self.visit_while_statement(node)
-        elif isinstance(node, ForStatement):
-            self.visit_for_statement(node)
-        elif isinstance(node, ReturnStatement):
-            self.visit_return_statement(node)
-        else:
+        handler = self.statement_handlers[type(node)]
+        if handler is None:
             self.error(f"Unknown statement type: {type(node)}")
+        else:
+            handler(self, node)
     
+    @handles('declaration', VariableDeclaration)
+    @handles('statement', VariableDeclaration)
     def visit_variable_declaration(self, node: VariableDeclaration):
         """Visit a variable declaration"""
         # Check type
@@ -283,23 +349,56 @@ class SemanticAnalyzer:
         
         # Check initializer type
         initializer_type = None
-        if node.initializer:
+        if isinstance(node.initializer, InitializerList):
+            self.visit_initializer_list(node.initializer, node.var_type.name)
+        elif node.initializer:
             initializer_type = self.visit_expression(node.initializer)
             # Type compatibility check
             if initializer_type != node.var_type.name:
                 compatible_type = self.get_type_compatibility(node.var_type.name, initializer_type)
                 if not compatible_type:
                     self.error(f"Cannot assign {initializer_type} to {node.var_type.name}")
+            if not node.var_type.is_reference:
+                self.note_value_copy(node.initializer, initializer_type)
+            self.note_conversion(node.initializer, initializer_type, node.var_type.name)
+        elif node.var_type.name in self.classes:
+            constructors = self.classes[node.var_type.name].constructors
+            if constructors and all(ctor.parameters for ctor in constructors):
+                self.error(f"No default constructor for {node.var_type.name}")
         
         # Create symbol
         symbol = Symbol(node.name, 'variable', node.var_type.name)
-        symbol.is_initialized = node.initializer is not None
+        # Class-typed variables are default constructed
+        symbol.is_initialized = node.initializer is not None or node.var_type.name in self.classes
         self.current_scope.define_symbol(symbol)
     
+    def visit_initializer_list(self, node: InitializerList, target_type: str):
+        """Check a brace initializer against the declared type"""
+        if target_type in self.classes:
+            cls = self.classes[target_type]
+            if cls.constructors:
+                self.check_arguments(f"{target_type} constructor", node.elements,
+                                     self.constructor_parameters(cls, node.elements))
+                return
+            if len(node.elements) > len(cls.members):
+                self.error(f"Too many initializers for {target_type}")
+                return
+            self.check_arguments(target_type, node.elements,
+                                 [(member.var_type, member.name) for member in cls.members[:len(node.elements)]])
+        elif len(node.elements) == 1:
+            element_type = self.visit_expression(node.elements[0])
+            if element_type != target_type and not self.get_type_compatibility(target_type, element_type):
+                self.error(f"Cannot assign {element_type} to {target_type}")
+            self.note_conversion(node.elements[0], element_type, target_type)
+        elif node.elements:
+            self.error(f"Too many initializers for {target_type}")
+    
+    @handles('statement', ExpressionStatement)
     def visit_expression_statement(self, node: ExpressionStatement):
         """Visit an expression statement"""
         self.visit_expression(node.expression)
     
+    @handles('statement', Block)
     def visit_block(self, node: Block):
         """Visit a block statement"""
         # Don't create extra scope if we're already in a function scope
@@ -315,11 +414,12 @@ class SemanticAnalyzer:
         if need_new_scope:
             self.exit_scope()
     
+    @handles('statement', IfStatement)
     def visit_if_statement(self, node: IfStatement):
         """Visit an if statement"""
         # Check condition
         condition_type = self.visit_expression(node.condition)
-        if condition_type not in ['bool', 'int']:  # Allow int for C-style boolean
+        if condition_type not in self.condition_types:  # Allow int for C-style boolean
             self.error(f"If condition must be boolean or integer, got {condition_type}")
         
         # Visit branches
@@ -327,16 +427,20 @@ class SemanticAnalyzer:
         if node.else_stmt:
             self.visit_statement(node.else_stmt)
     
+    @handles('statement', WhileStatement)
     def visit_while_statement(self, node: WhileStatement):
         """Visit a while statement"""
         # Check condition
         condition_type = self.visit_expression(node.condition)
-        if condition_type not in ['bool', 'int']:
+        if condition_type not in self.condition_types:
             self.error(f"While condition must be boolean or integer, got {condition_type}")
         
         # Visit body
+        self.loop_depth += 1
         self.visit_statement(node.body)
+        self.loop_depth -= 1
     
+    @handles('statement', ForStatement)
     def visit_for_statement(self, node: ForStatement):
         """Visit a for statement"""
         # Enter new scope for for loop
@@ -349,7 +453,7 @@ class SemanticAnalyzer:
         # Check condition
         if node.condition:
             condition_type = self.visit_expression(node.condition)
-            if condition_type not in ['bool', 'int']:
+            if condition_type not in self.condition_types:
                 self.error(f"For condition must be boolean or integer, got {condition_type}")
         
         # Visit update
@@ -357,11 +461,72 @@ class SemanticAnalyzer:
             self.visit_expression(node.update)
         
         # Visit body
+        self.loop_depth += 1
         self.visit_statement(node.body)
+        self.loop_depth -= 1
         
         # Exit for scope
         self.exit_scope()
     
+    @handles('statement', SwitchStatement)
+    def visit_switch_statement(self, node: SwitchStatement):
+        """Visit a switch statement"""
+        expr_type = self.visit_expression(node.expression)
+        if expr_type not in ['int', 'long', 'char', 'bool']:
+            self.error(f"Switch expression must be integral, got {expr_type}")
+        
+        # All labels share one scope, as in C++
+        self.enter_scope("switch")
+        self.switch_depth += 1
+        
+        seen_values = set()
+        has_default = False
+        for case in node.cases:
+            if case.is_default:
+                if has_default:
+                    self.error("Multiple default labels in one switch")
+                has_default = True
+            else:
+                label = self.constant_case_value(case.value)
+                if label is None:
+                    self.error(f"Case label must be a constant expression, got {case.value}")
+                else:
+                    label_type = self.visit_expression(case.value)
+                    if label_type != expr_type and not self.get_type_compatibility(expr_type, label_type):
+                        self.error(f"Case label type {label_type} does not match switch type {expr_type}")
+                    if label in seen_values:
+                        self.error(f"Duplicate case value: {label}")
+                    seen_values.add(label)
+            
+            for statement in case.statements:
+                self.visit_statement(statement)
+        
+        self.switch_depth -= 1
+        self.exit_scope()
+    
+    def constant_case_value(self, node: Expression) -> Optional[Any]:
+        """Return the value of a constant case label, or None if it isn't constant"""
+        if isinstance(node, Literal) and node.type_name in ['int', 'long', 'char', 'bool']:
+            return node.value
+        if isinstance(node, UnaryOperation) and node.operator in ['-', '+']:
+            operand = self.constant_case_value(node.operand)
+            if isinstance(operand, int) and not isinstance(operand, bool):
+                return -operand if node.operator == '-' else operand
+        return None
+    
+    @handles('statement', BreakStatement)
+    def visit_break_statement(self, node: BreakStatement):
+        """Visit a break statement"""
+        if self.loop_depth == 0 and self.switch_depth == 0:
+            self.error("Break statement outside of loop or switch")
+    
+    @handles('statement', ContinueStatement)
+    def visit_continue_statement(self, node: ContinueStatement):
+        """Visit a continue statement"""
+        if self.loop_depth == 0:
+            self.error("Continue statement outside of loop")
+    
+    @handles('statement', ReturnStatement)
     def visit_return_statement(self, node: ReturnStatement):
         """Visit a return statement"""
         if not self.current_function:
@@ -371,37 +536,53 @@ class SemanticAnalyzer:
         expected_type = self.current_function.return_type.name
         
         if node.expression:
-            expr_type = self.visit_expression(node.expression)
+            # Checked here, in the scope the expression appears in; its type
+            # stays on the node for the code generator
+            self.visit_expression(node.expression)
+            expr_type = node.expression.static_type
             if expr_type != expected_type:
                 compatible_type = self.get_type_compatibility(expected_type, expr_type)
                 if not compatible_type:
                     self.error(f"Return type mismatch: expected {expected_type}, got {expr_type}")
+            self.note_conversion(node.expression, expr_type, expected_type)
+            # Locals and by-value parameters are already private copies; members
+            # and reference parameters would alias the caller's object
+            returns_local = False
+            if isinstance(node.expression, Identifier):
+                symbol = self.current_scope.lookup_symbol(node.expression.name)
+                returns_local = symbol is not None and (
+                    symbol.symbol_type == 'variable' or
+                    (symbol.symbol_type == 'parameter' and symbol.name != 'this'
+                     and not getattr(symbol, 'is_reference', False)))
+            if not returns_local:
+                self.note_value_copy(node.expression, expr_type)
         else:
             if expected_type != 'void':
                 self.error(f"Function should return {expected_type}, but return statement has no value")
     
     def visit_expression(self, node: Expression) -> str:
-        """Visit an expression and return its type"""
-        if isinstance(node, Literal):
-            return self.visit_literal(node)
-        elif isinstance(node, Identifier):
-            return self.visit_identifier(node)
-        elif isinstance(node, BinaryOperation):
-            return self.visit_binary_operation(node)
-        elif isinstance(node, UnaryOperation):
-            return self.visit_unary_operation(node)
-        elif isinstance(node, Assignment):
-            return self.visit_assignment(node)
-        elif isinstance(node, FunctionCall):
-            return self.visit_function_call(node)
-        else:
+        """Visit an expression, record its type on the node and return it"""
+        handler = self.expression_handlers[type(node)]
+        if handler is None:
             self.error(f"Unknown expression type: {type(node)}")
-            return 'unknown'
+            expr_type = 'unknown'
+        else:
+            expr_type = handler(self, node)
+        node.static_type = expr_type
+        return expr_type
+    
+    @handles('expression', InitializerList)
+    def visit_nested_initializer_list(self, node: InitializerList) -> str:
+        """Reject an initializer list outside a declaration"""
+        self.error("Initializer lists are only supported in declarations")
+        return 'unknown'
     
+    @handles('expression', Literal)
     def visit_literal(self, node: Literal) -> str:
         """Visit a literal and return its type"""
         return node.type_name
     
+    @handles('expression', Identifier)
     def visit_identifier(self, node: Identifier) -> str:
         """Visit an identifier and return its type"""
         symbol = self.current_scope.lookup_symbol(node.name)
@@ -414,8 +595,11 @@ class SemanticAnalyzer:
         
         return symbol.data_type
     
+    @handles('expression', BinaryOperation)
     def visit_binary_operation(self, node: BinaryOperation) -> str:
         """Visit a binary operation and return its type"""
+        if node.operator == '>>':
+            return self.visit_extraction(node)
         left_type = self.visit_expression(node.left)
         right_type = self.visit_expression(node.right)
         
@@ -428,7 +612,7 @@ class SemanticAnalyzer:
         
         # Logical operators
         elif node.operator in ['&&', '||']:
-            if left_type not in ['bool', 'int'] or right_type not in ['bool', 'int']:
+            if left_type not in self.condition_types or right_type not in self.condition_types:
                 self.error(f"Logical operators require boolean operands")
             return 'bool'
         
@@ -461,55 +645,95 @@ class SemanticAnalyzer:
             self.error(f"Unknown binary operator: {node.operator}")
             return 'unknown'
     
+    def visit_extraction(self, node: BinaryOperation) -> str:
+        """Visit cin >> target; the target is written, not read"""
+        stream_type = self.visit_expression(node.left)
+        if stream_type != 'istream':
+            self.error(f"Right shift operator requires istream on left side, got {stream_type}")
+            return 'unknown'
+        target = node.right
+        if isinstance(target, MemberAccess):
+            target_type = self.visit_member_access(target)
+        elif isinstance(target, Identifier):
+            symbol = self.current_scope.lookup_symbol(target.name)
+            if not symbol:
+                self.error(f"Undefined variable: {target.name}")
+                return 'istream'
+            if symbol.symbol_type not in ['variable', 'parameter', 'member']:
+                self.error(f"Cannot read into {symbol.symbol_type}")
+                return 'istream'
+            symbol.is_initialized = True
+            target_type = symbol.data_type
+        else:
+            self.error("cin >> requires a variable on the right side")
+            return 'istream'
+        target.static_type = target_type
+        if target_type not in self.extractable_types and target_type != 'unknown':
+            self.error(f"Cannot read {target_type} from cin")
+        return 'istream'
+    
+    @handles('expression', UnaryOperation)
     def visit_unary_operation(self, node: UnaryOperation) -> str:
         """Visit a unary operation and return its type"""
         operand_type = self.visit_expression(node.operand)
         
         if node.operator == '!':
-            if operand_type not in ['bool', 'int']:
+            if operand_type not in self.condition_types:
                 self.error(f"Logical NOT requires boolean operand, got {operand_type}")
             return 'bool'
         elif node.operator in ['+', '-']:
-            if operand_type not in ['int', 'float', 'double']:
+            if operand_type not in self.arithmetic_types:
                 self.error(f"Unary {node.operator} requires numeric operand, got {operand_type}")
             return operand_type
         elif node.operator in ['++', '--', '++_post', '--_post']:
-            if operand_type not in ['int', 'float', 'double']:
+            if operand_type not in self.arithmetic_types:
                 self.error(f"Increment/decrement requires numeric operand, got {operand_type}")
             # Check if operand is assignable
-            if not isinstance(node.operand, Identifier):
+            if not isinstance(node.operand, (Identifier, MemberAccess)):
                 self.error("Increment/decrement requires assignable operand")
             return operand_type
         else:
             self.error(f"Unknown unary operator: {node.operator}")
             return 'unknown'
     
+    @handles('expression', Assignment)
     def visit_assignment(self, node: Assignment) -> str:
         """Visit an assignment and return its type"""
-        # Check if target exists and is assignable
-        symbol = self.current_scope.lookup_symbol(node.target.name)
-        if not symbol:
-            self.error(f"Undefined variable: {node.target.name}")
-            return 'unknown'
-        
-        if symbol.symbol_type != 'variable':
-            self.error(f"Cannot assign to {symbol.symbol_type}")
-            return 'unknown'
+        symbol = None
+        if isinstance(node.target, MemberAccess):
+            target_type = self.visit_member_access(node.target)
+            if target_type == 'unknown':
+                return 'unknown'
+        else:
+            # Check if target exists and is assignable
+            symbol = self.current_scope.lookup_symbol(node.target.name)
+            if not symbol:
+                self.error(f"Undefined variable: {node.target.name}")
+                return 'unknown'
+            
+            if symbol.symbol_type not in ['variable', 'parameter', 'member']:
+                self.error(f"Cannot assign to {symbol.symbol_type}")
+                return 'unknown'
+            target_type = symbol.data_type
         
         # Check value type
         value_type = self.visit_expression(node.value)
         
         # Type compatibility check
-        if value_type != symbol.data_type:
-            compatible_type = self.get_type_compatibility(symbol.data_type, value_type)
+        if value_type != target_type:
+            compatible_type = self.get_type_compatibility(target_type, value_type)
             if not compatible_type:
-                self.error(f"Cannot assign {value_type} to {symbol.data_type}")
-                return symbol.data_type
+                self.error(f"Cannot assign {value_type} to {target_type}")
+                return target_type
+        self.note_value_copy(node.value, value_type)
+        self.note_conversion(node.value, value_type, target_type)
         
         # Mark as initialized
-        symbol.is_initialized = True
-        return symbol.data_type
+        if symbol:
+            symbol.is_initialized = True
+        return target_type
     
+    @handles('expression', FunctionCall)
     def visit_function_call(self, node: FunctionCall) -> str:
         """Visit a function call and return its type"""
         # Special handling for built-in functions
@@ -517,29 +741,109 @@ class SemanticAnalyzer:
             # Handle cout << expressions (simplified)
             return 'ostream'
         
+        # Constructing a class/struct temporary: Point(1, 2)
+        if node.name in self.classes:
+            cls = self.classes[node.name]
+            if cls.constructors:
+                self.check_arguments(f"{node.name} constructor", node.arguments,
+                                     self.constructor_parameters(cls, node.arguments))
+            elif len(node.arguments) > len(cls.members):
+                self.error(f"Too many initializers for {node.name}")
+            else:
+                self.check_arguments(node.name, node.arguments,
+                                     [(member.var_type, member.name) for member in cls.members[:len(node.arguments)]])
+            return node.name
+        
         # Look up function symbol
         symbol = self.current_scope.lookup_symbol(node.name)
         if not symbol:
+            intrinsic = lookup_intrinsic(node.name)
+            if intrinsic:
+                return self.visit_intrinsic_call(node, intrinsic)
             self.error(f"Undefined function: {node.name}")
             return 'unknown'
         
-        if symbol.symbol_type != 'function':
+        if symbol.symbol_type not in ['function', 'method']:
             self.error(f"'{node.name}' is not a function")
             return 'unknown'
         
         # Check argument count and types
-        expected_params = getattr(symbol, 'parameters', [])
-        if len(node.arguments) != len(expected_params):
-            self.error(f"Function '{node.name}' expects {len(expected_params)} arguments, got {len(node.arguments)}")
-            return symbol.data_type
+        self.check_arguments(f"Function '{node.name}'", node.arguments, getattr(symbol, 'parameters', []))
+        return symbol.data_type
+    
+    def visit_intrinsic_call(self, node: FunctionCall, intrinsic: Intrinsic) -> str:
+        """Type a call of a <cmath> function and convert its arguments to the chosen overload"""
+        if len(node.arguments) != intrinsic.arity:
+            self.error(f"Function '{intrinsic.name}' expects {intrinsic.arity} arguments, got {len(node.arguments)}")
+            return 'unknown'
+        arg_types = [self.visit_expression(arg) for arg in node.arguments]
+        if 'unknown' in arg_types:
+            return 'unknown'
+        result_type = intrinsic.result_type(arg_types)
+        if result_type is None:
+            self.error(f"No matching function for call to {intrinsic.name}({', '.join(arg_types)})")
+            return 'unknown'
+        for arg, arg_type in zip(node.arguments, arg_types):
+            self.note_conversion(arg, arg_type, result_type)
+        node.intrinsic = intrinsic
+        return result_type
+    
+    def check_arguments(self, callee: str, arguments: List[Expression], expected_params: List[tuple]):
+        """Check call arguments against (Type, name) parameters"""
+        if len(arguments) != len(expected_params):
+            self.error(f"{callee} expects {len(expected_params)} arguments, got {len(arguments)}")
+            return
         
-        for i, (arg, (param_type, _)) in enumerate(zip(node.arguments, expected_params)):
+        for i, (arg, (param_type, _)) in enumerate(zip(arguments, expected_params)):
             arg_type = self.visit_expression(arg)
             if arg_type != param_type.name:
                 compatible_type = self.get_type_compatibility(param_type.name, arg_type)
                 if not compatible_type:
                     self.error(f"Argument {i+1} type mismatch: expected {param_type.name}, got {arg_type}")
+            if not param_type.is_reference:
+                self.note_value_copy(arg, arg_type)
+            self.note_conversion(arg, arg_type, param_type.name)
+    
+    def constructor_parameters(self, cls: ClassDeclaration, arguments: List[Expression]) -> List[tuple]:
+        """Pick the constructor whose arity matches the call"""
+        for ctor in cls.constructors:
+            if len(ctor.parameters) == len(arguments):
+                return ctor.parameters
+        # No match; report against the first constructor
+        return cls.constructors[0].parameters
+    
+    @handles('expression', MemberAccess)
+    def visit_member_access(self, node: MemberAccess) -> str:
+        """Visit a data member access and return the member's type"""
+        obj_type = self.visit_expression(node.obj)
+        class_scope = self.class_scopes.get(obj_type)
+        if class_scope is None:
+            if obj_type != 'unknown':
+                self.error(f"Member access on non-class type {obj_type}")
+            return 'unknown'
+        
+        symbol = class_scope.symbols.get(node.member)
+        if not symbol or symbol.symbol_type != 'member':
+            self.error(f"'{obj_type}' has no member '{node.member}'")
+            return 'unknown'
+        return symbol.data_type
+    
+    @handles('expression', MethodCall)
+    def visit_method_call(self, node: MethodCall) -> str:
+        """Visit a member function call and return its type"""
+        obj_type = self.visit_expression(node.obj)
+        class_scope = self.class_scopes.get(obj_type)
+        if class_scope is None:
+            if obj_type != 'unknown':
+                self.error(f"Member function call on non-class type {obj_type}")
+            return 'unknown'
+        
+        symbol = class_scope.symbols.get(node.name)
+        if not symbol or symbol.symbol_type != 'method':
+            self.error(f"'{obj_type}' has no member function '{node.name}'")
+            return 'unknown'
         
+        self.check_arguments(f"Member function '{node.name}'", node.arguments, symbol.parameters)
         return symbol.data_type
 
 def main():
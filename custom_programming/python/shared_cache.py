@@ -0,0 +1,199 @@
+"""
+Shared-Memory Cache
+A fixed-size hash table in an anonymous shared mmap, created before the server
+forks so every worker process sees the same entries. Writers serialize on a
+record lock of a shared file, which the kernel drops if its holder dies;
+readers take no lock and detect concurrent updates instead.
+"""
+
+import fcntl
+import hashlib
+import mmap
+import struct
+import tempfile
+import threading
+from contextlib import contextmanager
+from typing import Iterator, Optional
+
+# Header: magic, slot count, arena size, bytes ever written to the arena
+HEADER = struct.Struct('<4sIQQ')
+MAGIC = b'CPPC'
+# Slot: sequence number, record length, record position, key digest
+SLOT = struct.Struct('<IIQ16s')
+# Sequence numbers wrap at 32 bits; 0xFFFFFFFF (odd) is followed by 0 (even)
+SEQUENCE_MASK = 0xFFFFFFFF
+# Arena record: key digest, value length, then the value
+RECORD = struct.Struct('<16sI')
+TOTAL_OFFSET = 16
+
+# Slots probed for a key before the oldest one is replaced
+PROBE_LIMIT = 8
+# Torn reads of a slot before a reader gives up on it; a slot stays odd if its
+# writer died mid-update, until the next writer to probe it replaces it
+READ_RETRIES = 1000
+
+def key_digest(key: bytes) -> bytes:
+    """Fixed-size digest stored for each key"""
+    return hashlib.blake2b(key, digest_size=16).digest()
+
+class SharedCache:
+    """Byte-string cache shared by forked processes
+
+    Values live in a ring-buffer arena. A record's position is an absolute
+    byte count, so a reader can tell that the writer has wrapped around and
+    overwritten a record since the slot pointed at it. Each slot carries a
+    sequence number that is odd while the slot is being written (a seqlock).
+    Readers retry a torn slot read a bounded number of times and treat
+    running out, like an overwritten record, as a miss. No read ever blocks on
+    a writer.
+    """
+
+    def __init__(self, arena_bytes: int = 64 * 1024 * 1024, slots: int = 65536):
+        self.slots = slots
+        self.arena_bytes = arena_bytes
+        self.slots_offset = HEADER.size
+        self.arena_offset = self.slots_offset + slots * SLOT.size
+        self.memory = mmap.mmap(-1, self.arena_offset + arena_bytes,
+                                flags=mmap.MAP_SHARED, prot=mmap.PROT_READ | mmap.PROT_WRITE)
+        HEADER.pack_into(self.memory, 0, MAGIC, slots, arena_bytes, 0)
+        # POSIX record locks belong to a process and are released when it
+        # exits, so a writer killed mid-put cannot leave the cache locked.
+        # They don't exclude threads of one process, hence the thread lock.
+        self.lock_file = tempfile.TemporaryFile()
+        self.thread_lock = threading.Lock()
+        # Per-process counters
+        self.hits = 0
+        self.misses = 0
+        self.stores = 0
+
+    def total_written(self) -> int:
+        return struct.unpack_from('<Q', self.memory, TOTAL_OFFSET)[0]
+
+    def slot_offset(self, index: int) -> int:
+        return self.slots_offset + (index % self.slots) * SLOT.size
+
+    def read_slot(self, offset: int) -> Optional[tuple]:
+        """Consistent (length, position, digest) of a slot, or None after READ_RETRIES torn reads"""
+        for _ in range(READ_RETRIES):
+            sequence, length, position, digest = SLOT.unpack_from(self.memory, offset)
+            if sequence & 1:
+                continue
+            if struct.unpack_from('<I', self.memory, offset)[0] == sequence:
+                return length, position, digest
+        return None
+
+    @contextmanager
+    def write_lock(self) -> Iterator[None]:
+        """Exclude every other writer, in this process and the others"""
+        with self.thread_lock:
+            fcntl.lockf(self.lock_file, fcntl.LOCK_EX)
+            try:
+                yield
+            finally:
+                fcntl.lockf(self.lock_file, fcntl.LOCK_UN)
+
+    def is_live(self, position: int, length: int, total: int) -> bool:
+        """Whether the record at position has not been overwritten yet"""
+        return length > 0 and total - position <= self.arena_bytes
+
+    def get(self, key: bytes) -> Optional[bytes]:
+        """Value stored under key, or None"""
+        digest = key_digest(key)
+        start = int.from_bytes(digest[:8], 'little')
+        for probe in range(PROBE_LIMIT):
+            slot = self.read_slot(self.slot_offset(start + probe))
+            if slot is None:
+                break
+            length, position, slot_digest = slot
+            if length == 0:
+                break
+            if slot_digest != digest:
+                continue
+            offset = self.arena_offset + position % self.arena_bytes
+            record_digest, value_length = RECORD.unpack_from(self.memory, offset)
+            value = self.memory[offset + RECORD.size:offset + RECORD.size + value_length]
+            # Check liveness after copying: a wrap during the copy invalidates it
+            if record_digest == digest and self.is_live(position, length, self.total_written()):
+                self.hits += 1
+                return value
+            break
+        self.misses += 1
+        return None
+
+    def put(self, key: bytes, value: bytes) -> bool:
+        """Store value under key; False if it can never fit in the arena"""
+        length = RECORD.size + len(value)
+        if length > self.arena_bytes:
+            return False
+        digest = key_digest(key)
+        start = int.from_bytes(digest[:8], 'little')
+        with self.write_lock():
+            total = self.total_written()
+            # Records never straddle the end of the arena
+            position = total
+            if position % self.arena_bytes + length > self.arena_bytes:
+                position += self.arena_bytes - position % self.arena_bytes
+            # Publish the new total before overwriting, so readers of the old
+            # records in this region see them as dead
+            struct.pack_into('<Q', self.memory, TOTAL_OFFSET, position + length)
+            offset = self.arena_offset + position % self.arena_bytes
+            RECORD.pack_into(self.memory, offset, digest, len(value))
+            self.memory[offset + RECORD.size:offset + length] = value
+
+            target = None
+            oldest = None
+            for probe in range(PROBE_LIMIT):
+                slot = self.slot_offset(start + probe)
+                # No other writer runs, so the slot is read directly; an odd
+                # sequence is one a dead writer left half-written
+                sequence, slot_length, slot_position, slot_digest = SLOT.unpack_from(self.memory, slot)
+                if (sequence & 1 or slot_digest == digest or slot_length == 0
+                        or not self.is_live(slot_position, slot_length, position + length)):
+                    target = slot
+                    break
+                if oldest is None or slot_position < oldest[1]:
+                    oldest = (slot, slot_position)
+            if target is None:
+                target = oldest[0]
+
+            # Odd while writing, even after; a slot already odd stays odd
+            sequence = struct.unpack_from('<I', self.memory, target)[0] | 1
+            struct.pack_into('<I', self.memory, target, sequence)
+            SLOT.pack_into(self.memory, target, (sequence + 1) & SEQUENCE_MASK, length, position, digest)
+        self.stores += 1
+        return True
+
+    def stats(self) -> dict:
+        """Occupancy of the shared table and this process's hit counters"""
+        return {
+            "arena_bytes": self.arena_bytes,
+            "bytes_written": self.total_written(),
+            "slots": self.slots,
+            "hits": self.hits,
+            "misses": self.misses,
+            "stores": self.stores
+        }
+
+def main():
+    """Test the shared cache across a fork"""
+    import os
+
+    cache = SharedCache(arena_bytes=4096, slots=64)
+    cache.put(b"hello", b"world")
+    pid = os.fork()
+    if pid == 0:
+        cache.put(b"child", b"written after fork")
+        os._exit(0)
+    os.waitpid(pid, 0)
+    print(f"hello -> {cache.get(b'hello')}")
+    print(f"child -> {cache.get(b'child')}")
+
+    # Fill the arena several times over; early records must read as misses
+    for i in range(200):
+        cache.put(f"key{i}".encode(), bytes(40))
+    print(f"key0 after wraparound -> {cache.get(b'key0')}")
+    print(f"key199 -> {len(cache.get(b'key199'))} bytes")
+    print(cache.stats())
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+"""
+Delta Source Uploads
+Lets /compile take an edit against a program the server has already seen
+instead of the whole file. Every program a client submits is stored by its
+content hash, and the hash is returned in the X-Source-Hash response header.
+The next request can then send {"base_hash": ..., "changes": [...]} with
+line-range replacements. When the base is no longer stored, the server
+answers 409 with base_unknown, and the client uploads the whole file again.
+"""
+
+import hashlib
+import threading
+from collections import OrderedDict
+from typing import Optional, Tuple
+
+SOURCE_HASH_HEADER = 'X-Source-Hash'
+
+def source_hash(source: str) -> str:
+    return hashlib.sha256(source.encode('utf-8')).hexdigest()[:32]
+
+class SourceStore:
+    """Recently submitted programs by content hash, holding at most max_bytes of source
+
+    With a SharedCache the programs are kept there instead, so every prefork
+    process can resolve a base uploaded to any of them.
+    """
+
+    def __init__(self, max_bytes: int = 32 * 1024 * 1024, shared=None):
+        self.max_bytes = max_bytes
+        self.shared = shared
+        self.sources: 'OrderedDict[str, str]' = OrderedDict()
+        self.size = 0
+        self.lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+
+    def put(self, source: str) -> str:
+        """Store a program; returns its hash"""
+        digest = source_hash(source)
+        if self.shared is not None:
+            self.shared.put(b'source:' + digest.encode('ascii'), source.encode('utf-8'))
+            return digest
+        with self.lock:
+            if digest in self.sources:
+                self.sources.move_to_end(digest)
+                return digest
+            self.sources[digest] = source
+            self.size += len(source)
+            while self.size > self.max_bytes and len(self.sources) > 1:
+                _, evicted = self.sources.popitem(last=False)
+                self.size -= len(evicted)
+        return digest
+
+    def get(self, digest: str) -> Optional[str]:
+        if self.shared is not None:
+            value = self.shared.get(b'source:' + str(digest).encode('utf-8'))
+            source = value.decode('utf-8') if value is not None else None
+        else:
+            with self.lock:
+                source = self.sources.get(digest)
+                if source is not None:
+                    self.sources.move_to_end(digest)
+        if source is None:
+            self.misses += 1
+        else:
+            self.hits += 1
+        return source
+
+    def stats(self) -> dict:
+        return {"sources": len(self.sources), "bytes": self.size, "hits": self.hits,
+                "misses": self.misses, "shared": self.shared is not None}
+
+def apply_line_changes(base: str, changes: list) -> str:
+    """Apply line-range replacements to base
+
+    Each change {"start": s, "end": e, "lines": [...]} replaces lines s..e-1
+    of the base (0-based, split on newlines). Changes refer to base line
+    numbers, and they must be sorted and must not overlap.
+    """
+    lines = base.split('\n')
+    previous_end = 0
+    pieces = []
+    for change in changes:
+        start, end = int(change['start']), int(change['end'])
+        if not previous_end <= start <= end <= len(lines):
+            raise ValueError(f"change {start}..{end} is out of order or outside the {len(lines)} base lines")
+        pieces.extend(lines[previous_end:start])
+        pieces.extend(str(line) for line in change.get('lines', []))
+        previous_end = end
+    pieces.extend(lines[previous_end:])
+    return '\n'.join(pieces)
+
+def resolve_source(store: SourceStore, data: dict) -> Tuple[Optional[str], Optional[tuple]]:
+    """The program a /compile request submits: (source, None) or (None, (status, error payload))
+
+    The caller stores the program once it is accepted, so it can be the base
+    of the client's next request.
+    """
+    if 'base_hash' not in data or 'code' in data:
+        source = str(data.get('code', ''))
+    else:
+        base = store.get(str(data['base_hash']))
+        if base is None:
+            return None, (409, {
+                "success": False,
+                "error": "Unknown base version",
+                "details": ["The server no longer has the program this edit is based on; send the whole code"],
+                "base_unknown": True,
+                "output": "",
+                "execution_output": ""
+            })
+        try:
+            source = apply_line_changes(base, list(data.get('changes') or []))
+        except (ValueError, KeyError, TypeError) as e:
+            return None, (400, {
+                "success": False,
+                "error": "Invalid changes",
+                "details": [str(e)],
+                "output": "",
+                "execution_output": ""
+            })
+    return source, None
+
+def main():
+    """Store a program and rebuild an edited version from a delta"""
+    store = SourceStore()
+    base = "int main() {\n    int x = 1;\n    return x;\n}"
+    digest = store.put(base)
+    data = {"base_hash": digest, "changes": [{"start": 1, "end": 2, "lines": ["    int x = 2;", "    x++;"]}]}
+    source, error = resolve_source(store, data)
+    print(source)
+    print(error, store.stats())
+
+if __name__ == "__main__":
+    main()
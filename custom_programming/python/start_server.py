@@ -91,6 +91,8 @@ Examples:
   python start_server.py --port 8080       # Use different port
   python start_server.py --host 192.168.1.10  # Bind to specific IP
   python start_server.py --debug           # Enable debug mode
+  python start_server.py --async --workers 4  # Asyncio server with 4 compiler processes
+  python start_server.py --async --processes 4  # 4 prefork servers sharing the port and a cache
         """
     )
     
@@ -100,6 +102,12 @@ Examples:
                        help='Port number (default: 5000)')
     parser.add_argument('--debug', action='store_true', 
                        help='Enable debug mode')
+    parser.add_argument('--async', dest='use_async', action='store_true',
+                       help='Run the asyncio server with a compiler process pool')
+    parser.add_argument('--workers', type=int, default=None,
+                       help='Compiler worker processes for --async (default: CPU count)')
+    parser.add_argument('--processes', type=int, default=None,
+                       help='Prefork this many --async servers on the port with a shared cache')
     parser.add_argument('--check-deps', action='store_true', 
                        help='Check and install dependencies only')
     
@@ -123,10 +131,11 @@ Examples:
         print(f"💡 Try using a different port with --port <number>")
         sys.exit(1)
     
-    # Check if server.py exists
-    server_path = Path(__file__).parent / "server.py"
+    # Check if the server script exists
+    server_script = "async_server.py" if args.use_async else "server.py"
+    server_path = Path(__file__).parent / server_script
     if not server_path.exists():
-        print(f"❌ server.py not found at {server_path}")
+        print(f"❌ {server_script} not found at {server_path}")
         print("💡 Make sure you're running this from the python directory")
         sys.exit(1)
     
@@ -135,8 +144,13 @@ Examples:
     
     try:
         # Start server
-        cmd = [sys.executable, "server.py", "--host", args.host, "--port", str(args.port)]
-        if args.debug:
+        cmd = [sys.executable, server_script, "--host", args.host, "--port", str(args.port)]
+        if args.use_async:
+            if args.workers:
+                cmd += ["--workers", str(args.workers)]
+            if args.processes is not None:
+                cmd += ["--processes", str(args.processes)]
+        elif args.debug:
             cmd.append("--debug")
         
         print("🚀 Starting server...")
@@ -0,0 +1,117 @@
+"""
+Concurrency Tests for C++ Compiler
+This script sends 64 simultaneous /compile requests with different programs and
+options to the Flask API and checks that every response reflects its own
+request's program output, generated code option, verbose log and filename.
+"""
+
+import os
+import sys
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+# Add the parent directory to path so we can import the compiler modules
+sys.path.insert(0, str(Path(__file__).parent))
+
+# All requests come from one test client address; the test is about isolation, not admission
+os.environ.setdefault('RATE_LIMIT_RPS', '0')
+
+from main import app
+
+CONCURRENCY = 64
+ROUNDS = 3
+
+def make_program(n: int) -> str:
+    """A program whose output identifies n and takes long enough to overlap"""
+    return f"""#include <iostream>
+using namespace std;
+int mix(int x) {{
+    int total = 0;
+    for (int i = 0; i < 200; i++) {{
+        total = (total * 31 + x + i) % 1000003;
+    }}
+    return total;
+}}
+int main() {{
+    for (int k = 0; k < 5; k++) {{
+        cout << "request {n} line " << k << ": " << mix({n} + k) << endl;
+    }}
+    return 0;
+}}
+"""
+
+def expected_output(n: int) -> str:
+    lines = []
+    for k in range(5):
+        total = 0
+        for i in range(200):
+            total = (total * 31 + n + k + i) % 1000003
+        lines.append(f"request {n} line {k}: {total}\n")
+    return "".join(lines)
+
+def check_response(n: int, options: dict, response) -> list:
+    """Problems with one response, empty if it is correct"""
+    problems = []
+    data = response.get_json()
+    if response.status_code != 200 or not data.get('success'):
+        return [f"request {n}: failed with {response.status_code}: {data.get('error')}"]
+    if data['execution_output'] != expected_output(n):
+        problems.append(f"request {n}: got another request's output {data['execution_output'][:40]!r}")
+    generated_code = data.get('generated_code')
+    if options['show_generated_code']:
+        if not generated_code:
+            problems.append(f"request {n}: generated code missing")
+        elif repr(options['filename']) not in generated_code:
+            problems.append(f"request {n}: generated code is for another file")
+    elif generated_code is not None:
+        problems.append(f"request {n}: generated code included without show_generated_code")
+    if options['verbose'] != data['output'].startswith("Phase 1"):
+        problems.append(f"request {n}: verbose log {'missing' if options['verbose'] else 'unexpected'}")
+    return problems
+
+def run_round(round_number: int) -> list:
+    """Send CONCURRENCY requests at once and collect any problems"""
+    barrier = threading.Barrier(CONCURRENCY)
+
+    def send(i: int) -> list:
+        n = round_number * CONCURRENCY + i
+        options = {
+            'filename': f"request_{n}.cpp",
+            'show_generated_code': i % 2 == 0,
+            'verbose': i % 3 == 0,
+        }
+        client = app.test_client()
+        barrier.wait()
+        response = client.post('/compile', json={'code': make_program(n), **options})
+        return check_response(n, options, response)
+
+    with ThreadPoolExecutor(max_workers=CONCURRENCY) as pool:
+        return [problem for problems in pool.map(send, range(CONCURRENCY)) for problem in problems]
+
+def main():
+    """Run the concurrency stress test"""
+    print(f"C++ Compiler Concurrency Tests ({CONCURRENCY} simultaneous requests x {ROUNDS} rounds)")
+    print("=" * 60)
+    # Small switch interval so threads interleave as much as possible
+    sys.setswitchinterval(1e-5)
+
+    failures = 0
+    for round_number in range(ROUNDS):
+        problems = run_round(round_number)
+        for problem in problems[:10]:
+            print(f"❌ {problem}")
+        if problems:
+            failures += len(problems)
+        else:
+            print(f"✅ Round {round_number + 1}: all {CONCURRENCY} responses match their requests")
+
+    print(f"\n{'='*60}")
+    if failures == 0:
+        print("🎉 All concurrent requests were isolated!")
+        return 0
+    print(f"⚠️  {failures} problem(s) found")
+    return 1
+
+if __name__ == "__main__":
+    sys.exit(main())
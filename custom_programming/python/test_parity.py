@@ -0,0 +1,140 @@
+"""
+Parity Tests for C++ Compiler
+This script compiles every example and parity test program with both g++ and
+this compiler, and checks that stdout and the exit status match on both of
+the compiler's execution engines (generated code and closures). A program
+with a .in file of the same name reads it as its standard input. Programs that
+match are also checked to be routed to the custom pipeline in production.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+# Add the parent directory to path so we can import the compiler modules
+sys.path.insert(0, str(Path(__file__).parent))
+
+from lexer import Lexer
+from parser import Parser
+from semantic_analyzer import SemanticAnalyzer
+from code_generator import CodeGenerator
+from closure_compiler import ClosureCompiler
+from production_compiler import ENGINE_CUSTOM, ProductionCppCompiler
+
+# -fwrapv defines signed overflow as two's complement wraparound, which is
+# what the generated code implements
+GXX_FLAGS = ['-std=c++17', '-O0', '-fwrapv', '-w']
+
+def program_input(source_file: Path) -> str:
+    """The standard input of a test program: its .in file, or nothing"""
+    input_file = source_file.with_suffix('.in')
+    return input_file.read_text() if input_file.exists() else ''
+
+def run_native(source_file: Path, work_dir: str) -> tuple:
+    """Build source_file with g++ and return (stdout, exit status)"""
+    binary = os.path.join(work_dir, source_file.stem)
+    subprocess.run(['g++', *GXX_FLAGS, str(source_file), '-o', binary],
+                   check=True, capture_output=True, text=True)
+    result = subprocess.run([binary], input=program_input(source_file),
+                            capture_output=True, text=True, timeout=30)
+    return result.stdout, result.returncode
+
+def run_compiled(source_file: Path, work_dir: str) -> tuple:
+    """Translate source_file with this compiler and return (stdout, exit status)"""
+    tokens = Lexer(source_file.read_text()).tokenize()
+    ast = Parser(tokens).parse()
+    analyzer = SemanticAnalyzer()
+    if not analyzer.analyze(ast):
+        raise RuntimeError("; ".join(analyzer.errors))
+    # Suffixed so a test named after a stdlib module (types.cpp) does not
+    # shadow it for the scripts that run from work_dir after it
+    script = os.path.join(work_dir, source_file.stem + '_generated.py')
+    with open(script, 'w') as f:
+        f.write(CodeGenerator(analyzer).generate(ast))
+    result = subprocess.run([sys.executable, script], input=program_input(source_file),
+                            capture_output=True, text=True, timeout=60)
+    return result.stdout, result.returncode & 0xFF
+
+def run_closures(source_file: Path) -> tuple:
+    """Run source_file on the closure engine and return (stdout, exit status)"""
+    tokens = Lexer(source_file.read_text()).tokenize()
+    ast = Parser(tokens).parse()
+    analyzer = SemanticAnalyzer()
+    if not analyzer.analyze(ast):
+        raise RuntimeError("; ".join(analyzer.errors))
+    output = []
+    status = ClosureCompiler(analyzer).build(ast).run(output, program_input(source_file))
+    return "".join(output), status & 0xFF
+
+def production_route(source_file: Path):
+    """The production compiler's routing decision for source_file, as if g++ were installed"""
+    compiler = ProductionCppCompiler()
+    compiler.gpp_available = True
+    return compiler.route(Lexer(source_file.read_text()).tokenize())
+
+def run_test_file(test_file: Path, work_dir: str) -> bool:
+    """Compare one program's output between g++ and each engine of this compiler"""
+    try:
+        expected = run_native(test_file, work_dir)
+        results = {'exec': run_compiled(test_file, work_dir), 'closure': run_closures(test_file)}
+    except Exception as e:
+        print(f"❌ {test_file.name} - ERROR: {e}")
+        return False
+
+    mismatches = {engine: actual for engine, actual in results.items() if actual != expected}
+    if not mismatches:
+        decision = production_route(test_file)
+        if decision.engine != ENGINE_CUSTOM:
+            # The custom pipeline runs it correctly, so production should use it
+            print(f"❌ {test_file.name} - FAILED (routed to {decision.engine}: {decision.reason})")
+            return False
+        print(f"✅ {test_file.name} - PASSED")
+        return True
+
+    for engine, actual in mismatches.items():
+        print(f"❌ {test_file.name} - FAILED ({engine} engine)")
+        expected_lines = expected[0].splitlines()
+        actual_lines = actual[0].splitlines()
+        for i in range(max(len(expected_lines), len(actual_lines))):
+            want = expected_lines[i] if i < len(expected_lines) else '<missing>'
+            got = actual_lines[i] if i < len(actual_lines) else '<missing>'
+            if want != got:
+                print(f"   line {i + 1}: expected {want!r}, got {got!r}")
+        if actual[1] != expected[1]:
+            print(f"   exit status: expected {expected[1]}, got {actual[1]}")
+    return False
+
+def main():
+    """Run all parity tests"""
+    print("C++ Compiler Parity Tests (g++ vs generated Python)")
+    print("=" * 60)
+
+    if shutil.which('g++') is None:
+        print("g++ not found, skipping parity tests")
+        return 0
+
+    base_dir = Path(__file__).parent
+    test_files = sorted(base_dir.glob("examples/*.cpp")) + sorted(base_dir.glob("parity_tests/*.cpp"))
+
+    passed = 0
+    with tempfile.TemporaryDirectory() as work_dir:
+        for test_file in test_files:
+            if run_test_file(test_file, work_dir):
+                passed += 1
+
+    total = len(test_files)
+    print(f"\n{'='*60}")
+    print(f"Parity Results: {passed}/{total} programs match g++")
+
+    if passed == total:
+        print("🎉 All outputs match!")
+        return 0
+    else:
+        print(f"⚠️  {total - passed} program(s) differ")
+        return 1
+
+if __name__ == "__main__":
+    sys.exit(main())